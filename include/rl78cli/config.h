@@ -15,9 +15,17 @@
 
 #include "rl78misc/common.h"
 
+#include "rl78core/cpu.h"
+
 typedef struct
 {
 	const char_t* binary;
+	rl78core_cpu_engine_e engine;
+	uint64_t farm_workers;  // note: 0 if the farm mode is not requested.
+	const char_t* vectors;
+	const char_t* cache;  // note: NULL if the binary is not to be cached.
+	uint8_t log_level;    // note: minimum level of the logs enabled at runtime.
+	bool_t trace;         // note: true if every instruction is to be traced.
 } rl78cli_config_s;
 
 /**
@@ -0,0 +1,126 @@
+
+/**
+ * @file farm.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78cli__farm_h__
+#define __rl78emu__include__rl78cli__farm_h__
+
+#include "rl78misc/common.h"
+
+#include "rl78core/mem.h"
+#include "rl78core/cpu.h"
+
+#define rl78cli_farm_workers_capacity 64
+#define rl78cli_farm_name_capacity 64
+#define rl78cli_farm_pairs_capacity 32
+#define rl78cli_farm_default_cycles 0x1000000
+
+/**
+ * @brief Byte of the memory at an address, to be patched or expected.
+ */
+typedef struct
+{
+	uint20_t address;
+	uint8_t value;
+} rl78cli_farm_pair_s;
+
+/**
+ * @brief Test vector: memory patches applied to the flashed firmware before the
+ * run, and the memory expected once the firmware halts.
+ */
+typedef struct
+{
+	char_t name[rl78cli_farm_name_capacity];
+	rl78cli_farm_pair_s patches[rl78cli_farm_pairs_capacity];
+	uint8_t patches_count;
+	rl78cli_farm_pair_s expects[rl78cli_farm_pairs_capacity];
+	uint8_t expects_count;
+	uint64_t cycles;
+} rl78cli_farm_vector_s;
+
+/**
+ * @brief Result of running a test vector.
+ */
+typedef struct
+{
+	bool_t passed;
+	rl78core_cpu_stop_e stop;
+	uint64_t cycles;
+	uint20_t pc;
+	uint8_t mismatch;  // note: index of the first mismatched expectation, if the vector halted.
+	uint8_t actual;    // note: value found at the address of the mismatched expectation.
+} rl78cli_farm_result_s;
+
+/**
+ * @brief Farm of test vectors, run against a single firmware image. The image is
+ * shared by the machines of all the workers.
+ */
+typedef struct
+{
+	const rl78core_mem_image_s* firmware;
+	rl78core_cpu_engine_e engine;
+	uint64_t workers;
+	const rl78cli_farm_vector_s* vectors;
+	uint64_t vectors_count;
+} rl78cli_farm_s;
+
+/**
+ * @brief Parse a test vector from a line of a vectors list.
+ * 
+ * @note The line is a whitespace separated list of tokens. The first token is
+ * the name of the vector, and the rest are one of the following:
+ *     patch:<address>=<value>  hex byte to write into the memory before the run.
+ *     expect:<address>=<value> hex byte expected in the memory after the halt.
+ *     cycles:<count>           cycles budget of the run, defaults to 0x1000000.
+ * 
+ * @param line   line to parse
+ * @param vector pointer to store the parsed vector into
+ * 
+ * @return bool_t false if the line is malformed
+ */
+bool_t rl78cli_farm_parse_vector(const char_t* const line, rl78cli_farm_vector_s* const vector);
+
+/**
+ * @brief Load the test vectors from a vectors list file. Empty lines and lines
+ * starting with `#` are skipped.
+ * 
+ * @note It will exit with code -1 if the file cannot be read or a line of it is
+ * malformed.
+ * 
+ * @param path  path of the vectors list file
+ * @param count pointer to store the count of the loaded vectors into
+ * 
+ * @return rl78cli_farm_vector_s* loaded vectors, to be freed by the caller
+ */
+rl78cli_farm_vector_s* rl78cli_farm_load_vectors(const char_t* const path, uint64_t* const count);
+
+/**
+ * @brief Run all the test vectors of a provided farm on a pool of worker
+ * threads. Every worker owns a machine, and a queue of the vectors to run. A
+ * worker with an empty queue steals the vectors from the queues of the others.
+ * 
+ * @param farm    farm to run
+ * @param results results of the vectors, in the order of the vectors
+ */
+void rl78cli_farm_run(const rl78cli_farm_s* const farm, rl78cli_farm_result_s* const results);
+
+/**
+ * @brief Log the results of the test vectors and their summary.
+ * 
+ * @param farm    farm that was run
+ * @param results results of the vectors
+ * @param seconds duration of the run
+ * 
+ * @return uint64_t count of the failed vectors
+ */
+uint64_t rl78cli_farm_report(const rl78cli_farm_s* const farm, const rl78cli_farm_result_s* const results, const double seconds);
+
+#endif
@@ -0,0 +1,74 @@
+
+/**
+ * @file cache.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78core__cache_h__
+#define __rl78emu__include__rl78core__cache_h__
+
+#include "rl78misc/common.h"
+
+#include "rl78core/mem.h"
+#include "rl78core/symbols.h"
+
+/**
+ * @brief On-disk cache of the loaded binaries. Every binary is cached as a flat
+ * file named by the hash of its contents, holding its loaded pages aligned to
+ * the host pages, and its symbols.
+ */
+typedef struct rl78core_cache_s rl78core_cache_s;
+
+/**
+ * @brief Create a cache, backed by a provided directory.
+ * 
+ * @param directory directory of the cached files, expected to exist
+ * 
+ * @return rl78core_cache_s* created cache
+ */
+rl78core_cache_s* rl78core_cache_create(const char_t* const directory);
+
+/**
+ * @brief Destroy the cache created with @ref rl78core_cache_create, and unmap
+ * the cached files loaded through it.
+ * 
+ * @warning The images loaded through the cache must be destroyed first.
+ * 
+ * @param cache cache to destroy
+ */
+void rl78core_cache_destroy(rl78core_cache_s* const cache);
+
+/**
+ * @brief Load a binary file into a provided image, through the cache. If the
+ * cached file of the binary is found, it is mapped into the memory, and its
+ * pages are attached to the image without parsing the binary. Otherwise, the
+ * binary is loaded with @ref rl78core_loader_load_contents, and its cached
+ * file is written.
+ * 
+ * @note A cached file that can not be written is only warned about.
+ * 
+ * @param cache   cache to load through
+ * @param path    path of the binary file
+ * @param image   image to load the binary into
+ * @param symbols index to add the symbols of the binary to, or NULL
+ * 
+ * @return bool_t false if the binary can not be read, or it is invalid
+ */
+bool_t rl78core_cache_load(rl78core_cache_s* const cache, const char_t* const path, rl78core_mem_image_s* const image, rl78core_symbols_s* const symbols);
+
+/**
+ * @brief Get the count of the loads served by the cached files.
+ * 
+ * @param cache cache to get the count of
+ * 
+ * @return uint64_t
+ */
+uint64_t rl78core_cache_hits(const rl78core_cache_s* const cache);
+
+#endif
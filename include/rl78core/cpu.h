@@ -15,6 +15,8 @@
 
 #include "rl78misc/common.h"
 
+#include "rl78core/machine.h"
+
 #define rl78core_gpr08_x 0x00
 #define rl78core_gpr08_a 0x01
 #define rl78core_gpr08_c 0x02
@@ -31,27 +33,342 @@
 #define rl78core_gpr16_hl 0x06
 #define rl78core_gpr16s_count 0x08
 
+typedef enum
+{
+	rl78core_cpu_engine_interp,  // note: decodes and interprets one instruction at a time.
+	rl78core_cpu_engine_block,   // note: translates and runs whole chained basic blocks.
+	rl78core_cpu_engine_jit,     // note: like the block engine, but compiles the hot blocks into host code.
+	rl78core_cpu_engines_count,
+} rl78core_cpu_engine_e;
+
+typedef enum
+{
+	rl78core_cpu_stop_budget,      // note: the cycles or instructions budget ran out.
+	rl78core_cpu_stop_halt,        // note: the cpu got halted.
+	rl78core_cpu_stop_breakpoint,  // note: the pc register reached a breakpoint.
+	rl78core_cpu_stop_event,       // note: the event deadline is due.
+	rl78core_cpu_stops_count,
+} rl78core_cpu_stop_e;
+
+typedef enum
+{
+	rl78core_cpu_standby_none,  // note: the cpu is running, or halted until the initialization.
+	rl78core_cpu_standby_halt,  // note: the halt instruction put the cpu into the halt mode.
+	rl78core_cpu_standby_stop,  // note: the stop instruction put the cpu into the stop mode.
+	rl78core_cpu_standbys_count,
+} rl78core_cpu_standby_e;
+
+typedef struct
+{
+	uint64_t cycles;        // note: max count of clock cycles to run, or 0 for no limit.
+	uint64_t instructions;  // note: max count of instructions to run, or 0 for no limit.
+} rl78core_cpu_budget_s;
+
+/**
+ * @brief Architectural state of the cpu, that is not held in the memory. The
+ * registers banks and the special function registers are held in the memory.
+ */
+typedef struct
+{
+	bool_t halted;
+	rl78core_cpu_standby_e standby;
+	uint20_t pc;
+	uint64_t cycles;
+	rl78core_cpu_engine_e engine;
+} rl78core_cpu_state_s;
+
+#define rl78core_cpu_breakpoints_capacity 16
+#define rl78core_cpu_no_deadline UINT64_MAX
+
 // todo: define all the sfrs here as offsets in their respective addressing ranges and functions to read and write.
 
 /**
- * @brief Initialize the cpu.
+ * @brief Create the cpu of a provided machine.
+ * 
+ * @note The cpu is not initialized.
+ * 
+ * @param machine machine to create the cpu for
+ * 
+ * @return rl78core_cpu_s* created cpu
+ */
+rl78core_cpu_s* rl78core_cpu_create(rl78core_machine_s* const machine);
+
+/**
+ * @brief Destroy the cpu created with @ref rl78core_cpu_create.
+ * 
+ * @param cpu cpu to destroy
+ */
+void rl78core_cpu_destroy(rl78core_cpu_s* const cpu);
+
+/**
+ * @brief Initialize the cpu of a provided machine.
+ * 
+ * @warning The memory of the machine must be initialized before the cpu.
+ * 
+ * @param machine machine to operate on
+ */
+void rl78core_cpu_init_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Read the 20-bit value of the pc register.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return uint20_t value of the pc register
+ */
+uint20_t rl78core_cpu_read_pc_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Write the 20-bit value to the pc register.
+ * 
+ * @param machine machine to operate on
+ * @param value   value to write to the pc register
+ */
+void rl78core_cpu_write_pc_r(rl78core_machine_s* const machine, const uint20_t value);
+
+/**
+ * @brief Read the 8-bit value of provided general purpose register.
+ * 
+ * @param machine machine to operate on
+ * @param gpr08   offset of a 8-bit general purpose register in a bank
+ * 
+ * @return uint8_t value of the provided register
+ */
+uint8_t rl78core_cpu_read_gpr08_r(rl78core_machine_s* const machine, const uint8_t gpr08);
+
+/**
+ * @brief Write the 8-bit value to provided general purpose register.
+ * 
+ * @param machine machine to operate on
+ * @param gpr08   offset of a 8-bit general purpose register in a bank
+ * @param value   value to write to the provided register
+ */
+void rl78core_cpu_write_gpr08_r(rl78core_machine_s* const machine, const uint8_t gpr08, const uint8_t value);
+
+/**
+ * @brief Read the 16-bit value of provided general purpose register.
+ * 
+ * @param machine machine to operate on
+ * @param gpr16   offset of a 16-bit general purpose register in a bank
+ * 
+ * @return uint16_t value of the provided register
+ */
+uint16_t rl78core_cpu_read_gpr16_r(rl78core_machine_s* const machine, const uint8_t gpr16);
+
+/**
+ * @brief Write the 16-bit value of provided general purpose register.
+ * 
+ * @param machine machine to operate on
+ * @param gpr16   offset of a 16-bit general purpose register in a bank
+ * @param value   value to write to the provided register
+ */
+void rl78core_cpu_write_gpr16_r(rl78core_machine_s* const machine, const uint8_t gpr16, const uint16_t value);
+
+/**
+ * @brief Halt the cpu, until the initialization.
+ * 
+ * @param machine machine to operate on
+ */
+void rl78core_cpu_halt_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Check if cpu is halted or not.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return bool_t halted flag
+ */
+bool_t rl78core_cpu_halted_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Get the standby mode the cpu is halted in.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return rl78core_cpu_standby_e standby mode
+ */
+rl78core_cpu_standby_e rl78core_cpu_get_standby_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Wake the cpu up from the halt or the stop mode, so it continues with
+ * the instruction following the one that halted it. The timer array units,
+ * frozen in the stop mode, count again.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return bool_t false if the cpu is not in a standby mode
+ */
+bool_t rl78core_cpu_wake_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Set whether an unmasked interrupt is requested. It is called by the
+ * interrupt controller. Any request releases the standby modes, while the cpu
+ * handles the requests at the instruction boundaries only while any of them
+ * can be acknowledged at the IE and ISP flags of the psw register.
+ * 
+ * @param machine   machine to operate on
+ * @param requested whether an unmasked interrupt is requested
+ */
+void rl78core_cpu_set_interrupt_r(rl78core_machine_s* const machine, const bool_t requested);
+
+/**
+ * @brief Select the engine to process the ticks of @ref rl78core_cpu_execute
+ * with. The interpreter engine is selected on initialization.
+ * 
+ * @param machine machine to operate on
+ * @param engine  engine to select
+ */
+void rl78core_cpu_set_engine_r(rl78core_machine_s* const machine, const rl78core_cpu_engine_e engine);
+
+/**
+ * @brief Get the selected engine.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return rl78core_cpu_engine_e selected engine
+ */
+rl78core_cpu_engine_e rl78core_cpu_get_engine_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Process a single tick with the cpu.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return uint32_t count of clock cycles the tick took, or 0 if the cpu is halted
+ */
+uint32_t rl78core_cpu_tick_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Get the count of clock cycles elapsed since the cpu initialization.
+ * 
+ * @note The cycles follow the rl78 software manual, including the wait cycles
+ * of the data reads from the code flash or its mirror, and of the taken
+ * branches.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return uint64_t count of clock cycles
+ */
+uint64_t rl78core_cpu_cycles_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Process provided count of ticks with the selected engine, or less if
+ * the cpu gets halted before.
+ * 
+ * @note With gcc, the interpreter engine dispatches the instructions with the
+ * computed gotos (threaded dispatch). It can be disabled with the
+ * `rl78core_cpu_threaded_dispatch=0` macro.
+ * 
+ * @note The jit engine falls back to the block engine, if the jit is not
+ * available on the host.
+ * 
+ * @param machine machine to operate on
+ * @param count   count of ticks to process
+ * 
+ * @return uint64_t count of processed ticks
+ */
+uint64_t rl78core_cpu_execute_r(rl78core_machine_s* const machine, const uint64_t count);
+
+/**
+ * @brief Run the cpu with the selected engine until the provided budget runs
+ * out, the cpu gets halted, the pc register reaches a breakpoint or the event
+ * deadline is due. The events of the scheduler due on the way are dispatched.
+ * 
+ * @note In the halt and the stop modes, the idle clock cycles are skipped
+ * straight to the deadline, until an event wakes the cpu up or the cycles
+ * budget runs out. The run stops with the halt reason once there is no
+ * deadline left to wait for.
+ * 
+ * @note The cycles budget may be exceeded by the cycles of the last run
+ * instruction. The breakpoint at the pc register address of the call is not
+ * reported, so that a stopped run can be resumed.
+ * 
+ * @warning While any breakpoint is added, the instructions are run one by one.
+ * 
+ * @param machine machine to operate on
+ * @param budget  budget to run the cpu with
+ * 
+ * @return rl78core_cpu_stop_e reason of the stop
+ */
+rl78core_cpu_stop_e rl78core_cpu_run_r(rl78core_machine_s* const machine, const rl78core_cpu_budget_s budget);
+
+/**
+ * @brief Add a breakpoint at a provided address.
+ * 
+ * @param machine machine to operate on
+ * @param address address of the breakpoint
+ * 
+ * @return bool_t false if there are already too many breakpoints
+ */
+bool_t rl78core_cpu_add_breakpoint_r(rl78core_machine_s* const machine, const uint20_t address);
+
+/**
+ * @brief Remove the breakpoint at a provided address.
+ * 
+ * @param machine machine to operate on
+ * @param address address of the breakpoint
+ * 
+ * @return bool_t false if there is no breakpoint at the address
+ */
+bool_t rl78core_cpu_remove_breakpoint_r(rl78core_machine_s* const machine, const uint20_t address);
+
+/**
+ * @brief Set the count of clock cycles at which the @ref rl78core_cpu_run stops
+ * with the event reason. It is reset to @ref rl78core_cpu_no_deadline on the
+ * initialization.
+ * 
+ * @note The scheduler sets the deadline to its earliest event, and the run
+ * dispatches the due events instead of stopping. A deadline set earlier during
+ * the run, such as by a write of the program to a peripheral, is reached at the
+ * next instruction boundary.
+ * 
+ * @param machine machine to operate on
+ * @param cycles  count of clock cycles of the deadline
+ */
+void rl78core_cpu_set_deadline_r(rl78core_machine_s* const machine, const uint64_t cycles);
+
+/**
+ * @brief Save the state of the cpu. The pending flags are written into the psw
+ * first, so that the memory holds the rest of the state.
+ * 
+ * @param machine machine to operate on
+ * @param state   pointer to store the state into
+ */
+void rl78core_cpu_save_r(rl78core_machine_s* const machine, rl78core_cpu_state_s* const state);
+
+/**
+ * @brief Restore a saved state of the cpu. The breakpoints and the cached code
+ * are kept, while the deadline is cleared, and the pending interrupt is updated.
+ * 
+ * @warning The memory must be restored first, as the active registers bank and
+ * the pending interrupt are selected by the restored psw and registers.
+ * 
+ * @param machine machine to operate on
+ * @param state   state to restore
+ */
+void rl78core_cpu_restore_r(rl78core_machine_s* const machine, const rl78core_cpu_state_s* const state);
+
+/**
+ * @brief Same as @ref rl78core_cpu_init_r, for the default machine.
  */
 void rl78core_cpu_init(void);
 
 /**
- * @brief Read the 10-bit value of the pc register.
+ * @brief Same as @ref rl78core_cpu_read_pc_r, for the default machine.
  * 
- * @param value value to write to the pc register
+ * @return uint20_t value of the pc register
  */
 uint20_t rl78core_cpu_read_pc(void);
 
 /**
- * @brief Read the 10-bit value of the pc register.
+ * @brief Same as @ref rl78core_cpu_write_pc_r, for the default machine.
+ * 
+ * @param value value to write to the pc register
  */
 void rl78core_cpu_write_pc(const uint20_t value);
 
 /**
- * @brief Read the 8-bit value of provided general purpose register.
+ * @brief Same as @ref rl78core_cpu_read_gpr08_r, for the default machine.
  * 
  * @param gpr08 offset of a 8-bit general purpose register in a bank
  * 
@@ -60,7 +377,7 @@ void rl78core_cpu_write_pc(const uint20_t value);
 uint8_t rl78core_cpu_read_gpr08(const uint8_t gpr08);
 
 /**
- * @brief Write the 8-bit value to provided general purpose register.
+ * @brief Same as @ref rl78core_cpu_write_gpr08_r, for the default machine.
  * 
  * @param gpr08 offset of a 8-bit general purpose register in a bank
  * @param value value to write to the provided register
@@ -68,7 +385,7 @@ uint8_t rl78core_cpu_read_gpr08(const uint8_t gpr08);
 void rl78core_cpu_write_gpr08(const uint8_t gpr08, const uint8_t value);
 
 /**
- * @brief Read the 16-bit value of provided general purpose register.
+ * @brief Same as @ref rl78core_cpu_read_gpr16_r, for the default machine.
  * 
  * @param gpr16 offset of a 16-bit general purpose register in a bank
  * 
@@ -77,7 +394,7 @@ void rl78core_cpu_write_gpr08(const uint8_t gpr08, const uint8_t value);
 uint16_t rl78core_cpu_read_gpr16(const uint8_t gpr16);
 
 /**
- * @brief Write the 16-bit value of provided general purpose register.
+ * @brief Same as @ref rl78core_cpu_write_gpr16_r, for the default machine.
  * 
  * @param gpr16 offset of a 16-bit general purpose register in a bank
  * @param value value to write to the provided register
@@ -85,20 +402,114 @@ uint16_t rl78core_cpu_read_gpr16(const uint8_t gpr16);
 void rl78core_cpu_write_gpr16(const uint8_t gpr16, const uint16_t value);
 
 /**
- * @brief Halt the cpu.
+ * @brief Same as @ref rl78core_cpu_halt_r, for the default machine.
  */
 void rl78core_cpu_halt(void);
 
 /**
- * @brief Check if cpu is halted or not.
+ * @brief Same as @ref rl78core_cpu_halted_r, for the default machine.
  * 
  * @return bool_t halted flag
  */
 bool_t rl78core_cpu_halted(void);
 
 /**
- * @brief Process a single tick with the cpu.
+ * @brief Same as @ref rl78core_cpu_get_standby_r, for the default machine.
+ * 
+ * @return rl78core_cpu_standby_e standby mode
+ */
+rl78core_cpu_standby_e rl78core_cpu_get_standby(void);
+
+/**
+ * @brief Same as @ref rl78core_cpu_wake_r, for the default machine.
+ * 
+ * @return bool_t false if the cpu is not in a standby mode
+ */
+bool_t rl78core_cpu_wake(void);
+
+/**
+ * @brief Same as @ref rl78core_cpu_set_engine_r, for the default machine.
+ * 
+ * @param engine engine to select
+ */
+void rl78core_cpu_set_engine(const rl78core_cpu_engine_e engine);
+
+/**
+ * @brief Same as @ref rl78core_cpu_get_engine_r, for the default machine.
+ * 
+ * @return rl78core_cpu_engine_e selected engine
+ */
+rl78core_cpu_engine_e rl78core_cpu_get_engine(void);
+
+/**
+ * @brief Same as @ref rl78core_cpu_tick_r, for the default machine.
+ * 
+ * @return uint32_t count of clock cycles the tick took, or 0 if the cpu is halted
+ */
+uint32_t rl78core_cpu_tick(void);
+
+/**
+ * @brief Same as @ref rl78core_cpu_cycles_r, for the default machine.
+ * 
+ * @return uint64_t count of clock cycles
+ */
+uint64_t rl78core_cpu_cycles(void);
+
+/**
+ * @brief Same as @ref rl78core_cpu_execute_r, for the default machine.
+ * 
+ * @param count count of ticks to process
+ * 
+ * @return uint64_t count of processed ticks
+ */
+uint64_t rl78core_cpu_execute(const uint64_t count);
+
+/**
+ * @brief Same as @ref rl78core_cpu_run_r, for the default machine.
+ * 
+ * @param budget budget to run the cpu with
+ * 
+ * @return rl78core_cpu_stop_e reason of the stop
+ */
+rl78core_cpu_stop_e rl78core_cpu_run(const rl78core_cpu_budget_s budget);
+
+/**
+ * @brief Same as @ref rl78core_cpu_add_breakpoint_r, for the default machine.
+ * 
+ * @param address address of the breakpoint
+ * 
+ * @return bool_t false if there are already too many breakpoints
+ */
+bool_t rl78core_cpu_add_breakpoint(const uint20_t address);
+
+/**
+ * @brief Same as @ref rl78core_cpu_remove_breakpoint_r, for the default machine.
+ * 
+ * @param address address of the breakpoint
+ * 
+ * @return bool_t false if there is no breakpoint at the address
+ */
+bool_t rl78core_cpu_remove_breakpoint(const uint20_t address);
+
+/**
+ * @brief Same as @ref rl78core_cpu_set_deadline_r, for the default machine.
+ * 
+ * @param cycles count of clock cycles of the deadline
+ */
+void rl78core_cpu_set_deadline(const uint64_t cycles);
+
+/**
+ * @brief Same as @ref rl78core_cpu_save_r, for the default machine.
+ * 
+ * @param state pointer to store the state into
+ */
+void rl78core_cpu_save(rl78core_cpu_state_s* const state);
+
+/**
+ * @brief Same as @ref rl78core_cpu_restore_r, for the default machine.
+ * 
+ * @param state state to restore
  */
-void rl78core_cpu_tick(void);
+void rl78core_cpu_restore(const rl78core_cpu_state_s* const state);
 
 #endif
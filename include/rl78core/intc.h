@@ -0,0 +1,136 @@
+
+/**
+ * @file intc.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78core__intc_h__
+#define __rl78emu__include__rl78core__intc_h__
+
+#include "rl78misc/common.h"
+
+#include "rl78core/machine.h"
+
+/**
+ * note: the maskable interrupt sources are numbered in the order of their
+ * vectors, from the source 0 at the vector 0x00004 up to the source 60 at the
+ * vector 0x0007C. The lower numbered source has the higher default priority.
+ */
+#define rl78core_intc_sources_count 61
+#define rl78core_intc_levels_count 4
+#define rl78core_intc_no_source UINT8_MAX
+#define rl78core_intc_vectors_address 0x00004
+
+/**
+ * note: the interrupt request (IF), mask (MK) and priority specification (PR0,
+ * PR1) flag registers are held in the memory, in two blocks of the same layout.
+ * The block at 0xFFFE0 holds the flags of the sources [0; 32), and the one at
+ * 0xFFFD0 of the sources [32; 64). Every block holds the 32-bit IF, MK, PR0 and
+ * PR1 registers, in this order, each made of 4 byte-sized registers.
+ */
+#define rl78core_intc_registers_address 0xFFFD0
+#define rl78core_intc_registers_length 0x20
+
+/**
+ * @brief Initialize the interrupt controller of a provided machine. The requests
+ * are cleared, all the sources are masked, and their priority is set to the
+ * lowest level 3.
+ * 
+ * @warning The memory and the cpu of the machine must be initialized before the
+ * interrupt controller.
+ * 
+ * @param machine machine to operate on
+ */
+void rl78core_intc_init_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Inform the cpu whether any unmasked interrupt is requested. The writes
+ * of the cpu to the flag registers update it on their own, while the other
+ * writes, such as the ones of a debugger, must be followed by an update.
+ * 
+ * @param machine machine to operate on
+ */
+void rl78core_intc_update_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Request an interrupt, by setting the request flag of its source.
+ * 
+ * @param machine machine to operate on
+ * @param source  source of the interrupt
+ */
+void rl78core_intc_request_r(rl78core_machine_s* const machine, const uint8_t source);
+
+/**
+ * @brief Check if an interrupt is requested, by its request flag.
+ * 
+ * @param machine machine to operate on
+ * @param source  source of the interrupt
+ * 
+ * @return bool_t
+ */
+bool_t rl78core_intc_requested_r(rl78core_machine_s* const machine, const uint8_t source);
+
+/**
+ * @brief Select the requested and unmasked interrupt to acknowledge: the one of
+ * the highest priority level, as long as it is not lower than the provided one,
+ * and of those, the one with the highest default priority.
+ * 
+ * @param machine machine to operate on
+ * @param level   lowest priority level to select, as held in the isp flags
+ * 
+ * @return uint8_t selected source, or @ref rl78core_intc_no_source
+ */
+uint8_t rl78core_intc_select_r(rl78core_machine_s* const machine, const uint8_t level);
+
+/**
+ * @brief Get the priority level of an interrupt source, from 0 for the highest
+ * to 3 for the lowest.
+ * 
+ * @param machine machine to operate on
+ * @param source  source of the interrupt
+ * 
+ * @return uint8_t priority level
+ */
+uint8_t rl78core_intc_priority_r(rl78core_machine_s* const machine, const uint8_t source);
+
+/**
+ * @brief Acknowledge an interrupt, by clearing the request flag of its source.
+ * 
+ * @param machine machine to operate on
+ * @param source  source of the interrupt
+ */
+void rl78core_intc_acknowledge_r(rl78core_machine_s* const machine, const uint8_t source);
+
+/**
+ * @brief Same as @ref rl78core_intc_init_r, for the default machine.
+ */
+void rl78core_intc_init(void);
+
+/**
+ * @brief Same as @ref rl78core_intc_update_r, for the default machine.
+ */
+void rl78core_intc_update(void);
+
+/**
+ * @brief Same as @ref rl78core_intc_request_r, for the default machine.
+ * 
+ * @param source source of the interrupt
+ */
+void rl78core_intc_request(const uint8_t source);
+
+/**
+ * @brief Same as @ref rl78core_intc_requested_r, for the default machine.
+ * 
+ * @param source source of the interrupt
+ * 
+ * @return bool_t
+ */
+bool_t rl78core_intc_requested(const uint8_t source);
+
+#endif
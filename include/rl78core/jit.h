@@ -0,0 +1,198 @@
+
+/**
+ * @file jit.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78core__jit_h__
+#define __rl78emu__include__rl78core__jit_h__
+
+#include "rl78misc/common.h"
+
+#ifndef rl78core_jit_enabled
+#	if defined(__x86_64__) && defined(__linux__)
+#		define rl78core_jit_enabled 1
+#	else
+#		define rl78core_jit_enabled 0
+#	endif
+#endif
+
+typedef enum
+{
+	rl78core_jit_alu_add,
+	rl78core_jit_alu_sub,
+	rl78core_jit_alu_and,
+	rl78core_jit_alu_or,
+	rl78core_jit_alu_xor,
+	rl78core_jit_alus_count,
+} rl78core_jit_alu_e;
+
+typedef struct rl78core_jit_s rl78core_jit_s;
+
+/**
+ * @brief Compiled code of a block. It returns the count of the instructions it
+ * has processed.
+ */
+typedef uint32_t(*rl78core_jit_code_t)(void);
+
+/**
+ * @brief Create a jit and map its arena. The arena is never writable and
+ * executable at the same time: it is writable while a code is compiled, and the
+ * pages of the compiled codes are made executable at the end.
+ * 
+ * @note The jit stays unavailable if it is not enabled for the host, or if the
+ * arena can not be mapped.
+ * 
+ * @return rl78core_jit_s* created jit
+ */
+rl78core_jit_s* rl78core_jit_create(void);
+
+/**
+ * @brief Destroy the jit created with @ref rl78core_jit_create, and unmap its
+ * arena.
+ * 
+ * @param jit jit to destroy
+ */
+void rl78core_jit_destroy(rl78core_jit_s* const jit);
+
+/**
+ * @brief Check if a provided jit is available.
+ * 
+ * @param jit jit to check
+ * 
+ * @return bool_t
+ */
+bool_t rl78core_jit_available(const rl78core_jit_s* const jit);
+
+/**
+ * @brief Discard all the code compiled with a provided jit.
+ * 
+ * @warning All the previously returned codes become invalid.
+ * 
+ * @param jit jit to reset
+ */
+void rl78core_jit_reset(rl78core_jit_s* const jit);
+
+/**
+ * @brief Begin compiling a new code. The emitted code keeps a pointer to the
+ * active 8-bit general purpose registers bank in a host register.
+ * 
+ * @param jit      jit to compile with
+ * @param gpr_bank address of the pointer to the active registers bank
+ */
+void rl78core_jit_begin(rl78core_jit_s* const jit, uint8_t* const* const gpr_bank);
+
+/**
+ * @brief Emit a store of 8-bit value into a general purpose register.
+ * 
+ * @param jit   jit to compile with
+ * @param gpr08 offset of a 8-bit general purpose register in a bank
+ * @param value value to store
+ */
+void rl78core_jit_emit_gpr08_imm(rl78core_jit_s* const jit, const uint8_t gpr08, const uint8_t value);
+
+/**
+ * @brief Emit a store of 16-bit value into a general purpose register.
+ * 
+ * @param jit   jit to compile with
+ * @param gpr16 offset of a 16-bit general purpose register in a bank
+ * @param value value to store
+ */
+void rl78core_jit_emit_gpr16_imm(rl78core_jit_s* const jit, const uint8_t gpr16, const uint16_t value);
+
+/**
+ * @brief Emit a move between two 8-bit general purpose registers.
+ * 
+ * @param jit         jit to compile with
+ * @param destination offset of the destination register in a bank
+ * @param source      offset of the source register in a bank
+ */
+void rl78core_jit_emit_gpr08_gpr08(rl78core_jit_s* const jit, const uint8_t destination, const uint8_t source);
+
+/**
+ * @brief Emit an 8-bit alu operation of a general purpose register with an
+ * immediate value. The operation gets recorded into four consecutive bytes of a
+ * host memory: a provided operation id, the register value, the immediate value
+ * and the result.
+ * 
+ * @param jit    jit to compile with
+ * @param alu    alu operation to emit
+ * @param gpr08  offset of a 8-bit general purpose register in a bank
+ * @param value  immediate value of the operation
+ * @param store  whether to store the result into the register
+ * @param record address of the record in the host memory
+ * @param id     operation id to record
+ */
+void rl78core_jit_emit_gpr08_alu(rl78core_jit_s* const jit, const rl78core_jit_alu_e alu, const uint8_t gpr08, const uint8_t value, const bool_t store, uint8_t* const record, const uint8_t id);
+
+/**
+ * @brief Emit a store of 32-bit value into a host memory.
+ * 
+ * @param jit     jit to compile with
+ * @param address address of the host memory
+ * @param value   value to store
+ */
+void rl78core_jit_emit_store_u32(rl78core_jit_s* const jit, uint32_t* const address, const uint32_t value);
+
+/**
+ * @brief Emit an addition of 32-bit value to 64-bit value in a host memory.
+ * 
+ * @param jit     jit to compile with
+ * @param address address of the host memory
+ * @param value   value to add
+ */
+void rl78core_jit_emit_add_u64(rl78core_jit_s* const jit, uint64_t* const address, const uint32_t value);
+
+/**
+ * @brief Emit a call of a host function with two pointer arguments. The pointer
+ * to the active registers bank is reloaded after the call.
+ * 
+ * @param jit      jit to compile with
+ * @param function address of the host function
+ * @param first    first argument to call the function with
+ * @param second   second argument to call the function with
+ */
+void rl78core_jit_emit_call(rl78core_jit_s* const jit, const uint64_t function, const void* const first, const void* const second);
+
+/**
+ * @brief Emit a call of a host function with one pointer argument, if a value
+ * of a provided host byte is within a range. The pointer to the active
+ * registers bank is reloaded after the call.
+ * 
+ * @param jit      jit to compile with
+ * @param byte     address of the host byte
+ * @param low      lowest value of the range
+ * @param high     highest value of the range
+ * @param function address of the host function
+ * @param argument argument to call the function with
+ */
+void rl78core_jit_emit_call_if(rl78core_jit_s* const jit, const uint8_t* const byte, const uint8_t low, const uint8_t high, const uint64_t function, const void* const argument);
+
+/**
+ * @brief Emit a return from the code if a provided host flag is set.
+ * 
+ * @param jit   jit to compile with
+ * @param flag  address of the host flag
+ * @param count count of processed instructions to return
+ */
+void rl78core_jit_emit_return_if(rl78core_jit_s* const jit, const bool_t* const flag, const uint32_t count);
+
+/**
+ * @brief Emit a return from the code, and finish compiling it. The pages of the
+ * code are made executable, and stay read-only until the next compile.
+ * 
+ * @param jit   jit to compile with
+ * @param count count of processed instructions to return
+ * 
+ * @return rl78core_jit_code_t compiled code, or NULL if the arena is full, or
+ * can not be protected
+ */
+rl78core_jit_code_t rl78core_jit_end(rl78core_jit_s* const jit, const uint32_t count);
+
+#endif
@@ -0,0 +1,86 @@
+
+/**
+ * @file loader.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78core__loader_h__
+#define __rl78emu__include__rl78core__loader_h__
+
+#include "rl78misc/common.h"
+
+#include "rl78core/mem.h"
+#include "rl78core/symbols.h"
+
+/**
+ * @brief Load a binary file into a provided image. The file is mapped into the
+ * memory with @ref rl78misc_file_map. The elf files are told apart by their
+ * magic, and the rest are parsed as text.
+ * 
+ * @note The errors are logged with the path, and the line of the record.
+ * 
+ * @param path    path of the binary file, in intel hex, s-record or elf format
+ * @param image   image to load the binary into
+ * @param symbols index to add the symbols of an elf file to, or NULL
+ * 
+ * @return bool_t false if the file can not be read, or it is invalid
+ */
+bool_t rl78core_loader_load(const char_t* const path, rl78core_mem_image_s* const image, rl78core_symbols_s* const symbols);
+
+/**
+ * @brief Load the contents of a binary into a provided image, as an elf file if
+ * they start with its magic, and as text otherwise.
+ * 
+ * @param name     name of the binary, for the logged errors
+ * @param contents contents of the binary
+ * @param length   length of the contents
+ * @param image    image to load the binary into
+ * @param symbols  index to add the symbols of an elf file to, or NULL
+ * 
+ * @return bool_t false if the binary is invalid
+ */
+bool_t rl78core_loader_load_contents(const char_t* const name, const uint8_t* const contents, const uint64_t length, rl78core_mem_image_s* const image, rl78core_symbols_s* const symbols);
+
+/**
+ * @brief Load the text of a binary into a provided image. The format is chosen
+ * by the first record: `:` starts an intel hex record, and `S` starts a
+ * s-record. The records are streamed, and every data record is copied into the
+ * image once its checksum is validated.
+ * 
+ * @note The parsing stops at the end record. The empty lines are skipped. The
+ * records preceding an invalid one stay loaded into the image.
+ * 
+ * @param name   name of the binary, for the logged errors
+ * @param text   text of the binary
+ * @param length length of the text
+ * @param image  image to load the records into
+ * 
+ * @return bool_t false if a record of the binary is invalid
+ */
+bool_t rl78core_loader_load_text(const char_t* const name, const char_t* const text, const uint64_t length, rl78core_mem_image_s* const image);
+
+/**
+ * @brief Load a 32-bit little-endian rl78 elf file into a provided image. The
+ * file contents of the loadable segments are copied to their physical
+ * addresses, and the function, object and untyped symbols of the symbol tables
+ * are added to the index, which is then sorted.
+ * 
+ * @note The headers and the symbol tables are read in place.
+ * 
+ * @param name    name of the binary, for the logged errors
+ * @param data    contents of the file
+ * @param length  length of the contents
+ * @param image   image to load the segments into
+ * @param symbols index to add the symbols to, or NULL
+ * 
+ * @return bool_t false if the file is invalid, or has no loadable segments
+ */
+bool_t rl78core_loader_load_elf(const char_t* const name, const uint8_t* const data, const uint64_t length, rl78core_mem_image_s* const image, rl78core_symbols_s* const symbols);
+
+#endif
@@ -0,0 +1,71 @@
+
+/**
+ * @file machine.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78core__machine_h__
+#define __rl78emu__include__rl78core__machine_h__
+
+#include "rl78misc/common.h"
+
+typedef struct rl78core_mem_s rl78core_mem_s;
+typedef struct rl78core_cpu_s rl78core_cpu_s;
+typedef struct rl78core_sched_s rl78core_sched_s;
+typedef struct rl78core_tau_s rl78core_tau_s;
+
+/**
+ * @brief Emulated machine. Every machine owns its memory, cpu state, events
+ * scheduler and timer array units, so any count of machines can be emulated
+ * independently within a process.
+ * 
+ * @note The `_r` functions of the mem, cpu, sched, intc and tau modules operate
+ * on a provided machine, and the other functions on the default machine.
+ */
+typedef struct rl78core_machine_s
+{
+	rl78core_mem_s* mem;
+	rl78core_cpu_s* cpu;
+	rl78core_sched_s* sched;
+	rl78core_tau_s* tau;
+} rl78core_machine_s;
+
+/**
+ * @brief Create and initialize a machine.
+ * 
+ * @return rl78core_machine_s* created machine
+ */
+rl78core_machine_s* rl78core_machine_create(void);
+
+/**
+ * @brief Destroy the machine created with @ref rl78core_machine_create.
+ * 
+ * @param machine machine to destroy
+ */
+void rl78core_machine_destroy(rl78core_machine_s* const machine);
+
+/**
+ * @brief Initialize the memory, the cpu, the scheduler, the interrupt
+ * controller and the timer array units of a provided machine.
+ * 
+ * @param machine machine to initialize
+ */
+void rl78core_machine_init(rl78core_machine_s* const machine);
+
+/**
+ * @brief Get the default machine, which is created on the first call.
+ * 
+ * @warning The default machine is not thread-safe, and is meant for the single
+ * threaded users of the functions without the machine parameter.
+ * 
+ * @return rl78core_machine_s* default machine
+ */
+rl78core_machine_s* rl78core_machine_default(void);
+
+#endif
@@ -14,54 +14,579 @@
 #define __rl78emu__include__rl78core__mem_h__
 
 #include "rl78misc/common.h"
+#include "rl78misc/debug.h"
+
+#include "rl78core/machine.h"
+
+#define rl78core_mem_address_space_size 0x100000
+#define rl78core_mem_page_shift 8
+#define rl78core_mem_page_size (1 << rl78core_mem_page_shift)
+#define rl78core_mem_pages_count (rl78core_mem_address_space_size >> rl78core_mem_page_shift)
+
+#if defined(__GNUC__)
+#	define rl78core_mem_likely(_expression) __builtin_expect(!!(_expression), 1)
+#else
+#	define rl78core_mem_likely(_expression) (_expression)
+#endif
+#define rl78core_mem_ios_capacity 64
 
 /**
- * @brief Initialize memory.
+ * @brief Read-only memory image, such as a firmware, shared by all the machines
+ * it is mapped into.
  */
-void rl78core_mem_init(void);
+typedef struct rl78core_mem_image_s rl78core_mem_image_s;
 
 /**
- * @brief Read 8-bit value from a provided address in the memory.
+ * @brief Page table of a memory. Every page maps to its host memory, or to NULL
+ * if its accesses must take the slow path. Every write to the memory marks its
+ * page as dirty.
  * 
+ * @note It is the first member of every memory, so that the inline accessors
+ * can reach it without a function call.
+ */
+typedef struct
+{
+	const uint8_t* read[rl78core_mem_pages_count];
+	uint8_t* write[rl78core_mem_pages_count];
+	uint8_t dirty[rl78core_mem_pages_count];  // note: a byte per page, so that marking a page costs a single store.
+} rl78core_mem_page_table_s;
+
+/**
+ * @brief Hook called when a watched code page gets written to.
+ * 
+ * @param machine machine whose memory was written to
+ * @param page    index of the written page
+ */
+typedef void(*rl78core_mem_code_write_hook_t)(rl78core_machine_s* const machine, const uint20_t page);
+
+/**
+ * @brief Handler of the reads of a mapped i/o address range.
+ * 
+ * @param machine machine whose memory is read
+ * @param context context the handler was mapped with
  * @param address address to read at
  * 
  * @return uint8_t read 8-bit value
  */
-uint8_t rl78core_mem_read_u08(const uint20_t address);
+typedef uint8_t(*rl78core_mem_io_read_t)(rl78core_machine_s* const machine, void* const context, const uint20_t address);
 
 /**
- * @brief Write 8-bit value into a provided address in the memory.
+ * @brief Handler of the writes of a mapped i/o address range.
  * 
+ * @param machine machine whose memory is written
+ * @param context context the handler was mapped with
  * @param address address to write value at
  * @param value   value to write
  */
-void rl78core_mem_write_u08(const uint20_t address, const uint8_t value);
+typedef void(*rl78core_mem_io_write_t)(rl78core_machine_s* const machine, void* const context, const uint20_t address, const uint8_t value);
+
+/**
+ * @brief Create the memory of a provided machine.
+ * 
+ * @note The memory is not initialized.
+ * 
+ * @param machine machine to create the memory for
+ * 
+ * @return rl78core_mem_s* created memory
+ */
+rl78core_mem_s* rl78core_mem_create(rl78core_machine_s* const machine);
+
+/**
+ * @brief Destroy the memory created with @ref rl78core_mem_create.
+ * 
+ * @param mem memory to destroy
+ */
+void rl78core_mem_destroy(rl78core_mem_s* const mem);
+
+/**
+ * @brief Initialize memory of a provided machine. Only the committed pages that
+ * were written to since the previous initialization, or since the mapped image
+ * was replaced, are restored to their initial contents, and reported to the
+ * code write hook if they are watched. The dirty pages are reset.
+ * 
+ * @note The mapped image and i/o handlers are kept.
+ * 
+ * @param machine machine to initialize the memory of
+ */
+void rl78core_mem_init_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Read 8-bit value from a provided address in the memory of a provided
+ * machine.
+ * 
+ * @note It is inlined, so that a read of the ordinary memory compiles down to a
+ * page table lookup and a load.
+ * 
+ * @param machine machine to read the memory of
+ * @param address address to read at
+ * 
+ * @return uint8_t read 8-bit value
+ */
+static inline uint8_t rl78core_mem_read_u08_r(rl78core_machine_s* const machine, const uint20_t address);
+
+/**
+ * @brief Write 8-bit value into a provided address in the memory of a provided
+ * machine.
+ * 
+ * @param machine machine to write the memory of
+ * @param address address to write value at
+ * @param value   value to write
+ */
+static inline void rl78core_mem_write_u08_r(rl78core_machine_s* const machine, const uint20_t address, const uint8_t value);
 
 /**
- * @brief Read 16-bit value from a provided address in the memory.
+ * @brief Read 16-bit value from a provided address in the memory of a provided
+ * machine.
  * 
  * @note 16-bit value cannot be read at the end of a memory range. For example,
  * reading a 16-bit value at address 0x09 in a memory of size 10, would raise a
  * runtime error, since 16-bit value cannot be read from a memory range of less
  * than 2 bytes length.
  * 
+ * @param machine machine to read the memory of
  * @param address address to read at
  * 
  * @return uint16_t read 16-bit value
  */
-uint16_t rl78core_mem_read_u16(const uint20_t address);
+static inline uint16_t rl78core_mem_read_u16_r(rl78core_machine_s* const machine, const uint20_t address);
 
 /**
- * @brief Write 16-bit value from a provided address in the memory.
+ * @brief Write 16-bit value from a provided address in the memory of a provided
+ * machine.
  * 
  * @note 16-bit value cannot be written at the end of a memory range. For example,
  * reading a 16-bit value at address 0x09 in a memory of size 10, would raise a
  * runtime error, since 16-bit value cannot be read from a memory range of less
  * than 2 bytes length.
  * 
+ * @param machine machine to write the memory of
+ * @param address address to write value at
+ * @param value   value to write
+ */
+static inline void rl78core_mem_write_u16_r(rl78core_machine_s* const machine, const uint20_t address, const uint16_t value);
+
+/**
+ * @brief Read 8-bit value from a provided address in the memory of a provided
+ * machine, on the slow path: through the i/o handlers, or from a page that is
+ * not committed yet.
+ * 
+ * @param machine machine to read the memory of
+ * @param address address to read at
+ * 
+ * @return uint8_t read 8-bit value
+ */
+uint8_t rl78core_mem_read_slow_r(rl78core_machine_s* const machine, const uint20_t address);
+
+/**
+ * @brief Write 8-bit value into a provided address in the memory of a provided
+ * machine, on the slow path: through the i/o handlers, into a watched code page,
+ * or into a page that is not committed yet.
+ * 
+ * @param machine machine to write the memory of
+ * @param address address to write value at
+ * @param value   value to write
+ */
+void rl78core_mem_write_slow_r(rl78core_machine_s* const machine, const uint20_t address, const uint8_t value);
+
+/**
+ * @brief Load a provided block of data into the memory of a provided machine,
+ * such as a firmware image. The i/o handlers are bypassed.
+ * 
+ * @param machine machine to load the memory of
+ * @param address address to load the data at
+ * @param data    data to load
+ * @param length  length of the data in bytes
+ */
+void rl78core_mem_load_r(rl78core_machine_s* const machine, const uint20_t address, const uint8_t* const data, const uint20_t length);
+
+/**
+ * @brief Create an empty memory image.
+ * 
+ * @return rl78core_mem_image_s* created image
+ */
+rl78core_mem_image_s* rl78core_mem_image_create(void);
+
+/**
+ * @brief Destroy the image created with @ref rl78core_mem_image_create.
+ * 
+ * @warning The image must not be mapped into any machine anymore.
+ * 
+ * @param image image to destroy
+ */
+void rl78core_mem_image_destroy(rl78core_mem_image_s* const image);
+
+/**
+ * @brief Load a provided block of data into an image.
+ * 
+ * @warning The image must not be loaded into, once it is mapped into a machine.
+ * 
+ * @param image   image to load
+ * @param address address to load the data at
+ * @param data    data to load
+ * @param length  length of the data in bytes
+ */
+void rl78core_mem_image_load(rl78core_mem_image_s* const image, const uint20_t address, const uint8_t* const data, const uint20_t length);
+
+/**
+ * @brief Attach a provided block of host memory to an image, in place of its
+ * copy. The pages of the block are borrowed by the image, and get copied only
+ * if they are loaded into.
+ * 
+ * @warning The block must outlive the image, and stay unmodified while it is
+ * attached. The image must not be attached to, once it is mapped into a
+ * machine.
+ * 
+ * @param image   image to attach to
+ * @param address address to attach the block at, aligned to the page size
+ * @param data    block to attach
+ * @param length  length of the block in bytes, a multiple of the page size
+ */
+void rl78core_mem_image_attach(rl78core_mem_image_s* const image, const uint20_t address, const uint8_t* const data, const uint20_t length);
+
+/**
+ * @brief Get the contents of a page of an image.
+ * 
+ * @param image image to get the page of
+ * @param page  index of the page
+ * 
+ * @return const uint8_t* contents of the page, or NULL if it is not loaded
+ */
+const uint8_t* rl78core_mem_image_page(const rl78core_mem_image_s* const image, const uint20_t page);
+
+/**
+ * @brief Get the footprint of an image.
+ * 
+ * @param image image to get the footprint of
+ * 
+ * @return uint64_t size of the loaded pages in bytes
+ */
+uint64_t rl78core_mem_image_footprint(const rl78core_mem_image_s* const image);
+
+/**
+ * @brief Map an image into the memory of a provided machine, replacing the
+ * previously mapped one. The pages loaded into the image are then shared with
+ * the image, until the first write to them commits their private copy. The
+ * initialization of the memory restores the contents of the image.
+ * 
+ * @note An image can be mapped into any count of machines, and read by them
+ * from any threads at once. Mapping the already mapped image does nothing.
+ * 
+ * @param machine machine to map the image into
+ * @param image   image to map, or NULL to unmap the mapped one
+ */
+void rl78core_mem_map_image_r(rl78core_machine_s* const machine, const rl78core_mem_image_s* const image);
+
+/**
+ * @brief Capture the current contents of the memory of a provided machine into
+ * an image. The committed pages, and the pages of the mapped image, are loaded
+ * into the image. The i/o handlers are bypassed.
+ * 
+ * @param machine machine to capture the memory of
+ * @param image   image to capture into
+ */
+void rl78core_mem_capture_r(rl78core_machine_s* const machine, rl78core_mem_image_s* const image);
+
+/**
+ * @brief Check whether the page at a provided address of a provided machine was
+ * written to since the last reset of the dirty pages.
+ * 
+ * @note The referenced pages are always dirty, since the writes through the
+ * pointers from @ref rl78core_mem_reference_r can not be tracked.
+ * 
+ * @param machine machine to check the memory of
+ * @param address address within the page to check
+ * 
+ * @return bool_t
+ */
+bool_t rl78core_mem_dirty_r(rl78core_machine_s* const machine, const uint20_t address);
+
+/**
+ * @brief Reset the dirty pages of a provided machine, such as after a dump of
+ * them. The pages written to before the reset are still restored by the next
+ * initialization of the memory.
+ * 
+ * @param machine machine to reset the dirty pages of
+ */
+void rl78core_mem_reset_dirty_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Get the footprint of the memory of a provided machine. The memory of a
+ * page is only committed on the first write to it.
+ * 
+ * @param machine machine to get the footprint of
+ * 
+ * @return uint64_t size of the committed memory in bytes
+ */
+uint64_t rl78core_mem_footprint_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Reference the memory of a provided machine at a provided address.
+ * 
+ * @note The returned pointer aliases the memory, so the writes through it are
+ * visible to the reads through the other functions, and vice versa. The memory
+ * of the referenced page gets committed, and is not shared with an image.
+ * 
+ * @warning The referenced region must not cross a page boundary.
+ * 
+ * @param machine machine to reference the memory of
+ * @param address address to reference memory at
+ * @param size    size of the referenced memory region in bytes
+ * 
+ * @return uint8_t* pointer to the referenced memory
+ */
+uint8_t* rl78core_mem_reference_r(rl78core_machine_s* const machine, const uint20_t address, const uint20_t size);
+
+/**
+ * @brief Set the hook to be called on writes to the watched code pages of a
+ * provided machine.
+ * 
+ * @param machine machine to set the hook of
+ * @param hook    hook to call, or NULL to disable it
+ */
+void rl78core_mem_set_code_write_hook_r(rl78core_machine_s* const machine, const rl78core_mem_code_write_hook_t hook);
+
+/**
+ * @brief Watch the page at a provided address of a provided machine for writes.
+ * The first write to the page calls the code write hook once, and stops
+ * watching the page.
+ * 
+ * @warning Writes through the pointers from @ref rl78core_mem_reference_r are
+ * not watched.
+ * 
+ * @param machine machine to watch the memory of
+ * @param address address within the page to watch
+ */
+void rl78core_mem_watch_code_page_r(rl78core_machine_s* const machine, const uint20_t address);
+
+/**
+ * @brief Map i/o handlers, such as the registers of a peripheral, to an address
+ * range of the memory of a provided machine. The reads and writes of the range
+ * get dispatched to the handlers, instead of the memory.
+ * 
+ * @note The range is meant to be in the sfr or the extended sfr areas. The pages
+ * of the range take the slow path, while the other pages are accessed directly.
+ * A NULL handler leaves its kind of access to the memory. The mapped handlers
+ * are kept on initialization of the memory.
+ * 
+ * @warning The accesses through the pointers from @ref rl78core_mem_reference_r
+ * bypass the handlers.
+ * 
+ * @param machine machine to map the handlers into
+ * @param address start address of the range
+ * @param length  length of the range in bytes
+ * @param read    handler of the reads, or NULL
+ * @param write   handler of the writes, or NULL
+ * @param context context to pass to the handlers
+ * 
+ * @return bool_t false if there are already too many mapped handlers
+ */
+bool_t rl78core_mem_map_io_r(rl78core_machine_s* const machine, const uint20_t address, const uint20_t length, const rl78core_mem_io_read_t read, const rl78core_mem_io_write_t write, void* const context);
+
+/**
+ * @brief Initialize memory of the default machine.
+ * 
+ * @note See @ref rl78core_mem_init_r.
+ */
+void rl78core_mem_init(void);
+
+/**
+ * @brief Read 8-bit value from a provided address in the memory of the default
+ * machine.
+ * 
+ * @param address address to read at
+ * 
+ * @return uint8_t read 8-bit value
+ */
+uint8_t rl78core_mem_read_u08(const uint20_t address);
+
+/**
+ * @brief Write 8-bit value into a provided address in the memory of the default
+ * machine.
+ * 
+ * @param address address to write value at
+ * @param value   value to write
+ */
+void rl78core_mem_write_u08(const uint20_t address, const uint8_t value);
+
+/**
+ * @brief Read 16-bit value from a provided address in the memory of the default
+ * machine.
+ * 
+ * @note See @ref rl78core_mem_read_u16_r.
+ * 
+ * @param address address to read at
+ * 
+ * @return uint16_t read 16-bit value
+ */
+uint16_t rl78core_mem_read_u16(const uint20_t address);
+
+/**
+ * @brief Write 16-bit value from a provided address in the memory of the default
+ * machine.
+ * 
+ * @note See @ref rl78core_mem_write_u16_r.
+ * 
  * @param address address to write value at
  * @param value   value to write
  */
 void rl78core_mem_write_u16(const uint20_t address, const uint16_t value);
 
+/**
+ * @brief Same as @ref rl78core_mem_load_r, for the default machine.
+ * 
+ * @param address address to load the data at
+ * @param data    data to load
+ * @param length  length of the data in bytes
+ */
+void rl78core_mem_load(const uint20_t address, const uint8_t* const data, const uint20_t length);
+
+/**
+ * @brief Same as @ref rl78core_mem_map_image_r, for the default machine.
+ * 
+ * @param image image to map, or NULL to unmap the mapped one
+ */
+void rl78core_mem_map_image(const rl78core_mem_image_s* const image);
+
+/**
+ * @brief Same as @ref rl78core_mem_capture_r, for the default machine.
+ * 
+ * @param image image to capture into
+ */
+void rl78core_mem_capture(rl78core_mem_image_s* const image);
+
+/**
+ * @brief Same as @ref rl78core_mem_dirty_r, for the default machine.
+ * 
+ * @param address address within the page to check
+ * 
+ * @return bool_t
+ */
+bool_t rl78core_mem_dirty(const uint20_t address);
+
+/**
+ * @brief Same as @ref rl78core_mem_reset_dirty_r, for the default machine.
+ */
+void rl78core_mem_reset_dirty(void);
+
+/**
+ * @brief Same as @ref rl78core_mem_footprint_r, for the default machine.
+ * 
+ * @return uint64_t size of the committed memory in bytes
+ */
+uint64_t rl78core_mem_footprint(void);
+
+/**
+ * @brief Reference the memory of the default machine at a provided address.
+ * 
+ * @note See @ref rl78core_mem_reference_r.
+ * 
+ * @param address address to reference memory at
+ * @param size    size of the referenced memory region in bytes
+ * 
+ * @return uint8_t* pointer to the referenced memory
+ */
+uint8_t* rl78core_mem_reference(const uint20_t address, const uint20_t size);
+
+/**
+ * @brief Set the hook to be called on writes to the watched code pages of the
+ * default machine.
+ * 
+ * @param hook hook to call, or NULL to disable it
+ */
+void rl78core_mem_set_code_write_hook(const rl78core_mem_code_write_hook_t hook);
+
+/**
+ * @brief Watch the page at a provided address of the default machine for
+ * writes.
+ * 
+ * @note See @ref rl78core_mem_watch_code_page_r.
+ * 
+ * @param address address within the page to watch
+ */
+void rl78core_mem_watch_code_page(const uint20_t address);
+
+/**
+ * @brief Same as @ref rl78core_mem_map_io_r, for the default machine.
+ * 
+ * @param address start address of the range
+ * @param length  length of the range in bytes
+ * @param read    handler of the reads, or NULL
+ * @param write   handler of the writes, or NULL
+ * @param context context to pass to the handlers
+ * 
+ * @return bool_t false if there are already too many mapped handlers
+ */
+bool_t rl78core_mem_map_io(const uint20_t address, const uint20_t length, const rl78core_mem_io_read_t read, const rl78core_mem_io_write_t write, void* const context);
+
+static inline uint8_t rl78core_mem_read_u08_r(rl78core_machine_s* const machine, const uint20_t address)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(address < rl78core_mem_address_space_size);
+	const rl78core_mem_page_table_s* const table = (const rl78core_mem_page_table_s*)(const void*)machine->mem;
+	const uint8_t* const page = table->read[address >> rl78core_mem_page_shift];
+
+	if (rl78core_mem_likely(page != NULL))
+	{
+		return page[address & (rl78core_mem_page_size - 1)];
+	}
+
+	return rl78core_mem_read_slow_r(machine, address);
+}
+
+static inline void rl78core_mem_write_u08_r(rl78core_machine_s* const machine, const uint20_t address, const uint8_t value)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(address < rl78core_mem_address_space_size);
+	rl78core_mem_page_table_s* const table = (rl78core_mem_page_table_s*)(void*)machine->mem;
+	uint8_t* const page = table->write[address >> rl78core_mem_page_shift];
+
+	if (rl78core_mem_likely(page != NULL))
+	{
+		page[address & (rl78core_mem_page_size - 1)] = value;
+		table->dirty[address >> rl78core_mem_page_shift] = 1;
+		return;
+	}
+
+	rl78core_mem_write_slow_r(machine, address, value);
+}
+
+static inline uint16_t rl78core_mem_read_u16_r(rl78core_machine_s* const machine, const uint20_t address)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(address < (rl78core_mem_address_space_size - 1));
+	const rl78core_mem_page_table_s* const table = (const rl78core_mem_page_table_s*)(const void*)machine->mem;
+	const uint8_t* const page = table->read[address >> rl78core_mem_page_shift];
+	const uint20_t offset = address & (rl78core_mem_page_size - 1);
+
+	// note: the 16-bit values crossing a page boundary are read byte by byte.
+	if (rl78core_mem_likely((page != NULL) && (offset < (rl78core_mem_page_size - 1))))
+	{
+		return (uint16_t)((uint16_t)page[offset + 0] | (uint16_t)((uint16_t)page[offset + 1] << 8));
+	}
+
+	return (uint16_t)((uint16_t)rl78core_mem_read_u08_r(machine, address + 0) | \
+	(uint16_t)((uint16_t)rl78core_mem_read_u08_r(machine, address + 1) << 8));
+}
+
+static inline void rl78core_mem_write_u16_r(rl78core_machine_s* const machine, const uint20_t address, const uint16_t value)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(address < (rl78core_mem_address_space_size - 1));
+	rl78core_mem_page_table_s* const table = (rl78core_mem_page_table_s*)(void*)machine->mem;
+	uint8_t* const page = table->write[address >> rl78core_mem_page_shift];
+	const uint20_t offset = address & (rl78core_mem_page_size - 1);
+
+	// note: the 16-bit values crossing a page boundary are written byte by byte.
+	if (rl78core_mem_likely((page != NULL) && (offset < (rl78core_mem_page_size - 1))))
+	{
+		page[offset + 0] = (uint8_t)(value & 0x00FF);
+		page[offset + 1] = (uint8_t)((uint16_t)(value >> 8) & 0x00FF);
+		table->dirty[address >> rl78core_mem_page_shift] = 1;
+		return;
+	}
+
+	rl78core_mem_write_u08_r(machine, address + 0, (uint8_t)(value & 0x00FF));
+	rl78core_mem_write_u08_r(machine, address + 1, (uint8_t)((uint16_t)(value >> 8) & 0x00FF));
+}
+
 #endif
@@ -0,0 +1,229 @@
+
+/**
+ * @file sched.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78core__sched_h__
+#define __rl78emu__include__rl78core__sched_h__
+
+#include "rl78misc/common.h"
+
+#include "rl78core/machine.h"
+
+#define rl78core_sched_events_capacity 64
+#define rl78core_sched_no_event UINT8_MAX
+
+/**
+ * @brief Handler of a scheduled event, called once the cpu reaches its clock
+ * cycle. The handler may schedule the next event of its peripheral.
+ * 
+ * @param machine machine the event is dispatched on
+ * @param context context the event was added with
+ * @param cycles  count of clock cycles the event was scheduled at
+ */
+typedef void(*rl78core_sched_handler_t)(rl78core_machine_s* const machine, void* const context, const uint64_t cycles);
+
+/**
+ * @brief Scheduler of the timed events of the peripherals. The scheduled events
+ * are kept in a min-heap keyed on the absolute count of clock cycles, and the
+ * deadline of the cpu is set to the earliest of them, so the run loop executes
+ * straight until the next event is due, without polling the peripherals.
+ */
+typedef struct rl78core_sched_s rl78core_sched_s;
+
+/**
+ * @brief State of the scheduled events of a scheduler. The handlers and the
+ * contexts of the events are not a part of it, as they are added by the
+ * peripherals when the machine is created.
+ */
+typedef struct
+{
+	uint64_t scheduled;  // note: the bit n is set if the event n is scheduled.
+	uint64_t cycles[rl78core_sched_events_capacity];
+} rl78core_sched_state_s;
+
+/**
+ * @brief Create a scheduler, without any events.
+ * 
+ * @return rl78core_sched_s* created scheduler
+ */
+rl78core_sched_s* rl78core_sched_create(void);
+
+/**
+ * @brief Destroy the scheduler created with @ref rl78core_sched_create.
+ * 
+ * @param sched scheduler to destroy
+ */
+void rl78core_sched_destroy(rl78core_sched_s* const sched);
+
+/**
+ * @brief Initialize the scheduler of a provided machine. The scheduled events
+ * are cancelled, while the added ones are kept.
+ * 
+ * @param machine machine to operate on
+ */
+void rl78core_sched_init_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Add an event, to be scheduled with @ref rl78core_sched_schedule_r.
+ * 
+ * @param machine machine to operate on
+ * @param handler handler of the event
+ * @param context context to pass to the handler
+ * 
+ * @return uint8_t added event, or @ref rl78core_sched_no_event if there are
+ * already too many events
+ */
+uint8_t rl78core_sched_add_event_r(rl78core_machine_s* const machine, const rl78core_sched_handler_t handler, void* const context);
+
+/**
+ * @brief Schedule an event at an absolute count of clock cycles. An already
+ * scheduled event is moved.
+ * 
+ * @note The events due at the same count of clock cycles are dispatched in the
+ * order they were added in.
+ * 
+ * @warning The deadline of the cpu is overwritten by the earliest event.
+ * 
+ * @param machine machine to operate on
+ * @param event   event to schedule
+ * @param cycles  count of clock cycles to dispatch the event at
+ */
+void rl78core_sched_schedule_r(rl78core_machine_s* const machine, const uint8_t event, const uint64_t cycles);
+
+/**
+ * @brief Cancel a scheduled event.
+ * 
+ * @param machine machine to operate on
+ * @param event   event to cancel
+ * 
+ * @return bool_t false if the event was not scheduled
+ */
+bool_t rl78core_sched_cancel_r(rl78core_machine_s* const machine, const uint8_t event);
+
+/**
+ * @brief Check if an event is scheduled.
+ * 
+ * @param machine machine to operate on
+ * @param event   event to check
+ * 
+ * @return bool_t
+ */
+bool_t rl78core_sched_pending_r(rl78core_machine_s* const machine, const uint8_t event);
+
+/**
+ * @brief Get the count of clock cycles of the earliest scheduled event.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return uint64_t count of clock cycles, or @ref rl78core_cpu_no_deadline if
+ * no event is scheduled
+ */
+uint64_t rl78core_sched_next_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Dispatch the events due at the count of clock cycles of the cpu, and
+ * set the deadline of the cpu to the next event. Called by the cpu run loop
+ * once its deadline is due.
+ * 
+ * @warning A handler must not schedule its event at the current count of clock
+ * cycles again, as it would be dispatched endlessly.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return bool_t false if no event was due
+ */
+bool_t rl78core_sched_dispatch_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Save the state of the scheduled events.
+ * 
+ * @param machine machine to operate on
+ * @param state   pointer to store the state into
+ */
+void rl78core_sched_save_r(rl78core_machine_s* const machine, rl78core_sched_state_s* const state);
+
+/**
+ * @brief Restore a saved state of the scheduled events. The events scheduled
+ * in the state are scheduled again, and all the other ones are cancelled.
+ * 
+ * @warning The events must have been added in the same order as in the machine
+ * the state was saved from.
+ * 
+ * @param machine machine to operate on
+ * @param state   state to restore
+ */
+void rl78core_sched_restore_r(rl78core_machine_s* const machine, const rl78core_sched_state_s* const state);
+
+/**
+ * @brief Same as @ref rl78core_sched_init_r, for the default machine.
+ */
+void rl78core_sched_init(void);
+
+/**
+ * @brief Same as @ref rl78core_sched_add_event_r, for the default machine.
+ * 
+ * @param handler handler of the event
+ * @param context context to pass to the handler
+ * 
+ * @return uint8_t added event, or @ref rl78core_sched_no_event if there are
+ * already too many events
+ */
+uint8_t rl78core_sched_add_event(const rl78core_sched_handler_t handler, void* const context);
+
+/**
+ * @brief Same as @ref rl78core_sched_schedule_r, for the default machine.
+ * 
+ * @param event  event to schedule
+ * @param cycles count of clock cycles to dispatch the event at
+ */
+void rl78core_sched_schedule(const uint8_t event, const uint64_t cycles);
+
+/**
+ * @brief Same as @ref rl78core_sched_cancel_r, for the default machine.
+ * 
+ * @param event event to cancel
+ * 
+ * @return bool_t false if the event was not scheduled
+ */
+bool_t rl78core_sched_cancel(const uint8_t event);
+
+/**
+ * @brief Same as @ref rl78core_sched_pending_r, for the default machine.
+ * 
+ * @param event event to check
+ * 
+ * @return bool_t
+ */
+bool_t rl78core_sched_pending(const uint8_t event);
+
+/**
+ * @brief Same as @ref rl78core_sched_next_r, for the default machine.
+ * 
+ * @return uint64_t count of clock cycles, or @ref rl78core_cpu_no_deadline if
+ * no event is scheduled
+ */
+uint64_t rl78core_sched_next(void);
+
+/**
+ * @brief Same as @ref rl78core_sched_save_r, for the default machine.
+ * 
+ * @param state pointer to store the state into
+ */
+void rl78core_sched_save(rl78core_sched_state_s* const state);
+
+/**
+ * @brief Same as @ref rl78core_sched_restore_r, for the default machine.
+ * 
+ * @param state state to restore
+ */
+void rl78core_sched_restore(const rl78core_sched_state_s* const state);
+
+#endif
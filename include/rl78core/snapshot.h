@@ -0,0 +1,124 @@
+
+/**
+ * @file snapshot.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78core__snapshot_h__
+#define __rl78emu__include__rl78core__snapshot_h__
+
+#include "rl78misc/common.h"
+
+#include "rl78core/machine.h"
+#include "rl78core/mem.h"
+#include "rl78core/cpu.h"
+
+#define rl78core_snapshot_version 3
+
+/**
+ * @brief Snapshot of the state of a machine: the state of its cpu, of its
+ * scheduled events and of its timer array units, and the contents of its
+ * memory.
+ * 
+ * @note Apart from the timer array units, the state of the i/o handlers is
+ * held by their contexts, and is not a part of the snapshot.
+ */
+typedef struct rl78core_snapshot_s rl78core_snapshot_s;
+
+/**
+ * @brief Capture the state of a provided machine into a snapshot.
+ * 
+ * @param machine machine to capture the state of
+ * 
+ * @return rl78core_snapshot_s* captured snapshot
+ */
+rl78core_snapshot_s* rl78core_snapshot_capture_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Destroy the snapshot captured with @ref rl78core_snapshot_capture_r,
+ * or loaded with @ref rl78core_snapshot_load.
+ * 
+ * @warning The snapshot must not be restored into any machine anymore, as its
+ * memory stays mapped into the restored machines.
+ * 
+ * @param snapshot snapshot to destroy
+ */
+void rl78core_snapshot_destroy(rl78core_snapshot_s* const snapshot);
+
+/**
+ * @brief Restore a snapshot into a provided machine. The memory of the snapshot
+ * is mapped into the machine as an image, so that the pages are shared with
+ * the snapshot until they are written to, and only the committed pages of the
+ * machine are copied.
+ * 
+ * @note The timer array units and the scheduled events of the machine are
+ * restored, and the deadline of the cpu is set to the earliest event. The
+ * breakpoints and the mapped i/o handlers of the machine are kept. The
+ * interrupt flag registers are restored with the memory.
+ * 
+ * @param machine  machine to restore the snapshot into
+ * @param snapshot snapshot to restore
+ */
+void rl78core_snapshot_restore_r(rl78core_machine_s* const machine, const rl78core_snapshot_s* const snapshot);
+
+/**
+ * @brief Fork a new machine off a snapshot, with @ref rl78core_snapshot_restore_r.
+ * 
+ * @param snapshot snapshot to fork off
+ * 
+ * @return rl78core_machine_s* forked machine, to be destroyed by the caller
+ */
+rl78core_machine_s* rl78core_snapshot_fork(const rl78core_snapshot_s* const snapshot);
+
+/**
+ * @brief Get the state of the cpu of a snapshot.
+ * 
+ * @param snapshot snapshot to get the state of
+ * 
+ * @return const rl78core_cpu_state_s*
+ */
+const rl78core_cpu_state_s* rl78core_snapshot_cpu(const rl78core_snapshot_s* const snapshot);
+
+/**
+ * @brief Save a snapshot into a file, in a versioned binary format.
+ * 
+ * @param snapshot snapshot to save
+ * @param path     path of the file
+ * 
+ * @return bool_t false if the file can not be written
+ */
+bool_t rl78core_snapshot_save(const rl78core_snapshot_s* const snapshot, const char_t* const path);
+
+/**
+ * @brief Load a snapshot saved with @ref rl78core_snapshot_save.
+ * 
+ * @note The error is logged if the file can not be read, or it is not a
+ * snapshot of the supported version.
+ * 
+ * @param path path of the file
+ * 
+ * @return rl78core_snapshot_s* loaded snapshot, or NULL on failure
+ */
+rl78core_snapshot_s* rl78core_snapshot_load(const char_t* const path);
+
+/**
+ * @brief Same as @ref rl78core_snapshot_capture_r, for the default machine.
+ * 
+ * @return rl78core_snapshot_s* captured snapshot
+ */
+rl78core_snapshot_s* rl78core_snapshot_capture(void);
+
+/**
+ * @brief Same as @ref rl78core_snapshot_restore_r, for the default machine.
+ * 
+ * @param snapshot snapshot to restore
+ */
+void rl78core_snapshot_restore(const rl78core_snapshot_s* const snapshot);
+
+#endif
@@ -0,0 +1,111 @@
+
+/**
+ * @file symbols.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78core__symbols_h__
+#define __rl78emu__include__rl78core__symbols_h__
+
+#include "rl78misc/common.h"
+
+/**
+ * @brief Symbol of a firmware, such as a function or an object.
+ */
+typedef struct
+{
+	const char_t* name;
+	uint20_t address;
+	uint32_t size;
+} rl78core_symbol_s;
+
+/**
+ * @brief Index of the symbols of a firmware, searchable by the address and by
+ * the name.
+ */
+typedef struct rl78core_symbols_s rl78core_symbols_s;
+
+/**
+ * @brief Create an empty index of symbols.
+ * 
+ * @return rl78core_symbols_s* created index
+ */
+rl78core_symbols_s* rl78core_symbols_create(void);
+
+/**
+ * @brief Destroy the index created with @ref rl78core_symbols_create.
+ * 
+ * @param symbols index to destroy
+ */
+void rl78core_symbols_destroy(rl78core_symbols_s* const symbols);
+
+/**
+ * @brief Add a symbol to the index. The name is copied.
+ * 
+ * @warning The index must be sorted with @ref rl78core_symbols_sort, before
+ * it is searched.
+ * 
+ * @param symbols index to add to
+ * @param name    name of the symbol
+ * @param address address of the symbol
+ * @param size    size of the symbol, or 0 if it is unknown
+ */
+void rl78core_symbols_add(rl78core_symbols_s* const symbols, const char_t* const name, const uint20_t address, const uint32_t size);
+
+/**
+ * @brief Sort the added symbols by their address, and by their name.
+ * 
+ * @param symbols index to sort
+ */
+void rl78core_symbols_sort(rl78core_symbols_s* const symbols);
+
+/**
+ * @brief Get the count of the symbols.
+ * 
+ * @param symbols index to get the count of
+ * 
+ * @return uint64_t
+ */
+uint64_t rl78core_symbols_count(const rl78core_symbols_s* const symbols);
+
+/**
+ * @brief Get a symbol by its index, in the order of the addresses.
+ * 
+ * @param symbols index to get the symbol from
+ * @param index   index of the symbol
+ * 
+ * @return const rl78core_symbol_s*
+ */
+const rl78core_symbol_s* rl78core_symbols_at(const rl78core_symbols_s* const symbols, const uint64_t index);
+
+/**
+ * @brief Find the symbol containing an address, with a binary search. The
+ * containing symbol with the greatest address not above the provided one is
+ * chosen, and of those at the same address, the largest one. A symbol of
+ * unknown size contains its address only, so a label inside a function does
+ * not hide the function past the label.
+ * 
+ * @param symbols index to search
+ * @param address address to find the symbol of
+ * 
+ * @return const rl78core_symbol_s* found symbol, or NULL
+ */
+const rl78core_symbol_s* rl78core_symbols_find(const rl78core_symbols_s* const symbols, const uint20_t address);
+
+/**
+ * @brief Look a symbol up by its name, with a binary search.
+ * 
+ * @param symbols index to search
+ * @param name    name of the symbol
+ * 
+ * @return const rl78core_symbol_s* found symbol, or NULL
+ */
+const rl78core_symbol_s* rl78core_symbols_lookup(const rl78core_symbols_s* const symbols, const char_t* const name);
+
+#endif
@@ -0,0 +1,210 @@
+
+/**
+ * @file tau.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78core__tau_h__
+#define __rl78emu__include__rl78core__tau_h__
+
+#include "rl78misc/common.h"
+
+#include "rl78core/machine.h"
+
+#define rl78core_tau_units_count 2
+#define rl78core_tau_channels_count 8
+
+/**
+ * note: the counter (TCR), mode (TMR) and status (TSR) registers of the
+ * channels, and the enable (TE), start (TS), stop (TT), prescaler (TPS) and
+ * output (TO, TOE, TOL, TOM) registers of a unit are mapped to the i/o handlers
+ * in the extended sfr area, in a block of 0x40 bytes per unit. The data
+ * registers (TDR) stay in the memory of the sfr area, next to the psw and sp,
+ * and are read by the units at the start of every count.
+ */
+#define rl78core_tau_registers_address 0xF0180
+#define rl78core_tau_registers_length 0x80
+
+/**
+ * @brief Timer array units of a machine. The counters are not ticked: every
+ * counting channel holds its count at the clock cycle it was loaded at, and the
+ * value of its counter register is computed from the cycles of the cpu when it
+ * is read. The ends of the counts, which raise the INTTM interrupts, are events
+ * of the scheduler.
+ * 
+ * @note The units are frozen while the cpu is in the stop mode, which stops
+ * their count clock: the counting channels hold their counts, and the ends of
+ * their counts are not scheduled.
+ * 
+ * @note The interval timer, capture, event counter and one-count modes are
+ * supported, and so are the pwm and the delay counter functions, of the slave
+ * channels started by the interrupts of their master. The count clock is
+ * divided from the clock cycles of the cpu, and its phase is kept from the start
+ * of the count. The 8-bit timer mode is not supported.
+ */
+typedef struct rl78core_tau_s rl78core_tau_s;
+
+/**
+ * @brief State of a channel of a timer array unit.
+ */
+typedef struct
+{
+	uint16_t mode;
+	uint16_t counter;
+	uint64_t start;
+	uint8_t shift;
+	uint8_t status;
+	bool_t counting;
+} rl78core_tau_channel_state_s;
+
+/**
+ * @brief State of a timer array unit.
+ */
+typedef struct
+{
+	rl78core_tau_channel_state_s channels[rl78core_tau_channels_count];
+	uint16_t enables;
+	uint16_t prescalers;
+	uint16_t outputs;
+	uint16_t output_enables;
+	uint16_t output_levels;
+	uint16_t output_modes;
+} rl78core_tau_unit_state_s;
+
+/**
+ * @brief State of the timer array units of a machine. The ends of the counts
+ * are not a part of it, as they are events of the scheduler.
+ */
+typedef struct
+{
+	rl78core_tau_unit_state_s units[rl78core_tau_units_count];
+} rl78core_tau_state_s;
+
+/**
+ * @brief Create the timer array units of a provided machine. Their registers
+ * are mapped into the memory, and the events of their channels are added to the
+ * scheduler.
+ * 
+ * @note The units are not initialized.
+ * 
+ * @param machine machine to create the units for
+ * 
+ * @return rl78core_tau_s* created units
+ */
+rl78core_tau_s* rl78core_tau_create(rl78core_machine_s* const machine);
+
+/**
+ * @brief Destroy the units created with @ref rl78core_tau_create.
+ * 
+ * @param tau units to destroy
+ */
+void rl78core_tau_destroy(rl78core_tau_s* const tau);
+
+/**
+ * @brief Initialize the timer array units of a provided machine. All the
+ * channels are stopped, and their registers are reset.
+ * 
+ * @warning The memory, the scheduler and the interrupt controller of the
+ * machine must be initialized before the units.
+ * 
+ * @param machine machine to operate on
+ */
+void rl78core_tau_init_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Signal a valid edge of the timer input (TI) of a channel, at the
+ * current clock cycle of the cpu. The edge captures the counter in the capture
+ * mode, is counted in the event counter mode, and triggers the start of the
+ * count in the one-count mode, if it is selected as the trigger.
+ * 
+ * @param machine machine to operate on
+ * @param unit    unit of the channel
+ * @param channel channel of the unit
+ */
+void rl78core_tau_input_r(rl78core_machine_s* const machine, const uint8_t unit, const uint8_t channel);
+
+/**
+ * @brief Freeze the timer array units of a provided machine at the current
+ * clock cycle of the cpu. The counting channels hold their counts, and the ends
+ * of their counts are cancelled.
+ * 
+ * @warning It is called by the cpu, once it has entered the stop mode.
+ * 
+ * @param machine machine to operate on
+ */
+void rl78core_tau_freeze_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Resume the timer array units of a provided machine, frozen with
+ * @ref rl78core_tau_freeze_r, from the current clock cycle of the cpu. The ends
+ * of the counts are scheduled again.
+ * 
+ * @warning It is called by the cpu, before it leaves the stop mode.
+ * 
+ * @param machine machine to operate on
+ */
+void rl78core_tau_resume_r(rl78core_machine_s* const machine);
+
+/**
+ * @brief Save the state of the timer array units of a provided machine.
+ * 
+ * @param machine machine to operate on
+ * @param state   pointer to store the state into
+ */
+void rl78core_tau_save_r(rl78core_machine_s* const machine, rl78core_tau_state_s* const state);
+
+/**
+ * @brief Restore a saved state of the timer array units of a provided machine.
+ * 
+ * @note The events of the counting channels are not scheduled: they are
+ * restored with the state of the scheduler.
+ * 
+ * @param machine machine to operate on
+ * @param state   state to restore
+ */
+void rl78core_tau_restore_r(rl78core_machine_s* const machine, const rl78core_tau_state_s* const state);
+
+/**
+ * @brief Same as @ref rl78core_tau_init_r, for the default machine.
+ */
+void rl78core_tau_init(void);
+
+/**
+ * @brief Same as @ref rl78core_tau_input_r, for the default machine.
+ * 
+ * @param unit    unit of the channel
+ * @param channel channel of the unit
+ */
+void rl78core_tau_input(const uint8_t unit, const uint8_t channel);
+
+/**
+ * @brief Same as @ref rl78core_tau_freeze_r, for the default machine.
+ */
+void rl78core_tau_freeze(void);
+
+/**
+ * @brief Same as @ref rl78core_tau_resume_r, for the default machine.
+ */
+void rl78core_tau_resume(void);
+
+/**
+ * @brief Same as @ref rl78core_tau_save_r, for the default machine.
+ * 
+ * @param state pointer to store the state into
+ */
+void rl78core_tau_save(rl78core_tau_state_s* const state);
+
+/**
+ * @brief Same as @ref rl78core_tau_restore_r, for the default machine.
+ * 
+ * @param state state to restore
+ */
+void rl78core_tau_restore(const rl78core_tau_state_s* const state);
+
+#endif
@@ -47,10 +47,11 @@ void rl78misc_debug_assert_impl(
 /**
  * @brief Debug assert wrapper.
  * 
- * @note It abstracts the @ref rl78misc_debug_assert_impl function and passes line,
- * file, and stringified expression to the implementation function.
+ * @note The expression is not evaluated in the release builds, so the asserts
+ * cost nothing on the hot paths. It is still compiled, to keep the variables it
+ * uses referenced.
  */
-#	define rl78misc_debug_assert(_expression) ((void)(_expression))
+#	define rl78misc_debug_assert(_expression) ((void)sizeof(_expression))
 #endif
 
 #endif
@@ -0,0 +1,51 @@
+
+/**
+ * @file file.h
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#ifndef __rl78emu__include__rl78misc__file_h__
+#define __rl78emu__include__rl78misc__file_h__
+
+#include "rl78misc/common.h"
+
+#ifndef rl78misc_file_mmap_enabled
+#	if defined(__unix__) || defined(__APPLE__)
+#		define rl78misc_file_mmap_enabled 1
+#	else
+#		define rl78misc_file_mmap_enabled 0
+#	endif
+#endif
+
+/**
+ * @brief Map the contents of a file into the memory, read-only. The file is
+ * read into a heap region instead, if the mapping is not enabled for the host.
+ * 
+ * @note The error is logged if the file can not be read, or if it is empty.
+ * 
+ * @param path   path of the file
+ * @param length pointer to store the length of the contents into
+ * 
+ * @return const uint8_t* contents of the file, or NULL on failure
+ */
+const uint8_t* rl78misc_file_map(
+	const char_t* const path,
+	uint64_t* const length);
+
+/**
+ * @brief Unmap the contents of a file mapped with @ref rl78misc_file_map.
+ * 
+ * @param contents contents of the file
+ * @param length   length of the contents
+ */
+void rl78misc_file_unmap(
+	const uint8_t* const contents,
+	const uint64_t length);
+
+#endif
@@ -15,44 +15,132 @@
 
 #include "rl78misc/common.h"
 
+#define rl78misc_logger_records_capacity 1024
+#define rl78misc_logger_record_length 248
+
+#define rl78misc_logger_level_trace 0
+#define rl78misc_logger_level_info 1
+#define rl78misc_logger_level_warn 2
+#define rl78misc_logger_level_error 3
+#define rl78misc_logger_level_log 4  // note: tagless output of the program, such as its usage or results.
+#define rl78misc_logger_levels_count 5
+
 /**
- * @brief Log tagless level formattable messages.
+ * note: the minimum level of the logs compiled in. The calls of the lower
+ * levels compile to nothing, and their arguments are never evaluated.
+ */
+#ifndef rl78misc_logger_min_level
+#	define rl78misc_logger_min_level rl78misc_logger_level_trace
+#endif
+
+/**
+ * @brief Log formattable messages of a provided level, if the level is both
+ * compiled in and enabled at runtime. The arguments are evaluated only then.
  * 
- * @param format format of the log
- * @param ...    arguments of the log
+ * @param _level level of the log
+ * @param ...    format and arguments of the log
  */
-void rl78misc_logger_log(
-	const char_t* const format,
-	...) __attribute__ ((format (printf, 1, 2)));
+#define rl78misc_logger_at(_level, ...)                                        \
+	do                                                                         \
+	{                                                                          \
+		if (((_level) >= rl78misc_logger_min_level) &&                         \
+			rl78misc_logger_enabled(_level))                                   \
+		{                                                                      \
+			rl78misc_logger_write((_level), __VA_ARGS__);                      \
+		}                                                                      \
+	} while (0)
+
+/**
+ * @brief Log tagless level formattable messages.
+ */
+#define rl78misc_logger_log(...) rl78misc_logger_at(rl78misc_logger_level_log, __VA_ARGS__)
+
+/**
+ * @brief Log trace level formattable messages.
+ */
+#define rl78misc_logger_trace(...) rl78misc_logger_at(rl78misc_logger_level_trace, __VA_ARGS__)
 
 /**
  * @brief Log info level formattable messages.
- * 
- * @param format format of the log
- * @param ...    arguments of the log
  */
-void rl78misc_logger_info(
-	const char_t* const format,
-	...) __attribute__ ((format (printf, 1, 2)));
+#define rl78misc_logger_info(...) rl78misc_logger_at(rl78misc_logger_level_info, __VA_ARGS__)
 
 /**
  * @brief Log warn level formattable messages.
- * 
- * @param format format of the log
- * @param ...    arguments of the log
  */
-void rl78misc_logger_warn(
-	const char_t* const format,
-	...) __attribute__ ((format (printf, 1, 2)));
+#define rl78misc_logger_warn(...) rl78misc_logger_at(rl78misc_logger_level_warn, __VA_ARGS__)
 
 /**
  * @brief Log error level formattable messages.
+ */
+#define rl78misc_logger_error(...) rl78misc_logger_at(rl78misc_logger_level_error, __VA_ARGS__)
+
+/**
+ * @brief Log formattable messages of a provided level unconditionally. The
+ * trace and info levels are logged into the stdout, and the warn and error
+ * levels into the stderr.
+ * 
+ * @note Use the level macros instead, which skip the disabled levels.
  * 
+ * @param level  level of the log
  * @param format format of the log
  * @param ...    arguments of the log
  */
-void rl78misc_logger_error(
+void rl78misc_logger_write(
+	const uint8_t level,
 	const char_t* const format,
-	...) __attribute__ ((format (printf, 1, 2)));
+	...) __attribute__ ((format (printf, 2, 3)));
+
+/**
+ * @brief Check whether a provided level is enabled at runtime.
+ * 
+ * @param level level to check
+ * 
+ * @return bool_t
+ */
+bool_t rl78misc_logger_enabled(
+	const uint8_t level);
+
+/**
+ * @brief Set the minimum level of the logs enabled at runtime. The info level
+ * is set initially. The tagless logs are always enabled.
+ * 
+ * @param level minimum level to enable
+ */
+void rl78misc_logger_set_level(
+	const uint8_t level);
+
+/**
+ * @brief Start the asynchronous backend of the logger. The logged messages are
+ * then formatted into the records of a bounded lock-free queue, and written in
+ * batches by a background thread. The trace and info messages logged while the
+ * queue is full are dropped, and their count is reported once the queue
+ * drains. The messages of the other levels wait for a free record instead.
+ * 
+ * @note The messages longer than the record are truncated. The backend is
+ * stopped on exit, and the messages are logged synchronously until it is
+ * started.
+ */
+void rl78misc_logger_start(
+	void);
+
+/**
+ * @brief Stop the asynchronous backend of the logger, once all the queued
+ * records are written and the streams flushed. The messages are then logged
+ * synchronously again.
+ * 
+ * @warning No other threads may log while the backend is stopped.
+ */
+void rl78misc_logger_stop(
+	void);
+
+/**
+ * @brief Get the count of the trace and info messages dropped by the
+ * asynchronous backend of the logger, since the start of the program.
+ * 
+ * @return uint64_t
+ */
+uint64_t rl78misc_logger_dropped(
+	void);
 
 #endif
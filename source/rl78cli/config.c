@@ -14,22 +14,30 @@
 #include "rl78misc/logger.h"
 
 #include "rl78cli/config.h"
+#include "rl78cli/farm.h"
 
 #include "rl78emu/version.h"
 
+#include <stdio.h>
+
 static const char_t* g_program = NULL;
 static const char_t* const g_usage_banner =
 	"usage: %s [options] <binary>\n"
 	"\n"
 	"required:\n"
 	"    binary              binary file path to be flashed into the emulator and run.\n"
-	"                        it can be one of the following types: [ihex|srec].\n"
+	"                        it can be one of the following types: [ihex|srec|elf].\n"
 	"                        if binary path is not provided, emulator will exit and print this message.\n"
-	"                        note: the srec format will not be supported for the first release.\n"
 	"\n"
 	"options:\n"
 	"    -h, --help          print the help message.\n"
 	"    -v, --version       print version and exit.\n"
+	"    --engine=<engine>   engine to run the binary with: [interp|block|jit]. defaults to interp.\n"
+	"    --cache=<dir>       cache the loaded binary in the directory, keyed by the hash of its contents.\n"
+	"    --log-level=<level> minimum level of the logs: [trace|info|warn|error]. defaults to info.\n"
+	"    --trace             trace every executed instruction. implies the trace log level.\n"
+	"    --farm <n> <list>   run the test vectors of the list file against the binary, on n worker threads.\n"
+	"                        every line of the list is: <name> [patch:<address>=<byte>]... [expect:<address>=<byte>]... [cycles:<count>]\n"
 	"\n"
 	"notice:\n"
 	"    this executable is distributed under the \"rl78f14emu gplv1\" license.\n";
@@ -39,6 +47,50 @@ static bool_t match_option(
 	const char_t* const long_name,
 	const char_t* const short_name);
 
+/**
+ * @brief Match option of `<name><value>` form, and extract its value.
+ * 
+ * @param option option to match
+ * @param name   name of the option, including the `=` character
+ * @param value  pointer to store the option's value into
+ * 
+ * @return bool_t
+ */
+static bool_t match_valued_option(
+	const char_t* const option,
+	const char_t* const name,
+	const char_t** const value);
+
+/**
+ * @brief Parse the engine option value.
+ * 
+ * @param value value of the engine option
+ * 
+ * @return rl78core_cpu_engine_e
+ */
+static rl78core_cpu_engine_e parse_engine(
+	const char_t* const value);
+
+/**
+ * @brief Parse the log level option value.
+ * 
+ * @param value value of the log level option
+ * 
+ * @return uint8_t
+ */
+static uint8_t parse_log_level(
+	const char_t* const value);
+
+/**
+ * @brief Parse the farm workers count option value.
+ * 
+ * @param value value of the farm workers count option
+ * 
+ * @return uint64_t
+ */
+static uint64_t parse_farm_workers(
+	const char_t* const value);
+
 rl78cli_config_s rl78cli_config_from_cli(
 	const uint64_t argc,
 	const char_t** const argv)
@@ -48,6 +100,13 @@ rl78cli_config_s rl78cli_config_from_cli(
 
 	g_program = argv[0];
 	const char_t* binary = NULL;
+	rl78core_cpu_engine_e engine = rl78core_cpu_engine_interp;
+	uint64_t farm_workers = 0;
+	const char_t* vectors = NULL;
+	const char_t* cache = NULL;
+	uint8_t log_level = rl78misc_logger_level_info;
+	bool_t trace = false;
+	const char_t* value = NULL;
 
 	for (uint64_t argv_index = 1; argv_index < argc; ++argv_index)
 	{
@@ -64,6 +123,34 @@ rl78cli_config_s rl78cli_config_from_cli(
 			rl78misc_logger_log("%s %s", g_program, rl78emu_version);
 			rl78misc_exit(0);
 		}
+		else if (match_valued_option(option, "--engine=", &value))
+		{
+			engine = parse_engine(value);
+		}
+		else if (match_valued_option(option, "--cache=", &value))
+		{
+			cache = value;
+		}
+		else if (match_valued_option(option, "--log-level=", &value))
+		{
+			log_level = parse_log_level(value);
+		}
+		else if (0 == rl78misc_strcmp(option, "--trace"))
+		{
+			trace = true;
+		}
+		else if (0 == rl78misc_strcmp(option, "--farm"))
+		{
+			if ((argv_index + 2) >= argc)
+			{
+				rl78misc_logger_error("missing workers count and vectors list path of the '%s' option.", option);
+				rl78cli_config_usage();
+				rl78misc_exit(-1);
+			}
+
+			farm_workers = parse_farm_workers(argv[++argv_index]);
+			vectors = argv[++argv_index];
+		}
 		else
 		{
 			if (binary != NULL)
@@ -87,6 +174,12 @@ rl78cli_config_s rl78cli_config_from_cli(
 	return (rl78cli_config_s)
 	{
 		.binary = binary,
+		.engine = engine,
+		.farm_workers = farm_workers,
+		.vectors = vectors,
+		.cache = cache,
+		.log_level = trace ? rl78misc_logger_level_trace : log_level,
+		.trace = trace,
 	};
 }
 
@@ -116,3 +209,94 @@ static bool_t match_option(
 		((option_length == short_name_length) && rl78misc_strncmp(option, short_name, option_length) == 0)
 	);
 }
+
+static bool_t match_valued_option(
+	const char_t* const option,
+	const char_t* const name,
+	const char_t** const value)
+{
+	rl78misc_debug_assert(option != NULL);
+	rl78misc_debug_assert(name != NULL);
+	rl78misc_debug_assert(value != NULL);
+
+	const uint64_t name_length = rl78misc_strlen(name);
+
+	if (rl78misc_strncmp(option, name, name_length) != 0)
+	{
+		return false;
+	}
+
+	*value = option + name_length;
+	return true;
+}
+
+static rl78core_cpu_engine_e parse_engine(
+	const char_t* const value)
+{
+	rl78misc_debug_assert(value != NULL);
+
+	if (0 == rl78misc_strcmp(value, "interp"))
+	{
+		return rl78core_cpu_engine_interp;
+	}
+	else if (0 == rl78misc_strcmp(value, "block"))
+	{
+		return rl78core_cpu_engine_block;
+	}
+	else if (0 == rl78misc_strcmp(value, "jit"))
+	{
+		return rl78core_cpu_engine_jit;
+	}
+
+	rl78misc_logger_error("invalid engine '%s' was provided.", value);
+	rl78cli_config_usage();
+	rl78misc_exit(-1);
+	return rl78core_cpu_engine_interp;
+}
+
+static uint8_t parse_log_level(
+	const char_t* const value)
+{
+	rl78misc_debug_assert(value != NULL);
+
+	if (0 == rl78misc_strcmp(value, "trace"))
+	{
+		return rl78misc_logger_level_trace;
+	}
+	else if (0 == rl78misc_strcmp(value, "info"))
+	{
+		return rl78misc_logger_level_info;
+	}
+	else if (0 == rl78misc_strcmp(value, "warn"))
+	{
+		return rl78misc_logger_level_warn;
+	}
+	else if (0 == rl78misc_strcmp(value, "error"))
+	{
+		return rl78misc_logger_level_error;
+	}
+
+	rl78misc_logger_error("invalid log level '%s' was provided.", value);
+	rl78cli_config_usage();
+	rl78misc_exit(-1);
+	return rl78misc_logger_level_info;
+}
+
+static uint64_t parse_farm_workers(
+	const char_t* const value)
+{
+	rl78misc_debug_assert(value != NULL);
+
+	uint64_t workers = 0;
+	int32_t length = 0;
+
+	if ((sscanf(value, "%lu%n", &workers, &length) != 1) || (value[length] != '\0') ||
+		(0 == workers) || (workers > rl78cli_farm_workers_capacity))
+	{
+		rl78misc_logger_error("invalid farm workers count '%s' was provided. it must be in range [1, %d].", value, rl78cli_farm_workers_capacity);
+		rl78cli_config_usage();
+		rl78misc_exit(-1);
+	}
+
+	return workers;
+}
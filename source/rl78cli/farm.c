@@ -0,0 +1,485 @@
+
+/**
+ * @file farm.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+#include "rl78misc/logger.h"
+
+#include "rl78core/machine.h"
+#include "rl78core/mem.h"
+#include "rl78core/cpu.h"
+
+#include "rl78cli/farm.h"
+
+#include <pthread.h>
+#include <stdio.h>
+
+#define rl78cli_farm_line_capacity 1024
+#define rl78cli_farm_token_capacity 128
+
+/**
+ * @brief Queue of the vectors of a worker. The owner pops the vectors from the
+ * head, while the thieves pop them from the tail.
+ */
+typedef struct
+{
+	pthread_mutex_t mutex;
+	uint64_t head;
+	uint64_t tail;
+} rl78cli_farm_queue_s;
+
+/**
+ * @brief Worker of a farm. It runs the vectors on a machine of its own.
+ */
+typedef struct
+{
+	const rl78cli_farm_s* farm;
+	rl78cli_farm_result_s* results;
+	rl78cli_farm_queue_s* queues;
+	const rl78core_mem_image_s* image;
+	uint64_t index;
+} rl78cli_farm_worker_s;
+
+/**
+ * @brief Parse a token of a vectors list line into a provided vector.
+ * 
+ * @param token  token to parse
+ * @param vector vector to parse the token into
+ * 
+ * @return bool_t false if the token is malformed
+ */
+static bool_t parse_token(
+	const char_t* const token,
+	rl78cli_farm_vector_s* const vector);
+
+/**
+ * @brief Parse a `<prefix><address>=<value>` token into a provided pair.
+ * 
+ * @param token  token to parse
+ * @param prefix prefix of the token
+ * @param pair   pair to parse the token into
+ * 
+ * @return bool_t false if the token does not match the prefix or is malformed
+ */
+static bool_t parse_pair(
+	const char_t* const token,
+	const char_t* const prefix,
+	rl78cli_farm_pair_s* const pair);
+
+/**
+ * @brief Check if a provided line is blank or a comment.
+ * 
+ * @param line line to check
+ * 
+ * @return bool_t
+ */
+static bool_t is_skipped_line(
+	const char_t* const line);
+
+/**
+ * @brief Pop the vector index from the head or the tail of a provided queue.
+ * 
+ * @param queue queue to pop from
+ * @param steal pop from the tail if true, otherwise from the head
+ * @param index pointer to store the popped vector index into
+ * 
+ * @return bool_t false if the queue is empty
+ */
+static bool_t queue_pop(
+	rl78cli_farm_queue_s* const queue,
+	const bool_t steal,
+	uint64_t* const index);
+
+/**
+ * @brief Run a vector on a provided machine.
+ * 
+ * @note The firmware image is expected to be mapped into the machine.
+ * 
+ * @param machine machine to run the vector on
+ * @param farm    farm of the vector
+ * @param vector  vector to run
+ * @param result  pointer to store the result of the vector into
+ */
+static void run_vector(
+	rl78core_machine_s* const machine,
+	const rl78cli_farm_s* const farm,
+	const rl78cli_farm_vector_s* const vector,
+	rl78cli_farm_result_s* const result);
+
+/**
+ * @brief Entry of a worker thread.
+ * 
+ * @param argument pointer to the worker
+ * 
+ * @return void* always NULL
+ */
+static void* worker_main(
+	void* argument);
+
+bool_t rl78cli_farm_parse_vector(
+	const char_t* const line,
+	rl78cli_farm_vector_s* const vector)
+{
+	rl78misc_debug_assert(line != NULL);
+	rl78misc_debug_assert(vector != NULL);
+
+	rl78misc_memset(vector, 0, sizeof(*vector));
+	vector->cycles = rl78cli_farm_default_cycles;
+
+	int32_t consumed = 0;
+
+	if (sscanf(line, " %63s%n", vector->name, &consumed) != 1)
+	{
+		return false;
+	}
+
+	const char_t* cursor = line + consumed;
+	char_t token[rl78cli_farm_token_capacity] = {0};
+
+	while (sscanf(cursor, " %127s%n", token, &consumed) == 1)
+	{
+		cursor += consumed;
+
+		if (!parse_token(token, vector))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+rl78cli_farm_vector_s* rl78cli_farm_load_vectors(
+	const char_t* const path,
+	uint64_t* const count)
+{
+	rl78misc_debug_assert(path != NULL);
+	rl78misc_debug_assert(count != NULL);
+
+	FILE* const file = fopen(path, "r");
+
+	if (NULL == file)
+	{
+		rl78misc_logger_error("failed to open the vectors list '%s'.", path);
+		rl78misc_exit(-1);
+	}
+
+	rl78cli_farm_vector_s* vectors = NULL;
+	uint64_t capacity = 0;
+	uint64_t line_number = 0;
+	char_t line[rl78cli_farm_line_capacity] = {0};
+	*count = 0;
+
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		++line_number;
+
+		if (is_skipped_line(line))
+		{
+			continue;
+		}
+
+		if (*count >= capacity)
+		{
+			capacity = (0 == capacity) ? 16 : (capacity * 2);
+			vectors = (rl78cli_farm_vector_s*)rl78misc_realloc(vectors, capacity * sizeof(rl78cli_farm_vector_s));
+		}
+
+		if (!rl78cli_farm_parse_vector(line, &vectors[*count]))
+		{
+			rl78misc_logger_error("malformed vector at '%s:%lu'.", path, line_number);
+			rl78misc_exit(-1);
+		}
+
+		++(*count);
+	}
+
+	(void)fclose(file);
+	return vectors;
+}
+
+void rl78cli_farm_run(
+	const rl78cli_farm_s* const farm,
+	rl78cli_farm_result_s* const results)
+{
+	rl78misc_debug_assert(farm != NULL);
+	rl78misc_debug_assert(results != NULL);
+	rl78misc_debug_assert(farm->workers > 0 && farm->workers <= rl78cli_farm_workers_capacity);
+
+	rl78cli_farm_queue_s queues[rl78cli_farm_workers_capacity];
+	rl78cli_farm_worker_s workers[rl78cli_farm_workers_capacity];
+	pthread_t threads[rl78cli_farm_workers_capacity];
+
+	// note: the vectors are split evenly, and the stealing balances the rest.
+	for (uint64_t index = 0; index < farm->workers; ++index)
+	{
+		(void)pthread_mutex_init(&queues[index].mutex, NULL);
+		queues[index].head = (farm->vectors_count * index) / farm->workers;
+		queues[index].tail = (farm->vectors_count * (index + 1)) / farm->workers;
+		workers[index] = (rl78cli_farm_worker_s)
+		{
+			.farm = farm,
+			.results = results,
+			.queues = queues,
+			.image = farm->firmware,
+			.index = index,
+		};
+	}
+
+	for (uint64_t index = 0; index < farm->workers; ++index)
+	{
+		if (pthread_create(&threads[index], NULL, worker_main, &workers[index]) != 0)
+		{
+			rl78misc_logger_error("failed to create the farm worker %lu.", index);
+			rl78misc_exit(-1);
+		}
+	}
+
+	for (uint64_t index = 0; index < farm->workers; ++index)
+	{
+		(void)pthread_join(threads[index], NULL);
+		(void)pthread_mutex_destroy(&queues[index].mutex);
+	}
+}
+
+uint64_t rl78cli_farm_report(
+	const rl78cli_farm_s* const farm,
+	const rl78cli_farm_result_s* const results,
+	const double seconds)
+{
+	rl78misc_debug_assert(farm != NULL);
+	rl78misc_debug_assert(results != NULL);
+
+	uint64_t failed = 0;
+
+	for (uint64_t index = 0; index < farm->vectors_count; ++index)
+	{
+		const rl78cli_farm_vector_s* const vector = &farm->vectors[index];
+		const rl78cli_farm_result_s* const result = &results[index];
+
+		if (result->passed)
+		{
+			rl78misc_logger_log("  %-24s pass cycles=%lu", vector->name, result->cycles);
+			continue;
+		}
+
+		++failed;
+
+		if (result->stop != rl78core_cpu_stop_halt)
+		{
+			rl78misc_logger_error("  %-24s fail cycles=%lu: not halted, stop=%d pc=0x%05X",
+				vector->name, result->cycles, (int32_t)result->stop, result->pc);
+		}
+		else
+		{
+			const rl78cli_farm_pair_s* const expect = &vector->expects[result->mismatch];
+			rl78misc_logger_error("  %-24s fail cycles=%lu: expected 0x%02X at 0x%05X, got 0x%02X",
+				vector->name, result->cycles, expect->value, expect->address, result->actual);
+		}
+	}
+
+	rl78misc_logger_log("farm: %lu vectors, %lu passed, %lu failed, on %lu workers in %.3f s.",
+		farm->vectors_count, farm->vectors_count - failed, failed, farm->workers, seconds);
+	return failed;
+}
+
+static bool_t parse_token(
+	const char_t* const token,
+	rl78cli_farm_vector_s* const vector)
+{
+	rl78misc_debug_assert(token != NULL);
+	rl78misc_debug_assert(vector != NULL);
+
+	rl78cli_farm_pair_s pair = {0};
+
+	if (parse_pair(token, "patch:", &pair))
+	{
+		if (vector->patches_count >= rl78cli_farm_pairs_capacity)
+		{
+			return false;
+		}
+
+		vector->patches[vector->patches_count++] = pair;
+		return true;
+	}
+
+	if (parse_pair(token, "expect:", &pair))
+	{
+		if (vector->expects_count >= rl78cli_farm_pairs_capacity)
+		{
+			return false;
+		}
+
+		vector->expects[vector->expects_count++] = pair;
+		return true;
+	}
+
+	uint64_t cycles = 0;
+	int32_t length = 0;
+
+	if ((sscanf(token, "cycles:%lu%n", &cycles, &length) == 1) && ('\0' == token[length]) && (cycles > 0))
+	{
+		vector->cycles = cycles;
+		return true;
+	}
+
+	return false;
+}
+
+static bool_t parse_pair(
+	const char_t* const token,
+	const char_t* const prefix,
+	rl78cli_farm_pair_s* const pair)
+{
+	rl78misc_debug_assert(token != NULL);
+	rl78misc_debug_assert(prefix != NULL);
+	rl78misc_debug_assert(pair != NULL);
+
+	const uint64_t prefix_length = rl78misc_strlen(prefix);
+
+	if (rl78misc_strncmp(token, prefix, prefix_length) != 0)
+	{
+		return false;
+	}
+
+	uint32_t address = 0;
+	uint32_t value = 0;
+	int32_t length = 0;
+
+	if ((sscanf(token + prefix_length, "%x=%x%n", &address, &value, &length) != 2) ||
+		(token[prefix_length + (uint64_t)length] != '\0') || (address > 0xFFFFF) || (value > 0xFF))
+	{
+		return false;
+	}
+
+	pair->address = address;
+	pair->value = (uint8_t)value;
+	return true;
+}
+
+static bool_t is_skipped_line(
+	const char_t* const line)
+{
+	rl78misc_debug_assert(line != NULL);
+
+	const char_t* cursor = line;
+
+	while (' ' == *cursor || '\t' == *cursor || '\r' == *cursor || '\n' == *cursor)
+	{
+		++cursor;
+	}
+
+	return ('\0' == *cursor) || ('#' == *cursor);
+}
+
+static bool_t queue_pop(
+	rl78cli_farm_queue_s* const queue,
+	const bool_t steal,
+	uint64_t* const index)
+{
+	rl78misc_debug_assert(queue != NULL);
+	rl78misc_debug_assert(index != NULL);
+
+	(void)pthread_mutex_lock(&queue->mutex);
+	const bool_t popped = (queue->head < queue->tail);
+
+	if (popped)
+	{
+		*index = steal ? --queue->tail : queue->head++;
+	}
+
+	(void)pthread_mutex_unlock(&queue->mutex);
+	return popped;
+}
+
+static void run_vector(
+	rl78core_machine_s* const machine,
+	const rl78cli_farm_s* const farm,
+	const rl78cli_farm_vector_s* const vector,
+	rl78cli_farm_result_s* const result)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(farm != NULL);
+	rl78misc_debug_assert(vector != NULL);
+	rl78misc_debug_assert(result != NULL);
+
+	rl78core_machine_init(machine);
+	rl78core_cpu_set_engine_r(machine, farm->engine);
+
+	for (uint8_t index = 0; index < vector->patches_count; ++index)
+	{
+		rl78core_mem_write_u08_r(machine, vector->patches[index].address, vector->patches[index].value);
+	}
+
+	const rl78core_cpu_budget_s budget = { .cycles = vector->cycles, .instructions = 0 };
+
+	*result = (rl78cli_farm_result_s)
+	{
+		.passed = false,
+		.stop = rl78core_cpu_run_r(machine, budget),
+		.cycles = rl78core_cpu_cycles_r(machine),
+		.pc = rl78core_cpu_read_pc_r(machine),
+		.mismatch = 0,
+		.actual = 0,
+	};
+
+	if (result->stop != rl78core_cpu_stop_halt)
+	{
+		return;
+	}
+
+	for (uint8_t index = 0; index < vector->expects_count; ++index)
+	{
+		const uint8_t actual = rl78core_mem_read_u08_r(machine, vector->expects[index].address);
+
+		if (actual != vector->expects[index].value)
+		{
+			result->mismatch = index;
+			result->actual = actual;
+			return;
+		}
+	}
+
+	result->passed = true;
+}
+
+static void* worker_main(
+	void* argument)
+{
+	rl78misc_debug_assert(argument != NULL);
+
+	const rl78cli_farm_worker_s* const worker = (const rl78cli_farm_worker_s*)argument;
+	const rl78cli_farm_s* const farm = worker->farm;
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	rl78core_mem_map_image_r(machine, worker->image);
+	uint64_t index = 0;
+
+	while (true)
+	{
+		bool_t popped = queue_pop(&worker->queues[worker->index], false, &index);
+
+		// note: no vectors are added during the run, so all the queues being empty ends the worker.
+		for (uint64_t offset = 1; !popped && offset < farm->workers; ++offset)
+		{
+			popped = queue_pop(&worker->queues[(worker->index + offset) % farm->workers], true, &index);
+		}
+
+		if (!popped)
+		{
+			break;
+		}
+
+		run_vector(machine, farm, &farm->vectors[index], &worker->results[index]);
+	}
+
+	rl78core_machine_destroy(machine);
+	return NULL;
+}
@@ -12,10 +12,60 @@
 
 #include "rl78misc/logger.h"
 
+#include "rl78core/machine.h"
 #include "rl78core/mem.h"
 #include "rl78core/cpu.h"
+#include "rl78core/symbols.h"
+#include "rl78core/loader.h"
+#include "rl78core/cache.h"
 
 #include "rl78cli/config.h"
+#include "rl78cli/farm.h"
+
+#include <time.h>
+
+#define rl78cli_cycles_per_slice 0x10000
+
+/**
+ * @brief Run the test vectors of the farm mode against a provided firmware.
+ * 
+ * @param config   config of the farm mode
+ * @param firmware firmware image to run the vectors against
+ * 
+ * @return int32_t exit code: 0 if all the vectors passed, -1 otherwise
+ */
+static int32_t run_farm(
+	const rl78cli_config_s* const config,
+	const rl78core_mem_image_s* const firmware);
+
+/**
+ * @brief Log the position of the cpu after a run: as a trace of the executed
+ * instruction, or as the info of the finished slice.
+ * 
+ * @param symbols symbols of the firmware
+ * @param stop    reason of the stop of the run
+ * @param trace   true if the run traced a single instruction
+ */
+static void log_position(
+	const rl78core_symbols_s* const symbols,
+	const rl78core_cpu_stop_e stop,
+	const bool_t trace);
+
+/**
+ * @brief Destroy the cache of the binary, if it was created.
+ * 
+ * @param cache cache to destroy, or NULL
+ */
+static void destroy_cache(
+	rl78core_cache_s* const cache);
+
+/**
+ * @brief Get monotonic time in seconds.
+ * 
+ * @return double
+ */
+static double now(
+	void);
 
 int32_t main(
 	const int32_t argc,
@@ -28,31 +78,146 @@ int32_t main(
 	rl78misc_logger_log("rl78emu: hello, world!");
 
 	const rl78cli_config_s config = rl78cli_config_from_cli((uint64_t)argc, argv);
-	(void)config;
+	rl78misc_logger_set_level(config.log_level);
+
+	// note: the backend is stopped on exit, which flushes the queued logs. The
+	// trace is logged synchronously instead, as none of it may be dropped.
+	if (!config.trace)
+	{
+		rl78misc_logger_start();
+	}
 
-	rl78core_mem_init();
-	rl78core_cpu_init();
+	rl78core_mem_image_s* const firmware = rl78core_mem_image_create();
+	rl78core_symbols_s* const symbols = rl78core_symbols_create();
+	rl78core_cache_s* const cache = (config.cache != NULL) ? rl78core_cache_create(config.cache) : NULL;
+	const bool_t loaded = (cache != NULL) ?
+		rl78core_cache_load(cache, config.binary, firmware, symbols) :
+		rl78core_loader_load(config.binary, firmware, symbols);
 
-	// todo: flash the binary into the mem:
-	// [
-		#define rom_length 2
-		const uint8_t rom[rom_length] =
-		{
-			0x50, 0x69
-		};
+	if (!loaded)
+	{
+		rl78misc_logger_error("failed to load the binary '%s'.", config.binary);
+		rl78misc_exit(-1);
+	}
+
+	if (config.farm_workers > 0)
+	{
+		const int32_t code = run_farm(&config, firmware);
+		rl78core_symbols_destroy(symbols);
+		rl78core_mem_image_destroy(firmware);
+		destroy_cache(cache);
+		return code;
+	}
 
-		for (uint20_t address = 0; address < rom_length; ++address)
+	rl78core_mem_map_image(firmware);
+	rl78core_machine_init(rl78core_machine_default());
+	rl78core_cpu_set_engine(config.engine);
+
+	// note: the trace runs a single instruction at a time, while the slices run
+	// without any logging work per instruction. The cycles budget also bounds the
+	// idle clock cycles skipped in the standby modes.
+	const rl78core_cpu_budget_s budget = config.trace ?
+		(rl78core_cpu_budget_s) { .cycles = rl78cli_cycles_per_slice, .instructions = 1 } :
+		(rl78core_cpu_budget_s) { .cycles = rl78cli_cycles_per_slice, .instructions = 0 };
+	rl78core_cpu_stop_e stop = rl78core_cpu_stop_budget;
+
+	while (stop != rl78core_cpu_stop_halt)
+	{
+		stop = rl78core_cpu_run(budget);
+		log_position(symbols, stop, config.trace);
+	}
+
+	rl78core_symbols_destroy(symbols);
+	rl78core_mem_map_image(NULL);
+	rl78core_mem_image_destroy(firmware);
+	destroy_cache(cache);
+	return 0;
+}
+
+static int32_t run_farm(
+	const rl78cli_config_s* const config,
+	const rl78core_mem_image_s* const firmware)
+{
+	uint64_t vectors_count = 0;
+	rl78cli_farm_vector_s* const vectors = rl78cli_farm_load_vectors(config->vectors, &vectors_count);
+
+	const rl78cli_farm_s farm =
+	{
+		.firmware = firmware,
+		.engine = config->engine,
+		.workers = config->farm_workers,
+		.vectors = vectors,
+		.vectors_count = vectors_count,
+	};
+
+	// note: one extra result keeps the allocation non-empty for an empty vectors list.
+	rl78cli_farm_result_s* const results = (rl78cli_farm_result_s*)rl78misc_malloc((vectors_count + 1) * sizeof(rl78cli_farm_result_s));
+	const double start = now();
+	rl78cli_farm_run(&farm, results);
+	const uint64_t failed = rl78cli_farm_report(&farm, results, now() - start);
+
+	(void)rl78misc_free(results);
+	(void)rl78misc_free(vectors);
+	return (0 == failed) ? 0 : -1;
+}
+
+static void log_position(
+	const rl78core_symbols_s* const symbols,
+	const rl78core_cpu_stop_e stop,
+	const bool_t trace)
+{
+	rl78misc_debug_assert(symbols != NULL);
+
+	if (!rl78misc_logger_enabled(trace ? rl78misc_logger_level_trace : rl78misc_logger_level_info))
+	{
+		return;
+	}
+
+	const uint20_t pc = rl78core_cpu_read_pc();
+	const rl78core_symbol_s* const symbol = rl78core_symbols_find(symbols, pc);
+
+	if (trace)
+	{
+		const uint8_t a = rl78core_cpu_read_gpr08(rl78core_gpr08_a);
+		const uint8_t x = rl78core_cpu_read_gpr08(rl78core_gpr08_x);
+		const uint16_t bc = rl78core_cpu_read_gpr16(rl78core_gpr16_bc);
+		const uint16_t de = rl78core_cpu_read_gpr16(rl78core_gpr16_de);
+		const uint16_t hl = rl78core_cpu_read_gpr16(rl78core_gpr16_hl);
+
+		if (symbol != NULL)
+		{
+			rl78misc_logger_trace("cycles=%lu pc=0x%05X <%s+0x%X> a=0x%02X x=0x%02X bc=0x%04X de=0x%04X hl=0x%04X",
+				rl78core_cpu_cycles(), pc, symbol->name, pc - symbol->address, a, x, bc, de, hl);
+		}
+		else
 		{
-			rl78core_mem_write_u08(address, rom[address]);
+			rl78misc_logger_trace("cycles=%lu pc=0x%05X a=0x%02X x=0x%02X bc=0x%04X de=0x%04X hl=0x%04X",
+				rl78core_cpu_cycles(), pc, a, x, bc, de, hl);
 		}
-	// ]
+	}
+	else if (symbol != NULL)
+	{
+		rl78misc_logger_info("cycles=%lu stop=%d pc=0x%05X <%s+0x%X>", rl78core_cpu_cycles(), (int32_t)stop, pc, symbol->name, pc - symbol->address);
+	}
+	else
+	{
+		rl78misc_logger_info("cycles=%lu stop=%d pc=0x%05X", rl78core_cpu_cycles(), (int32_t)stop, pc);
+	}
+}
 
-	for (uint64_t tick_count = 0; !rl78core_cpu_halted(); ++tick_count)
+static void destroy_cache(
+	rl78core_cache_s* const cache)
+{
+	if (cache != NULL)
 	{
-		rl78core_cpu_tick();
-		rl78misc_logger_log("tick_count=%lu", tick_count);
-		rl78misc_logger_log("----------");
+		rl78core_cache_destroy(cache);
 	}
+}
 
-	return 0;
+static double now(
+	void)
+{
+	struct timespec time;
+	(void)clock_gettime(CLOCK_MONOTONIC, &time);
+	return (double)time.tv_sec + ((double)time.tv_nsec / 1e9);
 }
@@ -0,0 +1,459 @@
+
+/**
+ * @file cache.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+#include "rl78misc/logger.h"
+#include "rl78misc/file.h"
+
+#include "rl78core/loader.h"
+#include "rl78core/cache.h"
+
+#include <stdio.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#	include <unistd.h>
+#endif
+
+#define rl78core_cache_version 1
+#define rl78core_cache_alignment 4096
+#define rl78core_cache_path_capacity 4096
+
+/**
+ * note: the cached file is laid out as the header, the indices of the loaded
+ * pages, the symbols, the names of the symbols, and the contents of the loaded
+ * pages, starting at a multiple of the alignment. The values are stored in the
+ * byte order of the host, which the magic tells apart.
+ */
+
+typedef struct
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t page_size;
+	uint64_t hash;
+	uint64_t length;  // note: length of the binary the file is a cache of.
+	uint32_t pages_count;
+	uint32_t symbols_count;
+	uint64_t names_length;
+	uint64_t pages_offset;
+} rl78core_cache_header_s;
+
+typedef struct
+{
+	uint32_t address;
+	uint32_t size;
+	uint64_t name;  // note: offset of the name, within the names.
+} rl78core_cache_symbol_s;
+
+typedef struct
+{
+	const uint8_t* contents;
+	uint64_t length;
+} rl78core_cache_mapping_s;
+
+struct rl78core_cache_s
+{
+	char_t* directory;
+	rl78core_cache_mapping_s* mappings;
+	uint64_t mappings_count;
+	uint64_t mappings_capacity;
+	uint64_t hits;
+};
+
+static const uint64_t g_rl78core_cache_magic = 0x676D693837726C00;  // note: "\0rl78img" in the little-endian order.
+
+/**
+ * @brief Hash the contents of a binary.
+ * 
+ * @param contents contents of the binary
+ * @param length   length of the contents
+ * 
+ * @return uint64_t
+ */
+static uint64_t hash_contents(const uint8_t* const contents, const uint64_t length);
+
+/**
+ * @brief Get the offsets of the symbols, the names and the pages of a cached
+ * file.
+ * 
+ * @param header  header of the cached file
+ * @param symbols pointer to store the offset of the symbols into
+ * @param names   pointer to store the offset of the names into
+ * 
+ * @return uint64_t offset of the pages
+ */
+static uint64_t layout(const rl78core_cache_header_s* const header, uint64_t* const symbols, uint64_t* const names);
+
+/**
+ * @brief Load a cached file into a provided image, if it is valid for the
+ * binary. The file stays mapped, until the cache is destroyed.
+ * 
+ * @param cache   cache to load through
+ * @param path    path of the cached file
+ * @param hash    hash of the binary
+ * @param length  length of the binary
+ * @param image   image to attach the pages to
+ * @param symbols index to add the symbols to, or NULL
+ * 
+ * @return bool_t false if the cached file does not exist, or is not valid
+ */
+static bool_t load_cached(rl78core_cache_s* const cache, const char_t* const path, const uint64_t hash, const uint64_t length, rl78core_mem_image_s* const image, rl78core_symbols_s* const symbols);
+
+/**
+ * @brief Write the cached file of a loaded binary. The file is written under a
+ * temporary name and renamed, so that concurrent loads never see it partial.
+ * 
+ * @param path    path of the cached file
+ * @param hash    hash of the binary
+ * @param length  length of the binary
+ * @param image   image the binary was loaded into
+ * @param symbols symbols of the binary
+ * 
+ * @return bool_t false if the file can not be written
+ */
+static bool_t write_cached(const char_t* const path, const uint64_t hash, const uint64_t length, const rl78core_mem_image_s* const image, const rl78core_symbols_s* const symbols);
+
+/**
+ * @brief Write zeros into a file, up to a provided offset.
+ * 
+ * @param file   file to write into
+ * @param offset offset of the file, written so far
+ * @param target offset to pad the file up to
+ * 
+ * @return bool_t false if the file can not be written
+ */
+static bool_t write_padding(FILE* const file, const uint64_t offset, const uint64_t target);
+
+rl78core_cache_s* rl78core_cache_create(const char_t* const directory)
+{
+	rl78misc_debug_assert(directory != NULL);
+
+	const uint64_t length = rl78misc_strlen(directory) + 1;
+	rl78core_cache_s* const cache = (rl78core_cache_s*)rl78misc_malloc(sizeof(rl78core_cache_s));
+	*cache = (rl78core_cache_s)
+	{
+		.directory = (char_t*)rl78misc_malloc(length),
+		.mappings = NULL,
+		.mappings_count = 0,
+		.mappings_capacity = 0,
+		.hits = 0,
+	};
+
+	rl78misc_memcpy(cache->directory, directory, length);
+	return cache;
+}
+
+void rl78core_cache_destroy(rl78core_cache_s* const cache)
+{
+	rl78misc_debug_assert(cache != NULL);
+
+	for (uint64_t index = 0; index < cache->mappings_count; ++index)
+	{
+		rl78misc_file_unmap(cache->mappings[index].contents, cache->mappings[index].length);
+	}
+
+	(void)rl78misc_free(cache->mappings);
+	(void)rl78misc_free(cache->directory);
+	(void)rl78misc_free(cache);
+}
+
+bool_t rl78core_cache_load(rl78core_cache_s* const cache, const char_t* const path, rl78core_mem_image_s* const image, rl78core_symbols_s* const symbols)
+{
+	rl78misc_debug_assert(cache != NULL);
+	rl78misc_debug_assert(path != NULL);
+	rl78misc_debug_assert(image != NULL);
+
+	uint64_t length = 0;
+	const uint8_t* const contents = rl78misc_file_map(path, &length);
+
+	if (NULL == contents)
+	{
+		return false;
+	}
+
+	const uint64_t hash = hash_contents(contents, length);
+	char_t cached_path[rl78core_cache_path_capacity];
+	const int32_t written = snprintf(cached_path, sizeof(cached_path), "%s/%016lx.rl78img", cache->directory, hash);
+
+	if (written < 0 || (uint64_t)written >= sizeof(cached_path))
+	{
+		rl78misc_logger_warn("the cache directory path '%s' is too long. the cache is bypassed.", cache->directory);
+		const bool_t loaded = rl78core_loader_load_contents(path, contents, length, image, symbols);
+		rl78misc_file_unmap(contents, length);
+		return loaded;
+	}
+
+	if (load_cached(cache, cached_path, hash, length, image, symbols))
+	{
+		rl78misc_file_unmap(contents, length);
+		++cache->hits;
+		return true;
+	}
+
+	// note: the symbols are always collected, to be cached for the loads that need them.
+	rl78core_symbols_s* const collected = (symbols != NULL) ? symbols : rl78core_symbols_create();
+	const bool_t loaded = rl78core_loader_load_contents(path, contents, length, image, collected);
+	rl78misc_file_unmap(contents, length);
+
+	if (loaded && !write_cached(cached_path, hash, length, image, collected))
+	{
+		rl78misc_logger_warn("failed to write the cached file '%s'.", cached_path);
+	}
+
+	if (NULL == symbols)
+	{
+		rl78core_symbols_destroy(collected);
+	}
+
+	return loaded;
+}
+
+uint64_t rl78core_cache_hits(const rl78core_cache_s* const cache)
+{
+	rl78misc_debug_assert(cache != NULL);
+	return cache->hits;
+}
+
+static uint64_t hash_contents(const uint8_t* const contents, const uint64_t length)
+{
+	uint64_t hash = 0xCBF29CE484222325 ^ length;
+	uint64_t offset = 0;
+
+	// note: eight bytes are mixed in at a time, with a multiply and a shift.
+	for (; (offset + 8) <= length; offset += 8)
+	{
+		uint64_t word = 0;
+		rl78misc_memcpy(&word, &contents[offset], sizeof(word));
+		hash = (hash ^ word) * 0x9E3779B97F4A7C15;
+		hash ^= hash >> 29;
+	}
+
+	uint64_t tail = 0;
+
+	if (offset < length)
+	{
+		rl78misc_memcpy(&tail, &contents[offset], length - offset);
+	}
+
+	hash = (hash ^ tail) * 0x9E3779B97F4A7C15;
+
+	hash ^= hash >> 30;
+	hash *= 0xBF58476D1CE4E5B9;
+	hash ^= hash >> 27;
+	hash *= 0x94D049BB133111EB;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+static uint64_t layout(const rl78core_cache_header_s* const header, uint64_t* const symbols, uint64_t* const names)
+{
+	const uint64_t indices = sizeof(rl78core_cache_header_s) + ((uint64_t)header->pages_count * sizeof(uint32_t));
+	*symbols = (indices + 7) & ~(uint64_t)7;
+	*names = *symbols + ((uint64_t)header->symbols_count * sizeof(rl78core_cache_symbol_s));
+	return (*names + header->names_length + (rl78core_cache_alignment - 1)) & ~(uint64_t)(rl78core_cache_alignment - 1);
+}
+
+static bool_t load_cached(rl78core_cache_s* const cache, const char_t* const path, const uint64_t hash, const uint64_t length, rl78core_mem_image_s* const image, rl78core_symbols_s* const symbols)
+{
+	// note: a missing cached file is not an error, so it is probed before it is mapped.
+	FILE* const probe = fopen(path, "rb");
+
+	if (NULL == probe)
+	{
+		return false;
+	}
+
+	(void)fclose(probe);
+	uint64_t file_length = 0;
+	const uint8_t* const contents = rl78misc_file_map(path, &file_length);
+
+	if (NULL == contents)
+	{
+		return false;
+	}
+
+	rl78core_cache_header_s header = {0};
+	uint64_t symbols_offset = 0;
+	uint64_t names_offset = 0;
+	bool_t valid = (file_length >= sizeof(header));
+
+	if (valid)
+	{
+		rl78misc_memcpy(&header, contents, sizeof(header));
+		valid = (g_rl78core_cache_magic == header.magic) && (rl78core_cache_version == header.version) &&
+			(rl78core_mem_page_size == header.page_size) && (hash == header.hash) && (length == header.length) &&
+			(header.pages_count <= rl78core_mem_pages_count) && (header.names_length <= file_length) &&
+			(header.symbols_count <= (file_length / sizeof(rl78core_cache_symbol_s)));
+	}
+
+	if (valid)
+	{
+		valid = (layout(&header, &symbols_offset, &names_offset) == header.pages_offset) &&
+			(file_length == (header.pages_offset + ((uint64_t)header.pages_count * rl78core_mem_page_size))) &&
+			((0 == header.names_length) || ('\0' == contents[names_offset + header.names_length - 1]));
+	}
+
+	const uint32_t* const indices = (const uint32_t*)&contents[sizeof(header)];
+	const rl78core_cache_symbol_s* const cached_symbols = (const rl78core_cache_symbol_s*)&contents[symbols_offset];
+
+	for (uint32_t index = 0; valid && (index < header.pages_count); ++index)
+	{
+		valid = (indices[index] < rl78core_mem_pages_count) && ((0 == index) || (indices[index] > indices[index - 1]));
+	}
+
+	for (uint32_t index = 0; valid && (index < header.symbols_count); ++index)
+	{
+		valid = (cached_symbols[index].address < rl78core_mem_address_space_size) && (cached_symbols[index].name < header.names_length);
+	}
+
+	if (!valid)
+	{
+		rl78misc_logger_warn("the cached file '%s' is stale or corrupt. it will be rewritten.", path);
+		rl78misc_file_unmap(contents, file_length);
+		return false;
+	}
+
+	for (uint32_t index = 0; index < header.pages_count; ++index)
+	{
+		const uint8_t* const page = &contents[header.pages_offset + ((uint64_t)index * rl78core_mem_page_size)];
+		rl78core_mem_image_attach(image, (uint20_t)(indices[index] << rl78core_mem_page_shift), page, rl78core_mem_page_size);
+	}
+
+	if (symbols != NULL)
+	{
+		const char_t* const names = (const char_t*)&contents[names_offset];
+
+		for (uint32_t index = 0; index < header.symbols_count; ++index)
+		{
+			rl78core_symbols_add(symbols, &names[cached_symbols[index].name], cached_symbols[index].address, cached_symbols[index].size);
+		}
+
+		rl78core_symbols_sort(symbols);
+	}
+
+	if (cache->mappings_count >= cache->mappings_capacity)
+	{
+		cache->mappings_capacity = (0 == cache->mappings_capacity) ? 4 : (cache->mappings_capacity * 2);
+		cache->mappings = (rl78core_cache_mapping_s*)rl78misc_realloc(cache->mappings, cache->mappings_capacity * sizeof(rl78core_cache_mapping_s));
+	}
+
+	cache->mappings[cache->mappings_count++] = (rl78core_cache_mapping_s) { .contents = contents, .length = file_length };
+	return true;
+}
+
+static bool_t write_cached(const char_t* const path, const uint64_t hash, const uint64_t length, const rl78core_mem_image_s* const image, const rl78core_symbols_s* const symbols)
+{
+	rl78core_cache_header_s header =
+	{
+		.magic = g_rl78core_cache_magic,
+		.version = rl78core_cache_version,
+		.page_size = rl78core_mem_page_size,
+		.hash = hash,
+		.length = length,
+		.pages_count = 0,
+		.symbols_count = (uint32_t)rl78core_symbols_count(symbols),
+		.names_length = 0,
+		.pages_offset = 0,
+	};
+
+	for (uint20_t page = 0; page < rl78core_mem_pages_count; ++page)
+	{
+		header.pages_count += (rl78core_mem_image_page(image, page) != NULL) ? 1 : 0;
+	}
+
+	for (uint32_t index = 0; index < header.symbols_count; ++index)
+	{
+		header.names_length += rl78misc_strlen(rl78core_symbols_at(symbols, index)->name) + 1;
+	}
+
+	uint64_t symbols_offset = 0;
+	uint64_t names_offset = 0;
+	header.pages_offset = layout(&header, &symbols_offset, &names_offset);
+
+	char_t temporary_path[rl78core_cache_path_capacity + 32];
+#if defined(__unix__) || defined(__APPLE__)
+	(void)snprintf(temporary_path, sizeof(temporary_path), "%s.%d.tmp", path, (int32_t)getpid());
+#else
+	(void)snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", path);
+#endif
+
+	FILE* const file = fopen(temporary_path, "wb");
+
+	if (NULL == file)
+	{
+		return false;
+	}
+
+	bool_t written = (1 == fwrite(&header, sizeof(header), 1, file));
+	uint64_t offset = sizeof(header);
+
+	for (uint20_t page = 0; written && (page < rl78core_mem_pages_count); ++page)
+	{
+		if (rl78core_mem_image_page(image, page) != NULL)
+		{
+			written = (1 == fwrite(&page, sizeof(uint32_t), 1, file));
+			offset += sizeof(uint32_t);
+		}
+	}
+
+	written = written && write_padding(file, offset, symbols_offset);
+	uint64_t name = 0;
+
+	for (uint32_t index = 0; written && (index < header.symbols_count); ++index)
+	{
+		const rl78core_symbol_s* const symbol = rl78core_symbols_at(symbols, index);
+		const rl78core_cache_symbol_s cached_symbol = { .address = symbol->address, .size = symbol->size, .name = name };
+		written = (1 == fwrite(&cached_symbol, sizeof(cached_symbol), 1, file));
+		name += rl78misc_strlen(symbol->name) + 1;
+	}
+
+	for (uint32_t index = 0; written && (index < header.symbols_count); ++index)
+	{
+		const char_t* const symbol_name = rl78core_symbols_at(symbols, index)->name;
+		written = (1 == fwrite(symbol_name, rl78misc_strlen(symbol_name) + 1, 1, file));
+	}
+
+	written = written && write_padding(file, names_offset + header.names_length, header.pages_offset);
+
+	for (uint20_t page = 0; written && (page < rl78core_mem_pages_count); ++page)
+	{
+		const uint8_t* const contents = rl78core_mem_image_page(image, page);
+
+		if (contents != NULL)
+		{
+			written = (1 == fwrite(contents, rl78core_mem_page_size, 1, file));
+		}
+	}
+
+	written = (0 == fclose(file)) && written;
+
+	if (!written || rename(temporary_path, path) != 0)
+	{
+		(void)remove(temporary_path);
+		return false;
+	}
+
+	return true;
+}
+
+static bool_t write_padding(FILE* const file, const uint64_t offset, const uint64_t target)
+{
+	for (uint64_t index = offset; index < target; ++index)
+	{
+		if (fputc(0, file) == EOF)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
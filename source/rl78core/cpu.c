@@ -15,6 +15,18 @@
 
 #include "rl78core/mem.h"
 #include "rl78core/cpu.h"
+#include "rl78core/jit.h"
+#include "rl78core/sched.h"
+#include "rl78core/intc.h"
+#include "rl78core/tau.h"
+
+#ifndef rl78core_cpu_threaded_dispatch
+#	if defined(__GNUC__)
+#		define rl78core_cpu_threaded_dispatch 1
+#	else
+#		define rl78core_cpu_threaded_dispatch 0
+#	endif
+#endif
 
 /**
  * note: regarding the instruction formats:
@@ -34,13 +46,366 @@ typedef enum
 	rl78core_fixed_sfr_mem = 0xFFFFF,
 } rl78core_fixed_sfr_e;
 
+typedef enum
+{
+	rl78core_psw_flag_cy = 0x01,
+	rl78core_psw_flag_isp0 = 0x02,
+	rl78core_psw_flag_isp1 = 0x04,
+	rl78core_psw_flag_rbs0 = 0x08,
+	rl78core_psw_flag_ac = 0x10,
+	rl78core_psw_flag_rbs1 = 0x20,
+	rl78core_psw_flag_z = 0x40,
+	rl78core_psw_flag_ie = 0x80,
+} rl78core_psw_flag_e;
+
+/**
+ * note: the flags updated by the alu instructions are evaluated lazily. The
+ * last flags updating operation is recorded with its operands and result, and
+ * the psw register is only written once the flags get observed, or once they
+ * get partially overwritten by another operation.
+ */
+typedef enum
+{
+	rl78core_cpu_flags_op_none = 0x00,  // note: the psw register is up to date.
+	rl78core_cpu_flags_op_add = 0x01,   // note: updates Z, AC and CY.
+	rl78core_cpu_flags_op_sub = 0x02,   // note: updates Z, AC and CY.
+	rl78core_cpu_flags_op_inc = 0x03,   // note: updates Z and AC.
+	rl78core_cpu_flags_op_dec = 0x04,   // note: updates Z and AC.
+	rl78core_cpu_flags_op_logic = 0x05, // note: updates Z.
+	rl78core_cpu_flags_ops_count,
+} rl78core_cpu_flags_op_e;
+
+static const uint8_t g_rl78core_cpu_flags_masks[rl78core_cpu_flags_ops_count] =
+{
+	[rl78core_cpu_flags_op_none] = 0,
+	[rl78core_cpu_flags_op_add] = rl78core_psw_flag_z | rl78core_psw_flag_ac | rl78core_psw_flag_cy,
+	[rl78core_cpu_flags_op_sub] = rl78core_psw_flag_z | rl78core_psw_flag_ac | rl78core_psw_flag_cy,
+	[rl78core_cpu_flags_op_inc] = rl78core_psw_flag_z | rl78core_psw_flag_ac,
+	[rl78core_cpu_flags_op_dec] = rl78core_psw_flag_z | rl78core_psw_flag_ac,
+	[rl78core_cpu_flags_op_logic] = rl78core_psw_flag_z,
+};
+
+typedef enum
+{
+	rl78core_condition_c = 0x00,
+	rl78core_condition_z = 0x01,
+	rl78core_condition_nc = 0x02,
+	rl78core_condition_nz = 0x03,
+} rl78core_condition_e;
+
+/**
+ * note: the list of all instruction handlers. Every entry `_name` expands into
+ * the `execute_<_name>` handler function, into the handler's index in the
+ * opcode maps and, with threaded dispatch, into the handler's label. The first
+ * entry must remain `illegal`, since zero-initialized opcode map entries decode
+ * into it. The `_cycles` is the count of clock cycles the instruction takes at
+ * least, as listed in the operation lists of the software manual above. The
+ * handlers add the cycles of the taken branches and of the wait states.
+ */
+#define rl78core_cpu_handlers(_handler)                                        \
+	_handler(illegal, 1)                                                       \
+	_handler(prefix, 1)                                                        \
+	_handler(nop, 1)                                                           \
+	_handler(mov_r_imm, 1)                                                     \
+	_handler(mov_a_r, 1)                                                       \
+	_handler(mov_r_a, 1)                                                       \
+	_handler(mov_a_saddr, 1)                                                   \
+	_handler(mov_saddr_a, 1)                                                   \
+	_handler(mov_a_sfr, 1)                                                     \
+	_handler(mov_sfr_a, 1)                                                     \
+	_handler(mov_a_addr16, 1)                                                  \
+	_handler(mov_addr16_a, 1)                                                  \
+	_handler(mov_saddr_imm, 1)                                                 \
+	_handler(mov_sfr_imm, 1)                                                   \
+	_handler(mov_addr16_imm, 2)                                                \
+	_handler(mov_a_es_addr16, 2)                                               \
+	_handler(mov_es_addr16_a, 2)                                               \
+	_handler(mov_es_addr16_imm, 3)                                             \
+	_handler(movw_rp_imm, 1)                                                   \
+	_handler(movw_sfrp_imm, 1)                                                 \
+	_handler(inc_r, 1)                                                         \
+	_handler(dec_r, 1)                                                         \
+	_handler(add_a_imm, 1)                                                     \
+	_handler(sub_a_imm, 1)                                                     \
+	_handler(cmp_a_imm, 1)                                                     \
+	_handler(and_a_imm, 1)                                                     \
+	_handler(or_a_imm, 1)                                                      \
+	_handler(xor_a_imm, 1)                                                     \
+	_handler(bcond, 2)                                                         \
+	_handler(br_rel8, 3)                                                       \
+	_handler(br_abs16, 3)                                                      \
+	_handler(br_abs20, 3)                                                      \
+	_handler(call_abs16, 3)                                                    \
+	_handler(ret, 6)                                                           \
+	_handler(reti, 6)                                                          \
+	_handler(push_rp, 1)                                                       \
+	_handler(pop_rp, 1)                                                        \
+	_handler(push_psw, 1)                                                      \
+	_handler(pop_psw, 3)                                                       \
+	_handler(sel_rb, 1)                                                        \
+	_handler(set1_sfr_bit, 2)                                                  \
+	_handler(clr1_sfr_bit, 2)                                                  \
+	_handler(set1_cy, 1)                                                       \
+	_handler(clr1_cy, 1)                                                       \
+	_handler(halt, 3)                                                          \
+	_handler(stop, 3)
+
+#define rl78core_cpu_handler_enumerator(_name, _cycles) rl78core_cpu_handler_ ## _name,
+
+typedef enum
+{
+	rl78core_cpu_handlers(rl78core_cpu_handler_enumerator)
+	rl78core_cpu_handlers_count,
+} rl78core_cpu_handler_e;
+
+#undef rl78core_cpu_handler_enumerator
+
+#define rl78core_cpu_handler_cycles(_name, _cycles) [rl78core_cpu_handler_ ## _name] = _cycles,
+
+static const uint8_t g_rl78core_cpu_cycles[rl78core_cpu_handlers_count] =
+{
+	rl78core_cpu_handlers(rl78core_cpu_handler_cycles)
+};
+
+#undef rl78core_cpu_handler_cycles
+
+/**
+ * note: the modeled device is the R5F100LE, with its code flash at [0x00000;
+ * 0x10000), its data flash at [0xF1000; 0xF2000) and its ram at [0xFEF00;
+ * 0xFFF00). The mirror of the code flash spans from the end of the data flash
+ * to the start of the ram. Only the data reads of the code flash and of its
+ * mirror take the additional wait cycles.
+ */
+#define rl78core_cpu_code_flash_end 0x10000
+#define rl78core_cpu_mirror_start 0xF2000
+#define rl78core_cpu_ram_start 0xFEF00
+#define rl78core_cpu_flash_read_wait_cycles 4
+#define rl78core_cpu_branch_taken_cycles 2
+#define rl78core_cpu_instruction_max_cycles 6
+#define rl78core_cpu_interrupt_cycles 9
+
+typedef struct
+{
+	uint8_t handler;  // note: one of rl78core_cpu_handler_e.
+	uint8_t operand;  // note: register, condition, bit or map index the handler is parameterized by.
+	uint8_t length;   // note: length of the whole instruction in bytes, prefix and opcode included.
+} rl78core_cpu_opcode_s;
+
 typedef struct
 {
+	uint20_t address;  // note: address the instruction was decoded at, or invalid address if not cached.
+	uint8_t handler;
+	uint8_t operand;
+	uint8_t length;
+	uint8_t cycles;    // note: count of clock cycles the instruction takes at least.
+	uint8_t data[4];   // note: instruction bytes that follow the opcode.
+} rl78core_cpu_instruction_s;
+
+#define rl78core_cpu_decode_cache_capacity 0x1000
+#define rl78core_cpu_decode_cache_invalid 0xFFFFFFFF
+#define rl78core_cpu_instruction_max_length 5
+
+#define rl78core_cpu_block_cache_capacity 0x200
+#define rl78core_cpu_block_max_length 16
+#define rl78core_cpu_block_jit_threshold 16
+
+typedef struct rl78core_cpu_block_s rl78core_cpu_block_s;
+
+struct rl78core_cpu_block_s
+{
+	uint20_t address;      // note: address of the first instruction, or invalid address if not cached.
+	uint20_t end_address;  // note: address past the last instruction.
+	uint8_t count;
+	rl78core_cpu_instruction_s instructions[rl78core_cpu_block_max_length];
+	rl78core_cpu_block_s* successors[2];  // note: chained fall-through and branch target blocks.
+	uint32_t hits;                        // note: count of runs, until the block gets compiled.
+	rl78core_jit_code_t jit_code;         // note: compiled code of the block, or NULL if not compiled.
+};
+
+struct rl78core_cpu_s
+{
+	rl78core_machine_s* machine;  // note: machine the cpu belongs to.
+	rl78core_jit_s* jit;
 	bool_t halted;
+	rl78core_cpu_standby_e standby;  // note: standby mode the cpu is halted in, to be woken up from.
+	bool_t requested;  // note: set while an unmasked interrupt is requested, which releases the standby modes.
+	bool_t interrupt;  // note: set while a requested interrupt is enabled by the IE and ISP flags, to be acknowledged.
+	bool_t leave;      // note: set while the cpu is halted or an interrupt is set, to leave the engines at the next boundary.
 	uint20_t pc;
-} rl78core_cpu_s;
+	uint64_t cycles;    // note: count of clock cycles elapsed since the initialization.
+	uint64_t deadline;  // note: count of clock cycles at which the run stops with the event reason.
+	uint20_t breakpoints[rl78core_cpu_breakpoints_capacity];
+	uint8_t breakpoints_count;
+	uint8_t* gpr_bank;  // note: active registers bank, aliasing its memory at [0xFFEE0; 0xFFF00).
+	rl78core_cpu_engine_e engine;
+	bool_t code_written;  // note: set by the code write hook, to leave the running block.
+	uint8_t flags_op;     // note: one of rl78core_cpu_flags_op_e, pending to be written into the psw.
+	uint8_t flags_left;
+	uint8_t flags_right;
+	uint8_t flags_result;
+	rl78core_cpu_instruction_s decode_cache[rl78core_cpu_decode_cache_capacity];  // note: direct-mapped by pc.
+	rl78core_cpu_block_s block_cache[rl78core_cpu_block_cache_capacity];  // note: direct-mapped by pc hash.
+};
+
+// note: the jit records the alu operations into the flags fields as a whole.
+_Static_assert(offsetof(rl78core_cpu_s, flags_result) == (offsetof(rl78core_cpu_s, flags_op) + 3), "the flags fields must be consecutive.");
+
+#define rl78core_cpu_opcode(_handler, _operand, _length)                       \
+	{ rl78core_cpu_handler_ ## _handler, _operand, _length }
+
+#define rl78core_cpu_opcode_gpr08(_base, _handler, _gpr08, _length)            \
+	[(_base) + (_gpr08)] = rl78core_cpu_opcode(_handler, _gpr08, _length)
+
+#define rl78core_cpu_opcode_gpr08s(_base, _handler, _length)                   \
+	rl78core_cpu_opcode_gpr08(_base, _handler, rl78core_gpr08_x, _length),     \
+	rl78core_cpu_opcode_gpr08(_base, _handler, rl78core_gpr08_a, _length),     \
+	rl78core_cpu_opcode_gpr08(_base, _handler, rl78core_gpr08_c, _length),     \
+	rl78core_cpu_opcode_gpr08(_base, _handler, rl78core_gpr08_b, _length),     \
+	rl78core_cpu_opcode_gpr08(_base, _handler, rl78core_gpr08_e, _length),     \
+	rl78core_cpu_opcode_gpr08(_base, _handler, rl78core_gpr08_d, _length),     \
+	rl78core_cpu_opcode_gpr08(_base, _handler, rl78core_gpr08_l, _length),     \
+	rl78core_cpu_opcode_gpr08(_base, _handler, rl78core_gpr08_h, _length)
+
+#define rl78core_cpu_opcode_bits(_base, _handler, _length)                     \
+	[(_base) + 0x00] = rl78core_cpu_opcode(_handler, 0, _length),              \
+	[(_base) + 0x10] = rl78core_cpu_opcode(_handler, 1, _length),              \
+	[(_base) + 0x20] = rl78core_cpu_opcode(_handler, 2, _length),              \
+	[(_base) + 0x30] = rl78core_cpu_opcode(_handler, 3, _length),              \
+	[(_base) + 0x40] = rl78core_cpu_opcode(_handler, 4, _length),              \
+	[(_base) + 0x50] = rl78core_cpu_opcode(_handler, 5, _length),              \
+	[(_base) + 0x60] = rl78core_cpu_opcode(_handler, 6, _length),              \
+	[(_base) + 0x70] = rl78core_cpu_opcode(_handler, 7, _length)
+
+typedef enum
+{
+	rl78core_cpu_map_1st = 0x00,  // note: unprefixed opcodes.
+	rl78core_cpu_map_2nd = 0x01,  // note: opcodes prefixed with 0x61.
+	rl78core_cpu_map_3rd = 0x02,  // note: opcodes prefixed with 0x71.
+	rl78core_cpu_map_4th = 0x03,  // note: opcodes prefixed with 0x31.
+	rl78core_cpu_map_5th = 0x04,  // note: opcodes prefixed with 0x11, the ES register prefix.
+	rl78core_cpu_maps_count,
+} rl78core_cpu_map_e;
+
+static const rl78core_cpu_opcode_s g_rl78core_cpu_map_1st[0x100] =
+{
+	[0x00] = rl78core_cpu_opcode(nop, 0, 1),
+	[0x0C] = rl78core_cpu_opcode(add_a_imm, 0, 2),
+	[0x11] = rl78core_cpu_opcode(prefix, rl78core_cpu_map_5th, 1),
+	[0x2C] = rl78core_cpu_opcode(sub_a_imm, 0, 2),
+	[0x30] = rl78core_cpu_opcode(movw_rp_imm, rl78core_gpr16_ax, 3),
+	[0x31] = rl78core_cpu_opcode(prefix, rl78core_cpu_map_4th, 1),
+	[0x32] = rl78core_cpu_opcode(movw_rp_imm, rl78core_gpr16_bc, 3),
+	[0x34] = rl78core_cpu_opcode(movw_rp_imm, rl78core_gpr16_de, 3),
+	[0x36] = rl78core_cpu_opcode(movw_rp_imm, rl78core_gpr16_hl, 3),
+	[0x4C] = rl78core_cpu_opcode(cmp_a_imm, 0, 2),
+	rl78core_cpu_opcode_gpr08s(0x50, mov_r_imm, 2),
+	[0x5C] = rl78core_cpu_opcode(and_a_imm, 0, 2),
+	[0x60] = rl78core_cpu_opcode(mov_a_r, rl78core_gpr08_x, 1),
+	[0x61] = rl78core_cpu_opcode(prefix, rl78core_cpu_map_2nd, 1),
+	[0x62] = rl78core_cpu_opcode(mov_a_r, rl78core_gpr08_c, 1),
+	[0x63] = rl78core_cpu_opcode(mov_a_r, rl78core_gpr08_b, 1),
+	[0x64] = rl78core_cpu_opcode(mov_a_r, rl78core_gpr08_e, 1),
+	[0x65] = rl78core_cpu_opcode(mov_a_r, rl78core_gpr08_d, 1),
+	[0x66] = rl78core_cpu_opcode(mov_a_r, rl78core_gpr08_l, 1),
+	[0x67] = rl78core_cpu_opcode(mov_a_r, rl78core_gpr08_h, 1),
+	[0x6C] = rl78core_cpu_opcode(or_a_imm, 0, 2),
+	[0x70] = rl78core_cpu_opcode(mov_r_a, rl78core_gpr08_x, 1),
+	[0x71] = rl78core_cpu_opcode(prefix, rl78core_cpu_map_3rd, 1),
+	[0x72] = rl78core_cpu_opcode(mov_r_a, rl78core_gpr08_c, 1),
+	[0x73] = rl78core_cpu_opcode(mov_r_a, rl78core_gpr08_b, 1),
+	[0x74] = rl78core_cpu_opcode(mov_r_a, rl78core_gpr08_e, 1),
+	[0x75] = rl78core_cpu_opcode(mov_r_a, rl78core_gpr08_d, 1),
+	[0x76] = rl78core_cpu_opcode(mov_r_a, rl78core_gpr08_l, 1),
+	[0x77] = rl78core_cpu_opcode(mov_r_a, rl78core_gpr08_h, 1),
+	[0x7C] = rl78core_cpu_opcode(xor_a_imm, 0, 2),
+	rl78core_cpu_opcode_gpr08s(0x80, inc_r, 1),
+	[0x8D] = rl78core_cpu_opcode(mov_a_saddr, 0, 2),
+	[0x8E] = rl78core_cpu_opcode(mov_a_sfr, 0, 2),
+	[0x8F] = rl78core_cpu_opcode(mov_a_addr16, 0, 3),
+	rl78core_cpu_opcode_gpr08s(0x90, dec_r, 1),
+	[0x9D] = rl78core_cpu_opcode(mov_saddr_a, 0, 2),
+	[0x9E] = rl78core_cpu_opcode(mov_sfr_a, 0, 2),
+	[0x9F] = rl78core_cpu_opcode(mov_addr16_a, 0, 3),
+	[0xC0] = rl78core_cpu_opcode(pop_rp, rl78core_gpr16_ax, 1),
+	[0xC1] = rl78core_cpu_opcode(push_rp, rl78core_gpr16_ax, 1),
+	[0xC2] = rl78core_cpu_opcode(pop_rp, rl78core_gpr16_bc, 1),
+	[0xC3] = rl78core_cpu_opcode(push_rp, rl78core_gpr16_bc, 1),
+	[0xC4] = rl78core_cpu_opcode(pop_rp, rl78core_gpr16_de, 1),
+	[0xC5] = rl78core_cpu_opcode(push_rp, rl78core_gpr16_de, 1),
+	[0xC6] = rl78core_cpu_opcode(pop_rp, rl78core_gpr16_hl, 1),
+	[0xC7] = rl78core_cpu_opcode(push_rp, rl78core_gpr16_hl, 1),
+	[0xCB] = rl78core_cpu_opcode(movw_sfrp_imm, 0, 4),
+	[0xCD] = rl78core_cpu_opcode(mov_saddr_imm, 0, 3),
+	[0xCE] = rl78core_cpu_opcode(mov_sfr_imm, 0, 3),
+	[0xCF] = rl78core_cpu_opcode(mov_addr16_imm, 0, 4),
+	[0xD7] = rl78core_cpu_opcode(ret, 0, 1),
+	[0xDC] = rl78core_cpu_opcode(bcond, rl78core_condition_c, 2),
+	[0xDD] = rl78core_cpu_opcode(bcond, rl78core_condition_z, 2),
+	[0xDE] = rl78core_cpu_opcode(bcond, rl78core_condition_nc, 2),
+	[0xDF] = rl78core_cpu_opcode(bcond, rl78core_condition_nz, 2),
+	[0xEC] = rl78core_cpu_opcode(br_abs20, 0, 4),
+	[0xED] = rl78core_cpu_opcode(br_abs16, 0, 3),
+	[0xEF] = rl78core_cpu_opcode(br_rel8, 0, 2),
+	[0xFD] = rl78core_cpu_opcode(call_abs16, 0, 3),
+};
+
+static const rl78core_cpu_opcode_s g_rl78core_cpu_map_2nd[0x100] =
+{
+	[0xCD] = rl78core_cpu_opcode(pop_psw, 0, 2),
+	[0xCF] = rl78core_cpu_opcode(sel_rb, 0, 2),
+	[0xDD] = rl78core_cpu_opcode(push_psw, 0, 2),
+	[0xDF] = rl78core_cpu_opcode(sel_rb, 1, 2),
+	[0xED] = rl78core_cpu_opcode(halt, 0, 2),
+	[0xEF] = rl78core_cpu_opcode(sel_rb, 2, 2),
+	[0xFC] = rl78core_cpu_opcode(reti, 0, 2),
+	[0xFD] = rl78core_cpu_opcode(stop, 0, 2),
+	[0xFF] = rl78core_cpu_opcode(sel_rb, 3, 2),
+};
+
+static const rl78core_cpu_opcode_s g_rl78core_cpu_map_3rd[0x100] =
+{
+	rl78core_cpu_opcode_bits(0x0A, set1_sfr_bit, 3),
+	rl78core_cpu_opcode_bits(0x0B, clr1_sfr_bit, 3),
+	[0x80] = rl78core_cpu_opcode(set1_cy, 0, 2),
+	[0x88] = rl78core_cpu_opcode(clr1_cy, 0, 2),
+};
+
+// note: the bit test and shift instructions are not decoded, so all the entries
+// of the 4th map decode into `illegal`.
+static const rl78core_cpu_opcode_s g_rl78core_cpu_map_4th[0x100] = {0};
+
+// note: only the !addr16 operands of the moves take the ES register prefix.
+static const rl78core_cpu_opcode_s g_rl78core_cpu_map_5th[0x100] =
+{
+	[0x8F] = rl78core_cpu_opcode(mov_a_es_addr16, 0, 4),
+	[0x9F] = rl78core_cpu_opcode(mov_es_addr16_a, 0, 4),
+	[0xCF] = rl78core_cpu_opcode(mov_es_addr16_imm, 0, 5),
+};
+
+static const rl78core_cpu_opcode_s* const g_rl78core_cpu_maps[rl78core_cpu_maps_count] =
+{
+	[rl78core_cpu_map_1st] = g_rl78core_cpu_map_1st,
+	[rl78core_cpu_map_2nd] = g_rl78core_cpu_map_2nd,
+	[rl78core_cpu_map_3rd] = g_rl78core_cpu_map_3rd,
+	[rl78core_cpu_map_4th] = g_rl78core_cpu_map_4th,
+	[rl78core_cpu_map_5th] = g_rl78core_cpu_map_5th,
+};
+
+#define rl78core_cpu_handler_prototype(_name, _cycles)                         \
+	static inline void execute_ ## _name(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction);
+
+rl78core_cpu_handlers(rl78core_cpu_handler_prototype)
+
+#undef rl78core_cpu_handler_prototype
 
-static rl78core_cpu_s g_rl78core_cpu;
+#define rl78core_cpu_handler_pointer(_name, _cycles) [rl78core_cpu_handler_ ## _name] = &execute_ ## _name,
+
+static void(* const g_rl78core_cpu_handlers[rl78core_cpu_handlers_count])(rl78core_cpu_s* const, const rl78core_cpu_instruction_s* const) =
+{
+	rl78core_cpu_handlers(rl78core_cpu_handler_pointer)
+};
+
+#undef rl78core_cpu_handler_pointer
 
 /**
  * @brief Convert short direct address in the range of [0xFFE20; 0xFFF20) into
@@ -66,22 +431,30 @@ uint20_t special_function_register_to_absolute_address(const uint8_t address);
  * @brief Convert general purpose register in the range of [0xFFEE0; 0xFFF00)
  * into an absolute address in range of [0x00000; 0x100000).
  * 
- * @param offset general purpose register offset in registers bank
+ * @note The registers bank 0 is at [0xFFEF8; 0xFFF00) and the registers bank 3
+ * is at [0xFFEE0; 0xFFEE8).
+ * 
+ * @param machine machine to read the psw register of
+ * @param offset  general purpose register offset in registers bank
  * 
  * @return uint20_t absolute address
  */
-uint20_t general_purpose_register_to_absolute_address(const uint8_t offset);
+uint20_t general_purpose_register_to_absolute_address(rl78core_machine_s* const machine, const uint8_t offset);
 
 /**
- * @brief Convert direct address in the range of [0x00000; 0x100000) into an
- * absolute address in range of [0x00000; 0x100000).
+ * @brief Convert direct address in the 64 KiB segment selected by the ES
+ * register into an absolute address in range of [0x00000; 0x100000).
  * 
+ * @note Without the ES register prefix, the !addr16 operands address the last
+ * segment, at [0xF0000; 0x100000).
+ * 
+ * @param segment      lower 4 bits of the ES register, or 0x0F without its prefix
  * @param address_low  lower 8 bits of the direct address
  * @param address_high higher 8 bits of the direct address
  * 
  * @return uint20_t absolute address
  */
-uint20_t direct_address_to_absolute_address(const uint8_t address_low, const uint8_t address_high);
+uint20_t direct_address_to_absolute_address(const uint8_t segment, const uint8_t address_low, const uint8_t address_high);
 
 // todo: register indirect addressing [0x00000; 0x100000) } 1Mb
 uint20_t indirect_register_address_to_absolute_address(const uint20_t address);
@@ -92,318 +465,785 @@ uint20_t based_address_to_absolute_address(const uint20_t address);
 // todo: based indexed addressing [0x00000; 0x100000) } 1Mb
 uint20_t based_indexed_address_to_absolute_address(const uint20_t address);
 
+/**
+ * @brief Check if a data read of a provided address takes the wait cycles of
+ * the code flash.
+ * 
+ * @param address absolute address of the read
+ * 
+ * @return bool_t
+ */
+static inline bool_t is_flash_read(const uint20_t address);
+
 /**
  * @brief Fetch instruction byte from the flash at pc register address.
  * 
  * @warning The pc register is incremented by one after the fetch.
  * 
+ * @param cpu cpu to fetch with
+ * 
  * @return uint8_t fetched byte
  */
-static uint8_t fetch_instruction_byte(void);
+static uint8_t fetch_instruction_byte(rl78core_cpu_s* const cpu);
 
-void rl78core_cpu_init(void)
+/**
+ * @brief Decode the instruction at pc register address by walking the opcode
+ * maps, and fetch all of its operand bytes.
+ * 
+ * @warning The pc register is advanced past the decoded instruction.
+ * 
+ * @param cpu         cpu to decode with
+ * @param instruction instruction to decode into
+ */
+static inline void decode_instruction(rl78core_cpu_s* const cpu, rl78core_cpu_instruction_s* const instruction);
+
+/**
+ * @brief Fetch the instruction at pc register address from the decode cache,
+ * decoding and caching it on a miss.
+ * 
+ * @warning The pc register is advanced past the fetched instruction.
+ * 
+ * @param cpu cpu to fetch with
+ * 
+ * @return const rl78core_cpu_instruction_s* fetched instruction
+ */
+static inline const rl78core_cpu_instruction_s* fetch_instruction(rl78core_cpu_s* const cpu);
+
+/**
+ * @brief Process provided count of ticks with the interpreter engine, or less
+ * if the cpu gets halted or an interrupt gets requested before.
+ * 
+ * @param cpu   cpu to process the ticks with
+ * @param count count of ticks to process
+ * 
+ * @return uint64_t count of processed ticks
+ */
+static uint64_t execute_interp(rl78core_cpu_s* const cpu, const uint64_t count);
+
+/**
+ * @brief Process provided count of ticks with the block engine, or less if the
+ * cpu gets halted or an interrupt gets requested before. The requests are
+ * noticed at the boundaries of the blocks.
+ * 
+ * @param cpu   cpu to process the ticks with
+ * @param count count of ticks to process
+ * @param jit   whether to compile and run the hot blocks with the jit
+ * 
+ * @return uint64_t count of processed ticks
+ */
+static uint64_t execute_block(rl78core_cpu_s* const cpu, const uint64_t count, const bool_t jit);
+
+/**
+ * @brief Check if there is a breakpoint at a provided address.
+ * 
+ * @param cpu     cpu to check the breakpoints of
+ * @param address address to check
+ * 
+ * @return bool_t
+ */
+static bool_t has_breakpoint(rl78core_cpu_s* const cpu, const uint20_t address);
+
+/**
+ * @brief Check if the instruction handled by a provided handler ends a block.
+ * 
+ * @param handler handler of the instruction
+ * 
+ * @return bool_t
+ */
+static inline bool_t ends_block(const uint8_t handler);
+
+/**
+ * @brief Look up the block starting at a provided address in the block cache,
+ * translating and caching it on a miss.
+ * 
+ * @param cpu     cpu to look the block up in
+ * @param address address of the first instruction of the block
+ * 
+ * @return rl78core_cpu_block_s* block, or NULL if the code at the address can
+ * not be translated
+ */
+static rl78core_cpu_block_s* lookup_block(rl78core_cpu_s* const cpu, const uint20_t address);
+
+/**
+ * @brief Compile a provided block with the jit.
+ * 
+ * @note If the jit arena is full, all the compiled blocks are discarded and the
+ * block is compiled into the emptied arena.
+ * 
+ * @param cpu   cpu to compile the block of
+ * @param block block to compile
+ */
+static void compile_block(rl78core_cpu_s* const cpu, rl78core_cpu_block_s* const block);
+
+/**
+ * @brief Emit the host code of a provided instruction with the jit.
+ * 
+ * @note The register moves, the 8-bit alu operations of the A register with
+ * immediate values, and the increments and decrements of the 8-bit registers
+ * are emitted natively. All the other instructions are emitted as calls to
+ * their handlers.
+ * 
+ * @param cpu         cpu to emit the instruction of
+ * @param instruction instruction to emit
+ * @param index       index of the instruction in its block
+ * @param cycles      cycles of the instructions, which are not yet added to the
+ *                    cycles counter by the emitted code
+ * 
+ * @return bool_t true if the instruction was emitted natively, and the pc
+ * register was not updated by it
+ */
+static bool_t emit_instruction(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction, const uint8_t index, uint32_t* const cycles);
+
+/**
+ * @brief Emit the host code of an 8-bit alu operation with the jit, which
+ * defers its flags like @ref defer_flags does.
+ * 
+ * @param cpu   cpu to emit the operation of
+ * @param alu   alu operation to emit
+ * @param gpr08 offset of the 8-bit general purpose register in a bank
+ * @param value immediate value of the operation
+ * @param store whether to store the result into the register
+ * @param op    flags operation, one of rl78core_cpu_flags_op_e
+ */
+static void emit_alu(rl78core_cpu_s* const cpu, const rl78core_jit_alu_e alu, const uint8_t gpr08, const uint8_t value, const bool_t store, const uint8_t op);
+
+/**
+ * @brief Invalidate all the cached instructions and blocks which overlap the
+ * provided page.
+ * 
+ * @note It is the memory code write hook of the cpu.
+ * 
+ * @param machine machine whose memory was written to
+ * @param page    index of the page
+ */
+static void invalidate_code_page(rl78core_machine_s* const machine, const uint20_t page);
+
+/**
+ * @brief Read the 8-bit value of provided general purpose register in the
+ * active registers bank.
+ * 
+ * @param cpu   cpu to read the register of
+ * @param gpr08 offset of a 8-bit general purpose register in a bank
+ * 
+ * @return uint8_t value of the provided register
+ */
+static inline uint8_t read_gpr08(rl78core_cpu_s* const cpu, const uint8_t gpr08);
+
+/**
+ * @brief Write the 8-bit value to provided general purpose register in the
+ * active registers bank.
+ * 
+ * @param cpu   cpu to write the register of
+ * @param gpr08 offset of a 8-bit general purpose register in a bank
+ * @param value value to write to the provided register
+ */
+static inline void write_gpr08(rl78core_cpu_s* const cpu, const uint8_t gpr08, const uint8_t value);
+
+/**
+ * @brief Read the 16-bit value of provided general purpose register in the
+ * active registers bank.
+ * 
+ * @param cpu   cpu to read the register of
+ * @param gpr16 offset of a 16-bit general purpose register in a bank
+ * 
+ * @return uint16_t value of the provided register
+ */
+static inline uint16_t read_gpr16(rl78core_cpu_s* const cpu, const uint8_t gpr16);
+
+/**
+ * @brief Write the 16-bit value to provided general purpose register in the
+ * active registers bank.
+ * 
+ * @param cpu   cpu to write the register of
+ * @param gpr16 offset of a 16-bit general purpose register in a bank
+ * @param value value to write to the provided register
+ */
+static inline void write_gpr16(rl78core_cpu_s* const cpu, const uint8_t gpr16, const uint16_t value);
+
+/**
+ * @brief Point the cached registers bank at the bank selected by the RBS0 and
+ * RBS1 flags of the psw register.
+ * 
+ * @warning It must be called after every write that may modify the psw.
+ * 
+ * @param cpu cpu to sync the registers bank of
+ */
+static inline void sync_gpr_bank(rl78core_cpu_s* const cpu);
+
+/**
+ * @brief Set the interrupt flag of the cpu, if any requested interrupt can be
+ * acknowledged at the IE and ISP flags of the psw register.
+ * 
+ * @warning It must be called after every write that may modify the psw, and
+ * after every change of the requests.
+ * 
+ * @param cpu cpu to sync the interrupt flag of
+ */
+static void sync_interrupt(rl78core_cpu_s* const cpu);
+
+/**
+ * @brief Read 8-bit data value from a provided address in the memory.
+ * 
+ * @note Unlike @ref rl78core_mem_read_u08, it writes the pending flags into the
+ * psw register before it gets read.
+ * 
+ * @param cpu     cpu to read with
+ * @param address address to read value from
+ * 
+ * @return uint8_t read value
+ */
+static inline uint8_t read_data_u08(rl78core_cpu_s* const cpu, const uint20_t address);
+
+/**
+ * @brief Write 8-bit data value into a provided address in the memory.
+ * 
+ * @note Unlike @ref rl78core_mem_write_u08, it keeps the cached registers bank
+ * in sync with the psw register.
+ * 
+ * @param cpu     cpu to write with
+ * @param address address to write value at
+ * @param value   value to write
+ */
+static inline void write_data_u08(rl78core_cpu_s* const cpu, const uint20_t address, const uint8_t value);
+
+/**
+ * @brief Write 16-bit data value into a provided address in the memory.
+ * 
+ * @note Unlike @ref rl78core_mem_write_u16, it keeps the cached registers bank
+ * in sync with the psw register.
+ * 
+ * @param cpu     cpu to write with
+ * @param address address to write value at
+ * @param value   value to write
+ */
+static inline void write_data_u16(rl78core_cpu_s* const cpu, const uint20_t address, const uint16_t value);
+
+/**
+ * @brief Record a flags updating operation, to evaluate its flags lazily.
+ * 
+ * @param cpu    cpu to record the operation in
+ * @param op     operation, one of rl78core_cpu_flags_op_e
+ * @param left   left operand of the operation
+ * @param right  right operand of the operation
+ * @param result result of the operation
+ */
+static inline void defer_flags(rl78core_cpu_s* const cpu, const uint8_t op, const uint8_t left, const uint8_t right, const uint8_t result);
+
+/**
+ * @brief Evaluate the flags of the pending operation, and write them into the
+ * psw register.
+ * 
+ * @param cpu cpu to write the flags of
+ */
+static inline void flush_flags(rl78core_cpu_s* const cpu);
+
+/**
+ * @brief Update the provided flags of the psw register.
+ * 
+ * @param cpu   cpu to update the flags of
+ * @param mask  mask of the flags to update
+ * @param flags new values of the flags
+ */
+static void write_flags(rl78core_cpu_s* const cpu, const uint8_t mask, const uint8_t flags);
+
+/**
+ * @brief Push 8-bit value onto the stack.
+ * 
+ * @param cpu   cpu to push with
+ * @param value value to push
+ */
+static void push_u08(rl78core_cpu_s* const cpu, const uint8_t value);
+
+/**
+ * @brief Pop 8-bit value from the stack.
+ * 
+ * @param cpu cpu to pop with
+ * 
+ * @return uint8_t popped value
+ */
+static uint8_t pop_u08(rl78core_cpu_s* const cpu);
+
+/**
+ * @brief Handle the requested interrupts at an instruction boundary. The cpu is
+ * woken up from its standby mode, and if the interrupts are enabled, the
+ * selected interrupt is acknowledged: the psw and pc registers are pushed onto
+ * the stack, the interrupts get disabled, the isp flags take the priority level
+ * of the interrupt, and the pc register takes its vector.
+ * 
+ * @param cpu cpu to handle the interrupts of
+ */
+static void handle_interrupt(rl78core_cpu_s* const cpu);
+
+rl78core_cpu_s* rl78core_cpu_create(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78core_cpu_s* const cpu = (rl78core_cpu_s*)rl78misc_malloc(sizeof(rl78core_cpu_s));
+	cpu->machine = machine;
+	cpu->jit = rl78core_jit_create();
+	return cpu;
+}
+
+void rl78core_cpu_destroy(rl78core_cpu_s* const cpu)
 {
-	g_rl78core_cpu = (rl78core_cpu_s)
+	rl78misc_debug_assert(cpu != NULL);
+	rl78core_jit_destroy(cpu->jit);
+	(void)rl78misc_free(cpu);
+}
+
+void rl78core_cpu_init_r(rl78core_machine_s* const machine)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	cpu->halted = false;
+	cpu->standby = rl78core_cpu_standby_none;
+	cpu->requested = false;
+	cpu->interrupt = false;
+	cpu->leave = false;
+	cpu->pc = 0x00000;
+	cpu->cycles = 0;
+	cpu->deadline = rl78core_cpu_no_deadline;
+	cpu->breakpoints_count = 0;
+	cpu->gpr_bank = NULL;
+	cpu->engine = rl78core_cpu_engine_interp;
+	cpu->code_written = false;
+	cpu->flags_op = rl78core_cpu_flags_op_none;
+	cpu->flags_left = 0;
+	cpu->flags_right = 0;
+	cpu->flags_result = 0;
+	rl78misc_memset(cpu->decode_cache, 0xFF, sizeof(cpu->decode_cache));
+
+	for (uint32_t index = 0; index < rl78core_cpu_block_cache_capacity; ++index)
 	{
-		.halted = false,
-		.pc = 0x00000,
-	};
+		rl78core_cpu_block_s* const block = &cpu->block_cache[index];
+		block->address = rl78core_cpu_decode_cache_invalid;
+		block->successors[0] = NULL;
+		block->successors[1] = NULL;
+		block->hits = 0;
+		block->jit_code = NULL;
+	}
+
+	rl78core_jit_reset(cpu->jit);
+	rl78core_mem_set_code_write_hook_r(cpu->machine, invalidate_code_page);
+
+	// note: the isp flags are reset to the lowest priority level, so that the
+	// interrupts of all the levels get acknowledged.
+	rl78core_mem_write_u08_r(machine, rl78core_fixed_sfr_psw, rl78core_psw_flag_isp0 | rl78core_psw_flag_isp1);
+
+	// note: the ES register is reset to the last segment, which the !addr16
+	// operands address without its prefix.
+	rl78core_mem_write_u08_r(machine, rl78core_fixed_sfr_es, 0x0F);
+	sync_gpr_bank(cpu);
 }
 
-uint20_t rl78core_cpu_read_pc(void)
+uint20_t rl78core_cpu_read_pc_r(rl78core_machine_s* const machine)
 {
-	return g_rl78core_cpu.pc;
+	rl78core_cpu_s* const cpu = machine->cpu;
+	return cpu->pc;
 }
 
-void rl78core_cpu_write_pc(const uint20_t value)
+void rl78core_cpu_write_pc_r(rl78core_machine_s* const machine, const uint20_t value)
 {
-	g_rl78core_cpu.pc = value;
+	rl78core_cpu_s* const cpu = machine->cpu;
+	cpu->pc = value;
 }
 
-uint8_t rl78core_cpu_read_gpr08(const uint8_t gpr08)
+uint8_t rl78core_cpu_read_gpr08_r(rl78core_machine_s* const machine, const uint8_t gpr08)
 {
-	rl78misc_debug_assert(gpr08 < rl78core_gpr08s_count);
-	const uint20_t address = general_purpose_register_to_absolute_address(gpr08);
-	return rl78core_mem_read_u08(address);
+	return read_gpr08(machine->cpu, gpr08);
 }
 
-void rl78core_cpu_write_gpr08(const uint8_t gpr08, const uint8_t value)
+void rl78core_cpu_write_gpr08_r(rl78core_machine_s* const machine, const uint8_t gpr08, const uint8_t value)
 {
-	rl78misc_debug_assert(gpr08 < rl78core_gpr08s_count);
-	const uint20_t address = general_purpose_register_to_absolute_address(gpr08);
-	rl78core_mem_write_u08(address, value);
-	// todo: handle flags if needed!
+	write_gpr08(machine->cpu, gpr08, value);
 }
 
-uint16_t rl78core_cpu_read_gpr16(const uint8_t gpr16)
+uint16_t rl78core_cpu_read_gpr16_r(rl78core_machine_s* const machine, const uint8_t gpr16)
 {
-	rl78misc_debug_assert(0 == (gpr16 % 2));
-	rl78misc_debug_assert(gpr16 < rl78core_gpr16s_count);
-	const uint20_t address = general_purpose_register_to_absolute_address(gpr16);
-	return rl78core_mem_read_u16(address);
+	return read_gpr16(machine->cpu, gpr16);
 }
 
-void rl78core_cpu_write_gpr16(const uint8_t gpr16, const uint16_t value)
+void rl78core_cpu_write_gpr16_r(rl78core_machine_s* const machine, const uint8_t gpr16, const uint16_t value)
 {
-	rl78misc_debug_assert(0 == (gpr16 % 2));
-	rl78misc_debug_assert(gpr16 < rl78core_gpr16s_count);
-	const uint20_t address = general_purpose_register_to_absolute_address(gpr16);
-	rl78core_mem_write_u16(address, value);
-	// todo: handle flags if needed!
+	write_gpr16(machine->cpu, gpr16, value);
 }
 
-void rl78core_cpu_halt(void)
+void rl78core_cpu_halt_r(rl78core_machine_s* const machine)
 {
-	g_rl78core_cpu.halted = true;
+	rl78core_cpu_s* const cpu = machine->cpu;
+
+	// note: the halted cpu leaves the stop mode, so the frozen timer array
+	// units count again.
+	if (rl78core_cpu_standby_stop == cpu->standby)
+	{
+		rl78core_tau_resume_r(machine);
+	}
+
+	cpu->halted = true;
+	cpu->standby = rl78core_cpu_standby_none;
+	cpu->leave = true;
 }
 
-bool_t rl78core_cpu_halted(void)
+bool_t rl78core_cpu_halted_r(rl78core_machine_s* const machine)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	return cpu->halted;
+}
+
+rl78core_cpu_standby_e rl78core_cpu_get_standby_r(rl78core_machine_s* const machine)
 {
-	return g_rl78core_cpu.halted;
+	rl78core_cpu_s* const cpu = machine->cpu;
+	return cpu->standby;
 }
 
-void rl78core_cpu_tick(void)
+bool_t rl78core_cpu_wake_r(rl78core_machine_s* const machine)
 {
-	if (rl78core_cpu_halted())
+	rl78core_cpu_s* const cpu = machine->cpu;
+	if (rl78core_cpu_standby_none == cpu->standby)
 	{
-		return;
+		return false;
 	}
 
-	switch (fetch_instruction_byte())
+	if (rl78core_cpu_standby_stop == cpu->standby)
 	{
-		case 0x50:  // MOV X, #byte
-		{
-			const uint8_t data = fetch_instruction_byte();
-			rl78core_cpu_write_gpr08(rl78core_gpr08_x, data);
-		} break;
+		rl78core_tau_resume_r(machine);
+	}
 
-		case 0x51:  // MOV A, #byte
-		{
-			const uint8_t data = fetch_instruction_byte();
-			rl78core_cpu_write_gpr08(rl78core_gpr08_a, data);
-		} break;
+	cpu->halted = false;
+	cpu->standby = rl78core_cpu_standby_none;
+	cpu->leave = cpu->interrupt;
+	return true;
+}
 
-		case 0x52:  // MOV C, #byte
-		{
-			const uint8_t data = fetch_instruction_byte();
-			rl78core_cpu_write_gpr08(rl78core_gpr08_c, data);
-		} break;
+void rl78core_cpu_set_interrupt_r(rl78core_machine_s* const machine, const bool_t requested)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	cpu->requested = requested;
+	sync_interrupt(cpu);
+}
 
-		case 0x53:  // MOV B, #byte
-		{
-			const uint8_t data = fetch_instruction_byte();
-			rl78core_cpu_write_gpr08(rl78core_gpr08_b, data);
-		} break;
+void rl78core_cpu_set_engine_r(rl78core_machine_s* const machine, const rl78core_cpu_engine_e engine)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	rl78misc_debug_assert(engine < rl78core_cpu_engines_count);
+	cpu->engine = engine;
+}
 
-		case 0x54:  // MOV E, #byte
-		{
-			const uint8_t data = fetch_instruction_byte();
-			rl78core_cpu_write_gpr08(rl78core_gpr08_e, data);
-		} break;
+rl78core_cpu_engine_e rl78core_cpu_get_engine_r(rl78core_machine_s* const machine)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	return cpu->engine;
+}
 
-		case 0x55:  // MOV D, #byte
-		{
-			const uint8_t data = fetch_instruction_byte();
-			rl78core_cpu_write_gpr08(rl78core_gpr08_d, data);
-		} break;
+uint32_t rl78core_cpu_tick_r(rl78core_machine_s* const machine)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	if (cpu->interrupt || (cpu->halted && cpu->requested))
+	{
+		handle_interrupt(cpu);
+	}
 
-		case 0x56:  // MOV L, #byte
-		{
-			const uint8_t data = fetch_instruction_byte();
-			rl78core_cpu_write_gpr08(rl78core_gpr08_l, data);
-		} break;
+	if (cpu->halted)
+	{
+		return 0;
+	}
 
-		case 0x57:  // MOV H, #byte
-		{
-			const uint8_t data = fetch_instruction_byte();
-			rl78core_cpu_write_gpr08(rl78core_gpr08_h, data);
-		} break;
+	const uint64_t cycles = cpu->cycles;
+	const rl78core_cpu_instruction_s* const instruction = fetch_instruction(cpu);
+	cpu->cycles += instruction->cycles;
+	g_rl78core_cpu_handlers[instruction->handler](cpu, instruction);
+	flush_flags(cpu);
+	return (uint32_t)(cpu->cycles - cycles);
+}
 
-#if 0
-		case 0xCD:  // MOV saddr, #byte
-		{
-			const uint8_t saddr = fetch_instruction_byte();
-			const uint8_t data = fetch_instruction_byte();
-			const uint20_t absolute_address = short_direct_address_to_absolute_address(saddr);
-			rl78core_mem_write_u08(absolute_address, data);
-			// todo: handle flags if needed!
-		} break;
+uint64_t rl78core_cpu_cycles_r(rl78core_machine_s* const machine)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	return cpu->cycles;
+}
 
-		case 0xCE:  // MOV sfr, #byte
-		{
-			const uint8_t sfr = fetch_instruction_byte();
-			const uint8_t data = fetch_instruction_byte();
-			const uint20_t absolute_address = special_function_register_to_absolute_address(sfr);
-			rl78core_mem_write_u08(absolute_address, data);
-			// todo: handle flags if needed!
-		} break;
+uint64_t rl78core_cpu_execute_r(rl78core_machine_s* const machine, const uint64_t count)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	uint64_t processed = 0;
 
-		case 0xCF:  // MOV !addr16, #byte
+	// note: the engines leave at the next boundary while an interrupt is
+	// requested, so the requests are handled between the instructions.
+	do
+	{
+		if (cpu->interrupt || (cpu->halted && cpu->requested))
 		{
-			const uint8_t addrl = fetch_instruction_byte();
-			const uint8_t addrh = fetch_instruction_byte();
-			const uint8_t data = fetch_instruction_byte();
-			const uint20_t absolute_address = direct_address_to_absolute_address(addrl, addrh);
-			rl78core_mem_write_u08(absolute_address, data);
-			// todo: handle flags if needed!
-		} break;
+			handle_interrupt(cpu);
+		}
 
-		case 0x60:  // MOV A, X
-		{
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint20_t absolute_address_x = general_purpose_register_to_absolute_address(rl78core_gpr08_x);
-			const uint8_t x_value = rl78core_mem_read_u08(absolute_address_x);
-			rl78core_mem_write_u08(absolute_address_a, x_value);
-			// todo: handle flags if needed!
-		} break;
+		cpu->leave = cpu->halted || cpu->interrupt;
 
-		case 0x62:  // MOV A, C
+		switch (cpu->engine)
 		{
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint20_t absolute_address_c = general_purpose_register_to_absolute_address(rl78core_gpr08_c);
-			const uint8_t c_value = rl78core_mem_read_u08(absolute_address_c);
-			rl78core_mem_write_u08(absolute_address_a, c_value);
-			// todo: handle flags if needed!
-		} break;
+			case rl78core_cpu_engine_interp: { processed += execute_interp(cpu, count - processed); } break;
+			case rl78core_cpu_engine_block:  { processed += execute_block(cpu, count - processed, false); } break;
+			case rl78core_cpu_engine_jit:    { processed += execute_block(cpu, count - processed, rl78core_jit_available(cpu->jit)); } break;
+			default: { rl78misc_debug_assert(0); } break;
+		}
+	} while ((processed < count) && cpu->interrupt && !cpu->halted);
+
+	// note: the psw register must be up to date, once observable by the caller.
+	flush_flags(cpu);
+	return processed;
+}
 
-		case 0x63:  // MOV A, B
-		{
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint20_t absolute_address_b = general_purpose_register_to_absolute_address(rl78core_gpr08_b);
-			const uint8_t b_value = rl78core_mem_read_u08(absolute_address_b);
-			rl78core_mem_write_u08(absolute_address_a, b_value);
-			// todo: handle flags if needed!
-		} break;
+rl78core_cpu_stop_e rl78core_cpu_run_r(rl78core_machine_s* const machine, const rl78core_cpu_budget_s budget)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	const uint64_t cycles_limit = (0 == budget.cycles) ? UINT64_MAX : cpu->cycles + budget.cycles;
+	uint64_t instructions = (0 == budget.instructions) ? UINT64_MAX : budget.instructions;
+	bool_t first = true;
 
-		case 0x64:  // MOV A, E
+	while (true)
+	{
+		if (cpu->requested && cpu->halted)
 		{
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint20_t absolute_address_e = general_purpose_register_to_absolute_address(rl78core_gpr08_e);
-			const uint8_t e_value = rl78core_mem_read_u08(absolute_address_e);
-			rl78core_mem_write_u08(absolute_address_a, e_value);
-			// todo: handle flags if needed!
-		} break;
+			handle_interrupt(cpu);
+		}
 
-		case 0x65:  // MOV A, D
+		if (cpu->halted)
 		{
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint20_t absolute_address_d = general_purpose_register_to_absolute_address(rl78core_gpr08_d);
-			const uint8_t d_value = rl78core_mem_read_u08(absolute_address_d);
-			rl78core_mem_write_u08(absolute_address_a, d_value);
-			// todo: handle flags if needed!
-		} break;
-
-		case 0x66:  // MOV A, L
+			if ((rl78core_cpu_standby_none == cpu->standby) || (rl78core_cpu_no_deadline == cpu->deadline))
+			{
+				return rl78core_cpu_stop_halt;
+			}
+
+			// note: nothing runs in the standby modes, so the idle clock cycles are
+			// skipped straight to the deadline, or to the end of the cycles budget.
+			if (cycles_limit < cpu->deadline)
+			{
+				cpu->cycles = (cpu->cycles > cycles_limit) ? cpu->cycles : cycles_limit;
+				return rl78core_cpu_stop_budget;
+			}
+
+			cpu->cycles = (cpu->cycles > cpu->deadline) ? cpu->cycles : cpu->deadline;
+		}
+
+		// note: the due events of the scheduler are dispatched in place, and move
+		// the deadline to the next one. Only a deadline without any due event stops
+		// the run.
+		if ((cpu->cycles >= cpu->deadline) && !rl78core_sched_dispatch_r(machine))
 		{
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint20_t absolute_address_l = general_purpose_register_to_absolute_address(rl78core_gpr08_l);
-			const uint8_t l_value = rl78core_mem_read_u08(absolute_address_l);
-			rl78core_mem_write_u08(absolute_address_a, l_value);
-			// todo: handle flags if needed!
-		} break;
+			return rl78core_cpu_stop_event;
+		}
 
-		case 0x67:  // MOV A, H
+		if ((0 == instructions) || (cpu->cycles >= cycles_limit))
 		{
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint20_t absolute_address_h = general_purpose_register_to_absolute_address(rl78core_gpr08_h);
-			const uint8_t h_value = rl78core_mem_read_u08(absolute_address_h);
-			rl78core_mem_write_u08(absolute_address_a, h_value);
-			// todo: handle flags if needed!
-		} break;
+			return rl78core_cpu_stop_budget;
+		}
 
-		case 0x70:  // MOV X, A
+		if (!first && (cpu->breakpoints_count > 0) && has_breakpoint(cpu, cpu->pc))
 		{
-			const uint20_t absolute_address_x = general_purpose_register_to_absolute_address(rl78core_gpr08_x);
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint8_t a_value = rl78core_mem_read_u08(absolute_address_a);
-			rl78core_mem_write_u08(absolute_address_x, a_value);
-			// todo: handle flags if needed!
-		} break;
+			return rl78core_cpu_stop_breakpoint;
+		}
+
+		// note: every instruction takes at least one and at most the max cycles, so
+		// the slice never exceeds the cycles budget by more than a single instruction.
+		const uint64_t cycles_left = ((cycles_limit < cpu->deadline) ? cycles_limit : cpu->deadline) -
+			cpu->cycles;
+		uint64_t slice = cycles_left / rl78core_cpu_instruction_max_cycles;
+		slice = (slice > instructions) ? instructions : slice;
+		slice = ((0 == slice) || (cpu->breakpoints_count > 0)) ? 1 : slice;
+		instructions -= rl78core_cpu_execute_r(machine, slice);
+		first = false;
+	}
+}
 
-		case 0x72:  // MOV C, A
-		{
-			const uint20_t absolute_address_c = general_purpose_register_to_absolute_address(rl78core_gpr08_c);
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint8_t a_value = rl78core_mem_read_u08(absolute_address_a);
-			rl78core_mem_write_u08(absolute_address_c, a_value);
-			// todo: handle flags if needed!
-		} break;
+bool_t rl78core_cpu_add_breakpoint_r(rl78core_machine_s* const machine, const uint20_t address)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	if (has_breakpoint(cpu, address))
+	{
+		return true;
+	}
 
-		case 0x73:  // MOV B, A
-		{
-			const uint20_t absolute_address_b = general_purpose_register_to_absolute_address(rl78core_gpr08_b);
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint8_t a_value = rl78core_mem_read_u08(absolute_address_a);
-			rl78core_mem_write_u08(absolute_address_b, a_value);
-			// todo: handle flags if needed!
-		} break;
+	if (cpu->breakpoints_count >= rl78core_cpu_breakpoints_capacity)
+	{
+		return false;
+	}
 
-		case 0x74:  // MOV E, A
-		{
-			const uint20_t absolute_address_e = general_purpose_register_to_absolute_address(rl78core_gpr08_e);
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint8_t a_value = rl78core_mem_read_u08(absolute_address_a);
-			rl78core_mem_write_u08(absolute_address_e, a_value);
-			// todo: handle flags if needed!
-		} break;
+	cpu->breakpoints[cpu->breakpoints_count++] = address & 0xFFFFF;
+	return true;
+}
 
-		case 0x75:  // MOV D, A
+bool_t rl78core_cpu_remove_breakpoint_r(rl78core_machine_s* const machine, const uint20_t address)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	for (uint8_t index = 0; index < cpu->breakpoints_count; ++index)
+	{
+		if (cpu->breakpoints[index] == (address & 0xFFFFF))
 		{
-			const uint20_t absolute_address_d = general_purpose_register_to_absolute_address(rl78core_gpr08_d);
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint8_t a_value = rl78core_mem_read_u08(absolute_address_a);
-			rl78core_mem_write_u08(absolute_address_d, a_value);
-			// todo: handle flags if needed!
-		} break;
+			cpu->breakpoints[index] = cpu->breakpoints[--cpu->breakpoints_count];
+			return true;
+		}
+	}
 
-		case 0x76:  // MOV L, A
-		{
-			const uint20_t absolute_address_l = general_purpose_register_to_absolute_address(rl78core_gpr08_l);
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint8_t a_value = rl78core_mem_read_u08(absolute_address_a);
-			rl78core_mem_write_u08(absolute_address_l, a_value);
-			// todo: handle flags if needed!
-		} break;
+	return false;
+}
 
-		case 0x77:  // MOV H, A
-		{
-			const uint20_t absolute_address_h = general_purpose_register_to_absolute_address(rl78core_gpr08_h);
-			const uint20_t absolute_address_a = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint8_t a_value = rl78core_mem_read_u08(absolute_address_a);
-			rl78core_mem_write_u08(absolute_address_h, a_value);
-			// todo: handle flags if needed!
-		} break;
+void rl78core_cpu_set_deadline_r(rl78core_machine_s* const machine, const uint64_t cycles)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
 
-		case 0x8D:  // MOV A, saddr
-		{
-			const uint8_t short_address = fetch_instruction_byte();
-			uint20_t absolute_address = short_direct_address_to_absolute_address(short_address);
-			const uint8_t data = rl78core_mem_read_u08(absolute_address);
-			absolute_address = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			rl78core_mem_write_u08(absolute_address, data);
-			// todo: handle flags if needed!
-		} break;
+	// note: an earlier deadline, such as of an event scheduled by a write of the
+	// running program, leaves the engines at the next boundary, so the run loop
+	// shortens its slice to it.
+	cpu->leave = cpu->leave || (cycles < cpu->deadline);
+	cpu->deadline = cycles;
+}
 
-		case 0x9D:  // MOV saddr, A
-		{
-			uint20_t absolute_address = general_purpose_register_to_absolute_address(rl78core_gpr08_a);
-			const uint8_t data = rl78core_mem_read_u08(absolute_address);
-			const uint8_t short_address = fetch_instruction_byte();
-			absolute_address = short_direct_address_to_absolute_address(short_address);
-			rl78core_mem_write_u08(absolute_address, data);
-			// todo: handle flags if needed!
-		} break;
-#endif
+void rl78core_cpu_save_r(rl78core_machine_s* const machine, rl78core_cpu_state_s* const state)
+{
+	rl78misc_debug_assert(state != NULL);
+	rl78core_cpu_s* const cpu = machine->cpu;
+	flush_flags(cpu);
+	*state = (rl78core_cpu_state_s)
+	{
+		.halted = cpu->halted,
+		.standby = cpu->standby,
+		.pc = cpu->pc,
+		.cycles = cpu->cycles,
+		.engine = cpu->engine,
+	};
+}
 
-		// -------------------------------------------------------- //
+void rl78core_cpu_restore_r(rl78core_machine_s* const machine, const rl78core_cpu_state_s* const state)
+{
+	rl78misc_debug_assert(state != NULL);
+	rl78misc_debug_assert(state->engine < rl78core_cpu_engines_count);
+	rl78misc_debug_assert(state->standby < rl78core_cpu_standbys_count);
+	rl78core_cpu_s* const cpu = machine->cpu;
+
+	// note: the breakpoints are set by the debugger, and are not a part of the
+	// state. The cached code stays valid, as the memory reports the restored
+	// code pages to the code write hook.
+	cpu->halted = state->halted;
+	cpu->standby = state->standby;
+	cpu->pc = state->pc;
+	cpu->cycles = state->cycles;
+	cpu->deadline = rl78core_cpu_no_deadline;
+	cpu->engine = state->engine;
+	cpu->code_written = false;
+	cpu->flags_op = rl78core_cpu_flags_op_none;
+	rl78core_mem_set_code_write_hook_r(machine, invalidate_code_page);
+	sync_gpr_bank(cpu);
+
+	// note: the pending interrupt is derived from the restored psw and registers
+	// of the interrupt controller, and not kept from before the restore.
+	rl78core_intc_update_r(machine);
+}
 
-		// -------------------------------------------------------- //
+void rl78core_cpu_init(void)
+{
+	rl78core_cpu_init_r(rl78core_machine_default());
+}
 
-		default:
-		{
-			g_rl78core_cpu.halted = true;
-		} break;
-	}
+uint20_t rl78core_cpu_read_pc(void)
+{
+	return rl78core_cpu_read_pc_r(rl78core_machine_default());
+}
+
+void rl78core_cpu_write_pc(const uint20_t value)
+{
+	rl78core_cpu_write_pc_r(rl78core_machine_default(), value);
+}
+
+uint8_t rl78core_cpu_read_gpr08(const uint8_t gpr08)
+{
+	return rl78core_cpu_read_gpr08_r(rl78core_machine_default(), gpr08);
+}
+
+void rl78core_cpu_write_gpr08(const uint8_t gpr08, const uint8_t value)
+{
+	rl78core_cpu_write_gpr08_r(rl78core_machine_default(), gpr08, value);
+}
+
+uint16_t rl78core_cpu_read_gpr16(const uint8_t gpr16)
+{
+	return rl78core_cpu_read_gpr16_r(rl78core_machine_default(), gpr16);
+}
+
+void rl78core_cpu_write_gpr16(const uint8_t gpr16, const uint16_t value)
+{
+	rl78core_cpu_write_gpr16_r(rl78core_machine_default(), gpr16, value);
+}
+
+void rl78core_cpu_halt(void)
+{
+	rl78core_cpu_halt_r(rl78core_machine_default());
+}
+
+bool_t rl78core_cpu_halted(void)
+{
+	return rl78core_cpu_halted_r(rl78core_machine_default());
+}
+
+rl78core_cpu_standby_e rl78core_cpu_get_standby(void)
+{
+	return rl78core_cpu_get_standby_r(rl78core_machine_default());
+}
+
+bool_t rl78core_cpu_wake(void)
+{
+	return rl78core_cpu_wake_r(rl78core_machine_default());
+}
+
+void rl78core_cpu_set_engine(const rl78core_cpu_engine_e engine)
+{
+	rl78core_cpu_set_engine_r(rl78core_machine_default(), engine);
+}
+
+rl78core_cpu_engine_e rl78core_cpu_get_engine(void)
+{
+	return rl78core_cpu_get_engine_r(rl78core_machine_default());
+}
+
+uint32_t rl78core_cpu_tick(void)
+{
+	return rl78core_cpu_tick_r(rl78core_machine_default());
+}
+
+uint64_t rl78core_cpu_cycles(void)
+{
+	return rl78core_cpu_cycles_r(rl78core_machine_default());
+}
+
+uint64_t rl78core_cpu_execute(const uint64_t count)
+{
+	return rl78core_cpu_execute_r(rl78core_machine_default(), count);
+}
+
+rl78core_cpu_stop_e rl78core_cpu_run(const rl78core_cpu_budget_s budget)
+{
+	return rl78core_cpu_run_r(rl78core_machine_default(), budget);
+}
+
+bool_t rl78core_cpu_add_breakpoint(const uint20_t address)
+{
+	return rl78core_cpu_add_breakpoint_r(rl78core_machine_default(), address);
+}
+
+bool_t rl78core_cpu_remove_breakpoint(const uint20_t address)
+{
+	return rl78core_cpu_remove_breakpoint_r(rl78core_machine_default(), address);
+}
+
+void rl78core_cpu_set_deadline(const uint64_t cycles)
+{
+	rl78core_cpu_set_deadline_r(rl78core_machine_default(), cycles);
+}
+
+void rl78core_cpu_save(rl78core_cpu_state_s* const state)
+{
+	rl78core_cpu_save_r(rl78core_machine_default(), state);
+}
+
+void rl78core_cpu_restore(const rl78core_cpu_state_s* const state)
+{
+	rl78core_cpu_restore_r(rl78core_machine_default(), state);
 }
 
 uint20_t short_direct_address_to_absolute_address(const uint8_t address)
@@ -411,7 +1251,7 @@ uint20_t short_direct_address_to_absolute_address(const uint8_t address)
 	const uint20_t short_direct_addressing_start = 0xFFE20;
 	const uint16_t short_direct_addressing_length = 0x100;
 
-	rl78misc_debug_assert((short_direct_addressing_start + address) < \
+	rl78misc_debug_assert((short_direct_addressing_start + address) <          \
 		(short_direct_addressing_start + short_direct_addressing_length)
 	);
 
@@ -424,7 +1264,7 @@ uint20_t special_function_register_to_absolute_address(const uint8_t address)
 	const uint20_t special_function_register_start = 0xFFF00;
 	const uint16_t special_function_register_length = 0x100;
 
-	rl78misc_debug_assert((special_function_register_start + address) < \
+	rl78misc_debug_assert((special_function_register_start + address) <        \
 		(special_function_register_start + special_function_register_length)
 	);
 
@@ -432,14 +1272,15 @@ uint20_t special_function_register_to_absolute_address(const uint8_t address)
 	return absolute_address;
 }
 
-uint20_t general_purpose_register_to_absolute_address(const uint8_t offset)
+uint20_t general_purpose_register_to_absolute_address(rl78core_machine_s* const machine, const uint8_t offset)
 {
 	const uint8_t  general_purpose_register_count_per_bank = 8;
 	const uint20_t general_purpose_register_start = 0xFFEE0;
 	const uint8_t  general_purpose_register_length = 0x20;
+	const uint8_t  general_purpose_register_banks_count = 4;
 
 	rl78misc_debug_assert(offset < general_purpose_register_count_per_bank);
-	const uint8_t psw_value = rl78core_mem_read_u08(rl78core_fixed_sfr_psw);
+	const uint8_t psw_value = rl78core_mem_read_u08_r(machine, rl78core_fixed_sfr_psw);
 	// +----+---+------+----+------+------+------+----+      +------+------+
 	// | IE | Z | RBS1 | AC | RBS0 | ISP1 | ISP0 | CY |  ->  | RBS1 | RBS0 |
 	// +----+---+------+----+------+------+------+----+      +------+------+
@@ -447,9 +1288,11 @@ uint20_t general_purpose_register_to_absolute_address(const uint8_t offset)
 		(uint8_t)((uint8_t)(psw_value & 0x08) >> 3) |
 		(uint8_t)((uint8_t)(psw_value & 0x20) >> 4)
 	);
-	const uint8_t address = (uint8_t)((uint8_t)(current_gpr_bank * general_purpose_register_count_per_bank) + offset);
+	const uint8_t address = (uint8_t)(
+		(uint8_t)((uint8_t)(general_purpose_register_banks_count - 1 - current_gpr_bank) * general_purpose_register_count_per_bank) + offset
+	);
 
-	rl78misc_debug_assert((general_purpose_register_start + address) < \
+	rl78misc_debug_assert((general_purpose_register_start + address) <         \
 		(general_purpose_register_start + general_purpose_register_length)
 	);
 
@@ -457,16 +1300,12 @@ uint20_t general_purpose_register_to_absolute_address(const uint8_t offset)
 	return absolute_address;
 }
 
-uint20_t direct_address_to_absolute_address(const uint8_t address_low, const uint8_t address_high)
+uint20_t direct_address_to_absolute_address(const uint8_t segment, const uint8_t address_low, const uint8_t address_high)
 {
-	const uint8_t es_value = rl78core_mem_read_u08(rl78core_fixed_sfr_es);
-	// +---+---+---+---+-----+-----+-----+-----+      +-----+-----+-----+-----+
-	// | 0 | 0 | 0 | 0 | ES3 | ES2 | ES1 | ES0 |  ->  | ES3 | ES2 | ES1 | ES0 |
-	// +---+---+---+---+-----+-----+-----+-----+      +-----+-----+-----+-----+
 	const uint20_t absolute_address = (uint20_t)(
 		(uint20_t)(address_low & 0xFF) |
 		(uint20_t)((uint20_t)(address_high & 0xFF) << 8) |
-		(uint20_t)((uint20_t)(es_value & 0x0F) << 16)
+		(uint20_t)((uint20_t)(segment & 0x0F) << 16)
 	);
 	return absolute_address;
 }
@@ -489,7 +1328,1116 @@ uint20_t based_indexed_address_to_absolute_address(const uint20_t address)
 	return 0;
 }
 
-static uint8_t fetch_instruction_byte(void)
+static inline bool_t is_flash_read(const uint20_t address)
+{
+	return (address < rl78core_cpu_code_flash_end) ||
+		((address >= rl78core_cpu_mirror_start) && (address < rl78core_cpu_ram_start));
+}
+
+static uint8_t fetch_instruction_byte(rl78core_cpu_s* const cpu)
+{
+	const uint8_t byte = rl78core_mem_read_u08_r(cpu->machine, cpu->pc);
+	cpu->pc = (cpu->pc + 1) & 0xFFFFF;
+	return byte;
+}
+
+static inline void decode_instruction(rl78core_cpu_s* const cpu, rl78core_cpu_instruction_s* const instruction)
+{
+	rl78misc_debug_assert(instruction != NULL);
+	const rl78core_cpu_opcode_s* opcode = &g_rl78core_cpu_map_1st[fetch_instruction_byte(cpu)];
+	uint8_t opcode_length = 1;
+
+	while (rl78core_cpu_handler_prefix == opcode->handler)
+	{
+		opcode = &g_rl78core_cpu_maps[opcode->operand][fetch_instruction_byte(cpu)];
+		++opcode_length;
+	}
+
+	instruction->handler = opcode->handler;
+	instruction->operand = opcode->operand;
+	instruction->length = (opcode->length > opcode_length) ? opcode->length : opcode_length;
+	instruction->cycles = g_rl78core_cpu_cycles[opcode->handler];
+
+	for (uint8_t index = opcode_length; index < opcode->length; ++index)
+	{
+		instruction->data[index - opcode_length] = fetch_instruction_byte(cpu);
+	}
+}
+
+static inline const rl78core_cpu_instruction_s* fetch_instruction(rl78core_cpu_s* const cpu)
+{
+	const uint20_t address = cpu->pc;
+	rl78core_cpu_instruction_s* const instruction =
+		&cpu->decode_cache[address & (rl78core_cpu_decode_cache_capacity - 1)];
+
+	if (instruction->address == address)
+	{
+		cpu->pc = (address + instruction->length) & 0xFFFFF;
+		return instruction;
+	}
+
+	decode_instruction(cpu, instruction);
+	const uint20_t last_address = (address + instruction->length - 1) & 0xFFFFF;
+
+	// note: the registers banks are written through the cached registers bank
+	// pointer, which bypasses the code write hook, so the instructions in the
+	// registers and special function registers pages are never cached.
+	if ((address >= 0xFFE00) || (last_address >= 0xFFE00))
+	{
+		instruction->address = rl78core_cpu_decode_cache_invalid;
+		return instruction;
+	}
+
+	rl78core_mem_watch_code_page_r(cpu->machine, address);
+	rl78core_mem_watch_code_page_r(cpu->machine, last_address);
+	instruction->address = address;
+	return instruction;
+}
+
+#if rl78core_cpu_threaded_dispatch
+// note: labels as values and computed gotos are gnu extensions.
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+static uint64_t execute_interp(rl78core_cpu_s* const cpu, const uint64_t count)
+{
+	const rl78core_cpu_instruction_s* instruction = NULL;
+	uint64_t remaining = count;
+
+#if rl78core_cpu_threaded_dispatch
+#	define rl78core_cpu_handler_label(_name, _cycles) [rl78core_cpu_handler_ ## _name] = &&label_ ## _name,
+
+	static const void* const labels[rl78core_cpu_handlers_count] =
+	{
+		rl78core_cpu_handlers(rl78core_cpu_handler_label)
+	};
+
+#	undef rl78core_cpu_handler_label
+
+	// note: every handler gets its own copy of the dispatch, so that the host's
+	// branch predictor can learn the opcode sequences of the emulated program.
+#	define rl78core_cpu_dispatch()                                             \
+		do                                                                     \
+		{                                                                      \
+			if ((0 == remaining) || cpu->leave)                                \
+			{                                                                  \
+				return count - remaining;                                      \
+			}                                                                  \
+                                                                               \
+			--remaining;                                                       \
+			instruction = fetch_instruction(cpu);                              \
+			goto *labels[instruction->handler];                                \
+		} while (0)
+
+#	define rl78core_cpu_handler_body(_name, _cycles)                           \
+		label_ ## _name:                                                       \
+		{                                                                      \
+			cpu->cycles += _cycles;                                            \
+			execute_ ## _name(cpu, instruction);                               \
+			rl78core_cpu_dispatch();                                           \
+		}
+
+	// note: only the halted cpu is left before the first instruction, so that a
+	// requested interrupt, that is not acknowledged, does not stall the cpu.
+	if ((0 == remaining) || cpu->halted)
+	{
+		return 0;
+	}
+
+	--remaining;
+	instruction = fetch_instruction(cpu);
+	goto *labels[instruction->handler];
+	rl78core_cpu_handlers(rl78core_cpu_handler_body)
+
+#	undef rl78core_cpu_handler_body
+#	undef rl78core_cpu_dispatch
+#else
+	// note: only the halted cpu is left before the first instruction, so that a
+	// requested interrupt, that is not acknowledged, does not stall the cpu.
+	if (cpu->halted)
+	{
+		return 0;
+	}
+
+	while (remaining > 0)
+	{
+		instruction = fetch_instruction(cpu);
+		cpu->cycles += instruction->cycles;
+		g_rl78core_cpu_handlers[instruction->handler](cpu, instruction);
+		--remaining;
+
+		if (cpu->leave)
+		{
+			break;
+		}
+	}
+
+	return count - remaining;
+#endif
+}
+
+#if rl78core_cpu_threaded_dispatch
+#	pragma GCC diagnostic pop
+#endif
+
+static uint64_t execute_block(rl78core_cpu_s* const cpu, const uint64_t count, const bool_t jit)
+{
+	rl78core_cpu_block_s* previous = NULL;
+	uint64_t remaining = count;
+	bool_t first = true;
+
+	// note: only the halted cpu is left before the first block, so that a
+	// requested interrupt, that is not acknowledged, does not stall the cpu.
+	while ((remaining > 0) && !(first ? cpu->halted : cpu->leave))
+	{
+		first = false;
+		const uint20_t address = cpu->pc;
+		rl78core_cpu_block_s* block = NULL;
+
+		if (previous != NULL)
+		{
+			// note: the chained blocks stay in the block cache, and are only valid
+			// as long as they are still cached for the same address.
+			const uint8_t successor = (address == previous->end_address) ? 0 : 1;
+			block = previous->successors[successor];
+
+			if ((NULL == block) || (block->address != address))
+			{
+				block = lookup_block(cpu, address);
+				previous->successors[successor] = block;
+			}
+		}
+		else
+		{
+			block = lookup_block(cpu, address);
+		}
+
+		if ((NULL == block) || (block->count > remaining))
+		{
+			remaining -= execute_interp(cpu, 1);
+			previous = NULL;
+			continue;
+		}
+
+		if (jit && (NULL == block->jit_code) && (++block->hits >= rl78core_cpu_block_jit_threshold))
+		{
+			compile_block(cpu, block);
+		}
+
+		cpu->code_written = false;
+		uint8_t index = 0;
+
+		if (block->jit_code != NULL)
+		{
+			index = (uint8_t)block->jit_code();
+		}
+
+		// note: the compiled code returns early once a handler writes to the code,
+		// and so does the loop, since the rest of the block is stale then. Both
+		// also leave the block at the next boundary, once the cpu is to be left.
+		while ((index < block->count) && !cpu->code_written && ((0 == index) || !cpu->leave))
+		{
+			const rl78core_cpu_instruction_s* const instruction = &block->instructions[index++];
+			cpu->pc = (instruction->address + instruction->length) & 0xFFFFF;
+			cpu->cycles += instruction->cycles;
+			g_rl78core_cpu_handlers[instruction->handler](cpu, instruction);
+		}
+
+		remaining -= index;
+		previous = cpu->code_written ? NULL : block;
+	}
+
+	return count - remaining;
+}
+
+static bool_t has_breakpoint(rl78core_cpu_s* const cpu, const uint20_t address)
+{
+	for (uint8_t index = 0; index < cpu->breakpoints_count; ++index)
+	{
+		if (cpu->breakpoints[index] == (address & 0xFFFFF))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static inline bool_t ends_block(const uint8_t handler)
+{
+	switch (handler)
+	{
+		case rl78core_cpu_handler_illegal:
+		case rl78core_cpu_handler_prefix:
+		case rl78core_cpu_handler_bcond:
+		case rl78core_cpu_handler_br_rel8:
+		case rl78core_cpu_handler_br_abs16:
+		case rl78core_cpu_handler_br_abs20:
+		case rl78core_cpu_handler_call_abs16:
+		case rl78core_cpu_handler_ret:
+		case rl78core_cpu_handler_reti:
+		case rl78core_cpu_handler_halt:
+		case rl78core_cpu_handler_stop:
+		{
+			return true;
+		} break;
+
+		default:
+		{
+			return false;
+		} break;
+	}
+}
+
+static rl78core_cpu_block_s* lookup_block(rl78core_cpu_s* const cpu, const uint20_t address)
+{
+	const uint20_t index = (address ^ (address >> 9)) & (rl78core_cpu_block_cache_capacity - 1);
+	rl78core_cpu_block_s* const block = &cpu->block_cache[index];
+
+	if (block->address == address)
+	{
+		return block;
+	}
+
+	// note: the registers and special function registers pages are never cached,
+	// see the note in the fetch_instruction function.
+	const uint20_t uncacheable_start = 0xFFE00;
+	const uint20_t pc = cpu->pc;
+	cpu->pc = address;
+	block->address = rl78core_cpu_decode_cache_invalid;
+	block->successors[0] = NULL;
+	block->successors[1] = NULL;
+	block->count = 0;
+	block->hits = 0;
+	block->jit_code = NULL;
+
+	while ((block->count < rl78core_cpu_block_max_length) &&
+		((cpu->pc + rl78core_cpu_instruction_max_length) <= uncacheable_start))
+	{
+		rl78core_cpu_instruction_s* const instruction = &block->instructions[block->count++];
+		const uint20_t instruction_address = cpu->pc;
+		decode_instruction(cpu, instruction);
+		instruction->address = instruction_address;
+
+		if (ends_block(instruction->handler))
+		{
+			break;
+		}
+	}
+
+	block->end_address = cpu->pc;
+	cpu->pc = pc;
+
+	if (0 == block->count)
+	{
+		return NULL;
+	}
+
+	const uint20_t last_page = (block->end_address - 1) >> rl78core_mem_page_shift;
+
+	for (uint20_t page = address >> rl78core_mem_page_shift; page <= last_page; ++page)
+	{
+		rl78core_mem_watch_code_page_r(cpu->machine, page << rl78core_mem_page_shift);
+	}
+
+	block->address = address;
+	return block;
+}
+
+static void compile_block(rl78core_cpu_s* const cpu, rl78core_cpu_block_s* const block)
+{
+	rl78misc_debug_assert(block != NULL);
+
+	for (uint8_t attempt = 0; attempt < 2; ++attempt)
+	{
+		rl78core_jit_begin(cpu->jit, &cpu->gpr_bank);
+		bool_t pc_stale = false;
+		uint32_t cycles = 0;
+
+		for (uint8_t index = 0; index < block->count; ++index)
+		{
+			pc_stale = emit_instruction(cpu, &block->instructions[index], index, &cycles);
+		}
+
+		if (pc_stale)
+		{
+			rl78core_jit_emit_store_u32(cpu->jit, &cpu->pc, block->end_address);
+		}
+
+		if (cycles > 0)
+		{
+			rl78core_jit_emit_add_u64(cpu->jit, &cpu->cycles, cycles);
+		}
+
+		block->jit_code = rl78core_jit_end(cpu->jit, block->count);
+
+		if (block->jit_code != NULL)
+		{
+			return;
+		}
+
+		// note: the arena is full, so all the compiled blocks get discarded.
+		rl78core_jit_reset(cpu->jit);
+
+		for (uint32_t index = 0; index < rl78core_cpu_block_cache_capacity; ++index)
+		{
+			cpu->block_cache[index].jit_code = NULL;
+			cpu->block_cache[index].hits = 0;
+		}
+	}
+}
+
+static bool_t emit_instruction(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction, const uint8_t index, uint32_t* const cycles)
+{
+	rl78misc_debug_assert(instruction != NULL);
+	rl78misc_debug_assert(cycles != NULL);
+	*cycles += instruction->cycles;
+
+	switch (instruction->handler)
+	{
+		case rl78core_cpu_handler_nop:
+		{
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_mov_r_imm:
+		{
+			rl78core_jit_emit_gpr08_imm(cpu->jit, instruction->operand, instruction->data[0]);
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_mov_a_r:
+		{
+			rl78core_jit_emit_gpr08_gpr08(cpu->jit, rl78core_gpr08_a, instruction->operand);
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_mov_r_a:
+		{
+			rl78core_jit_emit_gpr08_gpr08(cpu->jit, instruction->operand, rl78core_gpr08_a);
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_movw_rp_imm:
+		{
+			rl78core_jit_emit_gpr16_imm(cpu->jit, instruction->operand,
+				(uint16_t)(instruction->data[0] | (uint16_t)(instruction->data[1] << 8)));
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_inc_r:
+		{
+			emit_alu(cpu, rl78core_jit_alu_add, instruction->operand, 1, true, rl78core_cpu_flags_op_inc);
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_dec_r:
+		{
+			emit_alu(cpu, rl78core_jit_alu_sub, instruction->operand, 1, true, rl78core_cpu_flags_op_dec);
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_add_a_imm:
+		{
+			emit_alu(cpu, rl78core_jit_alu_add, rl78core_gpr08_a, instruction->data[0], true, rl78core_cpu_flags_op_add);
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_sub_a_imm:
+		{
+			emit_alu(cpu, rl78core_jit_alu_sub, rl78core_gpr08_a, instruction->data[0], true, rl78core_cpu_flags_op_sub);
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_cmp_a_imm:
+		{
+			emit_alu(cpu, rl78core_jit_alu_sub, rl78core_gpr08_a, instruction->data[0], false, rl78core_cpu_flags_op_sub);
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_and_a_imm:
+		{
+			emit_alu(cpu, rl78core_jit_alu_and, rl78core_gpr08_a, instruction->data[0], true, rl78core_cpu_flags_op_logic);
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_or_a_imm:
+		{
+			emit_alu(cpu, rl78core_jit_alu_or, rl78core_gpr08_a, instruction->data[0], true, rl78core_cpu_flags_op_logic);
+			return true;
+		} break;
+
+		case rl78core_cpu_handler_xor_a_imm:
+		{
+			emit_alu(cpu, rl78core_jit_alu_xor, rl78core_gpr08_a, instruction->data[0], true, rl78core_cpu_flags_op_logic);
+			return true;
+		} break;
+
+		default:
+		{
+			// note: the handlers expect the pc register to point past the instruction,
+			// and may modify the code or the selected registers bank.
+			rl78core_jit_emit_store_u32(cpu->jit, &cpu->pc, (instruction->address + instruction->length) & 0xFFFFF);
+			rl78core_jit_emit_add_u64(cpu->jit, &cpu->cycles, *cycles);
+			*cycles = 0;
+			rl78core_jit_emit_call(cpu->jit, (uint64_t)(uintptr_t)g_rl78core_cpu_handlers[instruction->handler], cpu, instruction);
+			rl78core_jit_emit_return_if(cpu->jit, &cpu->code_written, (uint32_t)index + 1);
+			rl78core_jit_emit_return_if(cpu->jit, &cpu->leave, (uint32_t)index + 1);
+			return false;
+		} break;
+	}
+}
+
+static void emit_alu(rl78core_cpu_s* const cpu, const rl78core_jit_alu_e alu, const uint8_t gpr08, const uint8_t value, const bool_t store, const uint8_t op)
+{
+	rl78misc_debug_assert(op < rl78core_cpu_flags_ops_count);
+	uint8_t low = rl78core_cpu_flags_ops_count;
+	uint8_t high = 0;
+
+	// note: the pending operations, whose flags are not all overwritten by the
+	// operation, are flushed by the emitted code. They form a range of ids, since
+	// the operations are ordered by their flags.
+	for (uint8_t pending = 0; pending < rl78core_cpu_flags_ops_count; ++pending)
+	{
+		if (0 != (g_rl78core_cpu_flags_masks[pending] & (uint8_t)~g_rl78core_cpu_flags_masks[op]))
+		{
+			low = (pending < low) ? pending : low;
+			high = pending;
+		}
+	}
+
+	if (low <= high)
+	{
+		rl78core_jit_emit_call_if(cpu->jit, &cpu->flags_op, low, high, (uint64_t)(uintptr_t)&flush_flags, cpu);
+	}
+
+	rl78core_jit_emit_gpr08_alu(cpu->jit, alu, gpr08, value, store, &cpu->flags_op, op);
+}
+
+static void invalidate_code_page(rl78core_machine_s* const machine, const uint20_t page)
+{
+	rl78core_cpu_s* const cpu = machine->cpu;
+	const int32_t page_start = (int32_t)(page << rl78core_mem_page_shift);
+
+	// note: the instructions which start in the previous page may overlap the page.
+	for (int32_t offset = -(rl78core_cpu_instruction_max_length - 1); offset < rl78core_mem_page_size; ++offset)
+	{
+		const uint20_t address = (uint20_t)(page_start + offset) & 0xFFFFF;
+		rl78core_cpu_instruction_s* const instruction =
+			&cpu->decode_cache[address & (rl78core_cpu_decode_cache_capacity - 1)];
+
+		if (instruction->address == address)
+		{
+			instruction->address = rl78core_cpu_decode_cache_invalid;
+		}
+	}
+
+	const uint20_t page_end = (uint20_t)page_start + rl78core_mem_page_size;
+
+	for (uint32_t index = 0; index < rl78core_cpu_block_cache_capacity; ++index)
+	{
+		rl78core_cpu_block_s* const block = &cpu->block_cache[index];
+
+		if ((block->address < page_end) && (block->end_address > (uint20_t)page_start))
+		{
+			block->address = rl78core_cpu_decode_cache_invalid;
+		}
+	}
+
+	cpu->code_written = true;
+}
+
+static inline uint8_t read_gpr08(rl78core_cpu_s* const cpu, const uint8_t gpr08)
+{
+	rl78misc_debug_assert(gpr08 < rl78core_gpr08s_count);
+	return cpu->gpr_bank[gpr08];
+}
+
+static inline void write_gpr08(rl78core_cpu_s* const cpu, const uint8_t gpr08, const uint8_t value)
+{
+	rl78misc_debug_assert(gpr08 < rl78core_gpr08s_count);
+	cpu->gpr_bank[gpr08] = value;
+}
+
+static inline uint16_t read_gpr16(rl78core_cpu_s* const cpu, const uint8_t gpr16)
+{
+	rl78misc_debug_assert(0 == (gpr16 % 2));
+	rl78misc_debug_assert(gpr16 < rl78core_gpr16s_count);
+	return (uint16_t)(
+		(uint16_t)cpu->gpr_bank[gpr16 + 0] |
+		(uint16_t)((uint16_t)cpu->gpr_bank[gpr16 + 1] << 8)
+	);
+}
+
+static inline void write_gpr16(rl78core_cpu_s* const cpu, const uint8_t gpr16, const uint16_t value)
+{
+	rl78misc_debug_assert(0 == (gpr16 % 2));
+	rl78misc_debug_assert(gpr16 < rl78core_gpr16s_count);
+	cpu->gpr_bank[gpr16 + 0] = (uint8_t)(value & 0x00FF);
+	cpu->gpr_bank[gpr16 + 1] = (uint8_t)((uint16_t)(value >> 8) & 0x00FF);
+}
+
+static inline void sync_gpr_bank(rl78core_cpu_s* const cpu)
+{
+	const uint20_t address = general_purpose_register_to_absolute_address(cpu->machine, 0);
+	cpu->gpr_bank = rl78core_mem_reference_r(cpu->machine, address, rl78core_gpr08s_count);
+}
+
+static void sync_interrupt(rl78core_cpu_s* const cpu)
+{
+	bool_t interrupt = false;
+
+	// note: the priority levels are selected only while the interrupts are
+	// enabled, so the disabled requests cost nothing to the engines.
+	if (cpu->requested)
+	{
+		const uint8_t psw_value = rl78core_mem_read_u08_r(cpu->machine, rl78core_fixed_sfr_psw);
+
+		if (0 != (psw_value & rl78core_psw_flag_ie))
+		{
+			const uint8_t isp = (uint8_t)((psw_value & (rl78core_psw_flag_isp0 | rl78core_psw_flag_isp1)) >> 1);
+			interrupt = (rl78core_intc_select_r(cpu->machine, isp) != rl78core_intc_no_source);
+		}
+	}
+
+	cpu->interrupt = interrupt;
+	cpu->leave = cpu->halted || interrupt;
+}
+
+static inline uint8_t read_data_u08(rl78core_cpu_s* const cpu, const uint20_t address)
+{
+	if (rl78core_fixed_sfr_psw == address)
+	{
+		flush_flags(cpu);
+	}
+
+	return rl78core_mem_read_u08_r(cpu->machine, address);
+}
+
+static inline void write_data_u08(rl78core_cpu_s* const cpu, const uint20_t address, const uint8_t value)
+{
+	if (rl78core_fixed_sfr_psw == address)
+	{
+		// note: the pending flags are overwritten by the write.
+		cpu->flags_op = rl78core_cpu_flags_op_none;
+	}
+
+	rl78core_mem_write_u08_r(cpu->machine, address, value);
+
+	if (rl78core_fixed_sfr_psw == address)
+	{
+		sync_gpr_bank(cpu);
+		sync_interrupt(cpu);
+	}
+	else if ((address - rl78core_intc_registers_address) < rl78core_intc_registers_length)
+	{
+		rl78core_intc_update_r(cpu->machine);
+	}
+}
+
+static inline void write_data_u16(rl78core_cpu_s* const cpu, const uint20_t address, const uint16_t value)
+{
+	if ((rl78core_fixed_sfr_psw == address) || ((rl78core_fixed_sfr_psw - 1) == address))
+	{
+		// note: the pending flags are overwritten by the write.
+		cpu->flags_op = rl78core_cpu_flags_op_none;
+	}
+
+	rl78core_mem_write_u16_r(cpu->machine, address, value);
+
+	if ((rl78core_fixed_sfr_psw == address) || ((rl78core_fixed_sfr_psw - 1) == address))
+	{
+		sync_gpr_bank(cpu);
+		sync_interrupt(cpu);
+	}
+	else if ((address - (rl78core_intc_registers_address - 1)) < (rl78core_intc_registers_length + 1))
+	{
+		rl78core_intc_update_r(cpu->machine);
+	}
+}
+
+static inline void defer_flags(rl78core_cpu_s* const cpu, const uint8_t op, const uint8_t left, const uint8_t right, const uint8_t result)
+{
+	rl78misc_debug_assert(op < rl78core_cpu_flags_ops_count);
+	const uint8_t pending_mask = g_rl78core_cpu_flags_masks[cpu->flags_op];
+
+	// note: the pending flags, which are not overwritten by the operation, must
+	// be written before the operation gets recorded.
+	if (0 != (pending_mask & (uint8_t)~g_rl78core_cpu_flags_masks[op]))
+	{
+		flush_flags(cpu);
+	}
+
+	cpu->flags_op = op;
+	cpu->flags_left = left;
+	cpu->flags_right = right;
+	cpu->flags_result = result;
+}
+
+static inline void flush_flags(rl78core_cpu_s* const cpu)
+{
+	const uint8_t op = cpu->flags_op;
+
+	if (rl78core_cpu_flags_op_none == op)
+	{
+		return;
+	}
+
+	const uint8_t left = cpu->flags_left;
+	const uint8_t right = cpu->flags_right;
+	const uint8_t result = cpu->flags_result;
+	uint8_t flags = (0 == result) ? rl78core_psw_flag_z : 0;
+
+	switch (op)
+	{
+		case rl78core_cpu_flags_op_add:
+		{
+			flags |= (uint8_t)((((left & 0x0F) + (right & 0x0F)) > 0x0F) ? rl78core_psw_flag_ac : 0);
+			flags |= (uint8_t)((((uint16_t)left + right) > 0xFF) ? rl78core_psw_flag_cy : 0);
+		} break;
+
+		case rl78core_cpu_flags_op_sub:
+		{
+			flags |= (uint8_t)(((left & 0x0F) < (right & 0x0F)) ? rl78core_psw_flag_ac : 0);
+			flags |= (uint8_t)((left < right) ? rl78core_psw_flag_cy : 0);
+		} break;
+
+		case rl78core_cpu_flags_op_inc:
+		{
+			flags |= (uint8_t)((0 == (result & 0x0F)) ? rl78core_psw_flag_ac : 0);
+		} break;
+
+		case rl78core_cpu_flags_op_dec:
+		{
+			flags |= (uint8_t)((0x0F == (result & 0x0F)) ? rl78core_psw_flag_ac : 0);
+		} break;
+
+		default:
+		{
+		} break;
+	}
+
+	cpu->flags_op = rl78core_cpu_flags_op_none;
+	write_flags(cpu, g_rl78core_cpu_flags_masks[op], flags);
+}
+
+static void write_flags(rl78core_cpu_s* const cpu, const uint8_t mask, const uint8_t flags)
+{
+	flush_flags(cpu);
+	const uint8_t psw_value = rl78core_mem_read_u08_r(cpu->machine, rl78core_fixed_sfr_psw);
+	rl78core_mem_write_u08_r(cpu->machine, rl78core_fixed_sfr_psw,
+		(uint8_t)((uint8_t)(psw_value & (uint8_t)~mask) | (uint8_t)(flags & mask))
+	);
+
+	if (0 != (mask & (rl78core_psw_flag_rbs0 | rl78core_psw_flag_rbs1)))
+	{
+		sync_gpr_bank(cpu);
+	}
+}
+
+static void push_u08(rl78core_cpu_s* const cpu, const uint8_t value)
+{
+	const uint16_t sp_value = (uint16_t)(rl78core_mem_read_u16_r(cpu->machine, rl78core_fixed_sfr_spl) - 1);
+	rl78core_mem_write_u16_r(cpu->machine, rl78core_fixed_sfr_spl, sp_value);
+	write_data_u08(cpu, (uint20_t)(0xF0000 | sp_value), value);
+}
+
+static uint8_t pop_u08(rl78core_cpu_s* const cpu)
+{
+	const uint16_t sp_value = rl78core_mem_read_u16_r(cpu->machine, rl78core_fixed_sfr_spl);
+	rl78core_mem_write_u16_r(cpu->machine, rl78core_fixed_sfr_spl, (uint16_t)(sp_value + 1));
+	return read_data_u08(cpu, (uint20_t)(0xF0000 | sp_value));
+}
+
+static void handle_interrupt(rl78core_cpu_s* const cpu)
+{
+	// note: any unmasked request releases the standby modes, even while the
+	// interrupts are disabled, and then the execution continues after the halt.
+	if (cpu->halted && !rl78core_cpu_wake_r(cpu->machine))
+	{
+		return;
+	}
+
+	const uint8_t psw_value = read_data_u08(cpu, rl78core_fixed_sfr_psw);
+	if (0 == (psw_value & rl78core_psw_flag_ie))
+	{
+		return;
+	}
+
+	const uint8_t isp = (uint8_t)((psw_value & (rl78core_psw_flag_isp0 | rl78core_psw_flag_isp1)) >> 1);
+	const uint8_t source = rl78core_intc_select_r(cpu->machine, isp);
+	if (rl78core_intc_no_source == source)
+	{
+		return;
+	}
+
+	const uint8_t level = rl78core_intc_priority_r(cpu->machine, source);
+	rl78core_intc_acknowledge_r(cpu->machine, source);
+
+	// note: the frame is laid out as the one of a call, with the psw register in
+	// its topmost byte.
+	const uint16_t sp_value = (uint16_t)(rl78core_mem_read_u16_r(cpu->machine, rl78core_fixed_sfr_spl) - 4);
+	write_data_u08(cpu, (uint20_t)(0xF0000 | (uint16_t)(sp_value + 3)), psw_value);
+	write_data_u08(cpu, (uint20_t)(0xF0000 | (uint16_t)(sp_value + 2)), (uint8_t)((cpu->pc >> 16) & 0x0F));
+	write_data_u08(cpu, (uint20_t)(0xF0000 | (uint16_t)(sp_value + 1)), (uint8_t)((cpu->pc >> 8) & 0xFF));
+	write_data_u08(cpu, (uint20_t)(0xF0000 | sp_value), (uint8_t)(cpu->pc & 0xFF));
+	rl78core_mem_write_u16_r(cpu->machine, rl78core_fixed_sfr_spl, sp_value);
+
+	const uint8_t isp_mask = rl78core_psw_flag_isp0 | rl78core_psw_flag_isp1;
+	write_data_u08(cpu, rl78core_fixed_sfr_psw, (uint8_t)((psw_value & ~(rl78core_psw_flag_ie | isp_mask)) | (level << 1)));
+	cpu->pc = rl78core_mem_read_u16_r(cpu->machine, (uint20_t)(rl78core_intc_vectors_address + (2 * source)));
+	cpu->cycles += rl78core_cpu_interrupt_cycles;
+}
+
+static inline void execute_illegal(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	(void)instruction;
+	cpu->halted = true;
+	cpu->leave = true;
+}
+
+static inline void execute_prefix(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	// note: prefixes are consumed by the decoder and never get executed.
+	execute_illegal(cpu, instruction);
+}
+
+static inline void execute_nop(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	(void)cpu;
+	(void)instruction;
+}
+
+static inline void execute_mov_r_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	write_gpr08(cpu, instruction->operand, instruction->data[0]);
+}
+
+static inline void execute_mov_a_r(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	write_gpr08(cpu, rl78core_gpr08_a, read_gpr08(cpu, instruction->operand));
+}
+
+static inline void execute_mov_r_a(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	write_gpr08(cpu, instruction->operand, read_gpr08(cpu, rl78core_gpr08_a));
+}
+
+static inline void execute_mov_a_saddr(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = short_direct_address_to_absolute_address(instruction->data[0]);
+	write_gpr08(cpu, rl78core_gpr08_a, rl78core_mem_read_u08_r(cpu->machine, absolute_address));
+}
+
+static inline void execute_mov_saddr_a(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = short_direct_address_to_absolute_address(instruction->data[0]);
+	write_data_u08(cpu, absolute_address, read_gpr08(cpu, rl78core_gpr08_a));
+}
+
+static inline void execute_mov_a_sfr(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = special_function_register_to_absolute_address(instruction->data[0]);
+	write_gpr08(cpu, rl78core_gpr08_a, read_data_u08(cpu, absolute_address));
+}
+
+static inline void execute_mov_sfr_a(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = special_function_register_to_absolute_address(instruction->data[0]);
+	write_data_u08(cpu, absolute_address, read_gpr08(cpu, rl78core_gpr08_a));
+}
+
+static inline void execute_mov_a_addr16(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = direct_address_to_absolute_address(0x0F, instruction->data[0], instruction->data[1]);
+	write_gpr08(cpu, rl78core_gpr08_a, read_data_u08(cpu, absolute_address));
+
+	if (is_flash_read(absolute_address))
+	{
+		cpu->cycles += rl78core_cpu_flash_read_wait_cycles;
+	}
+}
+
+static inline void execute_mov_addr16_a(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = direct_address_to_absolute_address(0x0F, instruction->data[0], instruction->data[1]);
+	write_data_u08(cpu, absolute_address, read_gpr08(cpu, rl78core_gpr08_a));
+}
+
+static inline void execute_mov_saddr_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = short_direct_address_to_absolute_address(instruction->data[0]);
+	write_data_u08(cpu, absolute_address, instruction->data[1]);
+}
+
+static inline void execute_mov_sfr_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = special_function_register_to_absolute_address(instruction->data[0]);
+	write_data_u08(cpu, absolute_address, instruction->data[1]);
+}
+
+static inline void execute_mov_addr16_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = direct_address_to_absolute_address(0x0F, instruction->data[0], instruction->data[1]);
+	write_data_u08(cpu, absolute_address, instruction->data[2]);
+}
+
+static inline void execute_mov_a_es_addr16(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t segment = rl78core_mem_read_u08_r(cpu->machine, rl78core_fixed_sfr_es);
+	const uint20_t absolute_address = direct_address_to_absolute_address(segment, instruction->data[0], instruction->data[1]);
+	write_gpr08(cpu, rl78core_gpr08_a, read_data_u08(cpu, absolute_address));
+
+	if (is_flash_read(absolute_address))
+	{
+		cpu->cycles += rl78core_cpu_flash_read_wait_cycles;
+	}
+}
+
+static inline void execute_mov_es_addr16_a(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t segment = rl78core_mem_read_u08_r(cpu->machine, rl78core_fixed_sfr_es);
+	const uint20_t absolute_address = direct_address_to_absolute_address(segment, instruction->data[0], instruction->data[1]);
+	write_data_u08(cpu, absolute_address, read_gpr08(cpu, rl78core_gpr08_a));
+}
+
+static inline void execute_mov_es_addr16_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t segment = rl78core_mem_read_u08_r(cpu->machine, rl78core_fixed_sfr_es);
+	const uint20_t absolute_address = direct_address_to_absolute_address(segment, instruction->data[0], instruction->data[1]);
+	write_data_u08(cpu, absolute_address, instruction->data[2]);
+}
+
+static inline void execute_movw_rp_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint16_t data = (uint16_t)(instruction->data[0] | (uint16_t)(instruction->data[1] << 8));
+	write_gpr16(cpu, instruction->operand, data);
+}
+
+static inline void execute_movw_sfrp_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = special_function_register_to_absolute_address(instruction->data[0]);
+	const uint16_t data = (uint16_t)(instruction->data[1] | (uint16_t)(instruction->data[2] << 8));
+	write_data_u16(cpu, absolute_address, data);
+}
+
+static inline void execute_inc_r(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t value = read_gpr08(cpu, instruction->operand);
+	const uint8_t result = (uint8_t)(value + 1);
+	write_gpr08(cpu, instruction->operand, result);
+	defer_flags(cpu, rl78core_cpu_flags_op_inc, value, 1, result);
+}
+
+static inline void execute_dec_r(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t value = read_gpr08(cpu, instruction->operand);
+	const uint8_t result = (uint8_t)(value - 1);
+	write_gpr08(cpu, instruction->operand, result);
+	defer_flags(cpu, rl78core_cpu_flags_op_dec, value, 1, result);
+}
+
+static inline void execute_add_a_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t value = read_gpr08(cpu, rl78core_gpr08_a);
+	const uint8_t result = (uint8_t)(value + instruction->data[0]);
+	write_gpr08(cpu, rl78core_gpr08_a, result);
+	defer_flags(cpu, rl78core_cpu_flags_op_add, value, instruction->data[0], result);
+}
+
+static inline void execute_sub_a_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t value = read_gpr08(cpu, rl78core_gpr08_a);
+	const uint8_t result = (uint8_t)(value - instruction->data[0]);
+	write_gpr08(cpu, rl78core_gpr08_a, result);
+	defer_flags(cpu, rl78core_cpu_flags_op_sub, value, instruction->data[0], result);
+}
+
+static inline void execute_cmp_a_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t value = read_gpr08(cpu, rl78core_gpr08_a);
+	defer_flags(cpu, rl78core_cpu_flags_op_sub, value, instruction->data[0], (uint8_t)(value - instruction->data[0]));
+}
+
+static inline void execute_and_a_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t value = read_gpr08(cpu, rl78core_gpr08_a);
+	const uint8_t result = (uint8_t)(value & instruction->data[0]);
+	write_gpr08(cpu, rl78core_gpr08_a, result);
+	defer_flags(cpu, rl78core_cpu_flags_op_logic, value, instruction->data[0], result);
+}
+
+static inline void execute_or_a_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t value = read_gpr08(cpu, rl78core_gpr08_a);
+	const uint8_t result = (uint8_t)(value | instruction->data[0]);
+	write_gpr08(cpu, rl78core_gpr08_a, result);
+	defer_flags(cpu, rl78core_cpu_flags_op_logic, value, instruction->data[0], result);
+}
+
+static inline void execute_xor_a_imm(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t value = read_gpr08(cpu, rl78core_gpr08_a);
+	const uint8_t result = (uint8_t)(value ^ instruction->data[0]);
+	write_gpr08(cpu, rl78core_gpr08_a, result);
+	defer_flags(cpu, rl78core_cpu_flags_op_logic, value, instruction->data[0], result);
+}
+
+static inline void execute_bcond(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t psw_value = read_data_u08(cpu, rl78core_fixed_sfr_psw);
+	bool_t taken = false;
+
+	switch (instruction->operand)
+	{
+		case rl78core_condition_c:  { taken = (0 != (psw_value & rl78core_psw_flag_cy)); } break;
+		case rl78core_condition_z:  { taken = (0 != (psw_value & rl78core_psw_flag_z)); } break;
+		case rl78core_condition_nc: { taken = (0 == (psw_value & rl78core_psw_flag_cy)); } break;
+		case rl78core_condition_nz: { taken = (0 == (psw_value & rl78core_psw_flag_z)); } break;
+		default: { rl78misc_debug_assert(0); } break;
+	}
+
+	if (taken)
+	{
+		cpu->cycles += rl78core_cpu_branch_taken_cycles;
+		execute_br_rel8(cpu, instruction);
+	}
+}
+
+static inline void execute_br_rel8(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const int8_t displacement = (int8_t)instruction->data[0];
+	cpu->pc = (uint20_t)((int32_t)cpu->pc + displacement) & 0xFFFFF;
+}
+
+static inline void execute_br_abs16(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	cpu->pc = (uint20_t)(instruction->data[0] | (uint20_t)(instruction->data[1] << 8));
+}
+
+static inline void execute_br_abs20(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	cpu->pc = (uint20_t)(
+		(uint20_t)instruction->data[0] |
+		(uint20_t)((uint20_t)instruction->data[1] << 8) |
+		(uint20_t)((uint20_t)(instruction->data[2] & 0x0F) << 16)
+	);
+}
+
+static inline void execute_call_abs16(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	// note: the call frame is 4 bytes long, and its topmost byte is left untouched.
+	const uint16_t sp_value = (uint16_t)(rl78core_mem_read_u16_r(cpu->machine, rl78core_fixed_sfr_spl) - 4);
+	write_data_u08(cpu, (uint20_t)(0xF0000 | (uint16_t)(sp_value + 2)), (uint8_t)((cpu->pc >> 16) & 0x0F));
+	write_data_u08(cpu, (uint20_t)(0xF0000 | (uint16_t)(sp_value + 1)), (uint8_t)((cpu->pc >> 8) & 0xFF));
+	write_data_u08(cpu, (uint20_t)(0xF0000 | sp_value), (uint8_t)(cpu->pc & 0xFF));
+	rl78core_mem_write_u16_r(cpu->machine, rl78core_fixed_sfr_spl, sp_value);
+	execute_br_abs16(cpu, instruction);
+}
+
+static inline void execute_ret(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	(void)instruction;
+	const uint8_t pc_low = pop_u08(cpu);
+	const uint8_t pc_high = pop_u08(cpu);
+	const uint8_t pc_segment = pop_u08(cpu);
+	(void)pop_u08(cpu);
+	cpu->pc = (uint20_t)(
+		(uint20_t)pc_low |
+		(uint20_t)((uint20_t)pc_high << 8) |
+		(uint20_t)((uint20_t)(pc_segment & 0x0F) << 16)
+	);
+}
+
+static inline void execute_reti(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	execute_ret(cpu, instruction);
+
+	// note: the psw register is popped from the topmost byte of the frame, which
+	// the return discards.
+	const uint16_t sp_value = rl78core_mem_read_u16_r(cpu->machine, rl78core_fixed_sfr_spl);
+	write_data_u08(cpu, rl78core_fixed_sfr_psw, read_data_u08(cpu, (uint20_t)(0xF0000 | (uint16_t)(sp_value - 1))));
+}
+
+static inline void execute_push_rp(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint16_t value = read_gpr16(cpu, instruction->operand);
+	push_u08(cpu, (uint8_t)(value >> 8));
+	push_u08(cpu, (uint8_t)(value & 0xFF));
+}
+
+static inline void execute_pop_rp(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint8_t value_low = pop_u08(cpu);
+	const uint8_t value_high = pop_u08(cpu);
+	write_gpr16(cpu, instruction->operand, (uint16_t)(value_low | (uint16_t)(value_high << 8)));
+}
+
+static inline void execute_push_psw(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	(void)instruction;
+	push_u08(cpu, read_data_u08(cpu, rl78core_fixed_sfr_psw));
+	push_u08(cpu, 0x00);
+}
+
+static inline void execute_pop_psw(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	(void)instruction;
+	(void)pop_u08(cpu);
+	write_data_u08(cpu, rl78core_fixed_sfr_psw, pop_u08(cpu));
+}
+
+static inline void execute_sel_rb(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	write_flags(cpu, rl78core_psw_flag_rbs0 | rl78core_psw_flag_rbs1,
+		(uint8_t)(((instruction->operand & 0x01) ? rl78core_psw_flag_rbs0 : 0) |
+		((instruction->operand & 0x02) ? rl78core_psw_flag_rbs1 : 0))
+	);
+}
+
+static inline void execute_set1_sfr_bit(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = special_function_register_to_absolute_address(instruction->data[0]);
+	const uint8_t value = read_data_u08(cpu, absolute_address);
+	write_data_u08(cpu, absolute_address, (uint8_t)(value | (uint8_t)(1 << instruction->operand)));
+}
+
+static inline void execute_clr1_sfr_bit(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	const uint20_t absolute_address = special_function_register_to_absolute_address(instruction->data[0]);
+	const uint8_t value = read_data_u08(cpu, absolute_address);
+	write_data_u08(cpu, absolute_address, (uint8_t)(value & (uint8_t)~(1 << instruction->operand)));
+}
+
+static inline void execute_set1_cy(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	(void)instruction;
+	write_flags(cpu, rl78core_psw_flag_cy, rl78core_psw_flag_cy);
+}
+
+static inline void execute_clr1_cy(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	(void)instruction;
+	write_flags(cpu, rl78core_psw_flag_cy, 0);
+}
+
+static inline void execute_halt(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
+{
+	(void)instruction;
+	cpu->halted = true;
+	cpu->standby = rl78core_cpu_standby_halt;
+	cpu->leave = true;
+}
+
+static inline void execute_stop(rl78core_cpu_s* const cpu, const rl78core_cpu_instruction_s* const instruction)
 {
-	return rl78core_mem_read_u08(g_rl78core_cpu.pc++);
+	(void)instruction;
+	cpu->halted = true;
+	cpu->standby = rl78core_cpu_standby_stop;
+	cpu->leave = true;
+
+	// note: the stop mode stops the main clock, and with it the count clock of
+	// the timer array units.
+	rl78core_tau_freeze_r(cpu->machine);
 }
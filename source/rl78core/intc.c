@@ -0,0 +1,229 @@
+
+/**
+ * @file intc.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+
+#include "rl78core/intc.h"
+#include "rl78core/mem.h"
+#include "rl78core/cpu.h"
+
+#define rl78core_intc_block_low 0xFFFE0
+#define rl78core_intc_block_high 0xFFFD0
+#define rl78core_intc_sources_mask ((1ull << rl78core_intc_sources_count) - 1)
+
+typedef enum
+{
+	rl78core_intc_register_if,
+	rl78core_intc_register_mk,
+	rl78core_intc_register_pr0,
+	rl78core_intc_register_pr1,
+	rl78core_intc_registers_count,
+} rl78core_intc_register_e;
+
+/**
+ * @brief Get the address of the byte of a flag register, holding the flag of a
+ * provided source.
+ * 
+ * @param kind   flag register
+ * @param source source of the interrupt
+ * 
+ * @return uint20_t
+ */
+static uint20_t flag_address(const rl78core_intc_register_e kind, const uint8_t source);
+
+/**
+ * @brief Read the flags of all the sources from a flag register, so that the
+ * bit n holds the flag of the source n.
+ * 
+ * @param machine machine to operate on
+ * @param kind    flag register
+ * 
+ * @return uint64_t
+ */
+static uint64_t read_flags(rl78core_machine_s* const machine, const rl78core_intc_register_e kind);
+
+/**
+ * @brief Write the flags of all the sources to a flag register.
+ * 
+ * @param machine machine to operate on
+ * @param kind    flag register
+ * @param flags   flags of the sources
+ */
+static void write_flags(rl78core_machine_s* const machine, const rl78core_intc_register_e kind, const uint64_t flags);
+
+/**
+ * @brief Get the requested and unmasked interrupt sources.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return uint64_t
+ */
+static uint64_t pending_sources(rl78core_machine_s* const machine);
+
+/**
+ * @brief Get the lowest numbered source of a provided non-empty set of sources.
+ * 
+ * @param sources sources, so that the bit n is set for the source n
+ * 
+ * @return uint8_t
+ */
+static uint8_t lowest_source(const uint64_t sources);
+
+void rl78core_intc_init_r(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	write_flags(machine, rl78core_intc_register_if, 0);
+	write_flags(machine, rl78core_intc_register_mk, UINT64_MAX);
+	write_flags(machine, rl78core_intc_register_pr0, UINT64_MAX);
+	write_flags(machine, rl78core_intc_register_pr1, UINT64_MAX);
+	rl78core_intc_update_r(machine);
+}
+
+void rl78core_intc_update_r(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78core_cpu_set_interrupt_r(machine, 0 != pending_sources(machine));
+}
+
+void rl78core_intc_request_r(rl78core_machine_s* const machine, const uint8_t source)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(source < rl78core_intc_sources_count);
+	const uint20_t address = flag_address(rl78core_intc_register_if, source);
+	rl78core_mem_write_u08_r(machine, address, (uint8_t)(rl78core_mem_read_u08_r(machine, address) | (1 << (source % 8))));
+	rl78core_intc_update_r(machine);
+}
+
+bool_t rl78core_intc_requested_r(rl78core_machine_s* const machine, const uint8_t source)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(source < rl78core_intc_sources_count);
+	return 0 != (rl78core_mem_read_u08_r(machine, flag_address(rl78core_intc_register_if, source)) & (1 << (source % 8)));
+}
+
+uint8_t rl78core_intc_select_r(rl78core_machine_s* const machine, const uint8_t level)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(level < rl78core_intc_levels_count);
+	const uint64_t pending = pending_sources(machine);
+	const uint64_t pr0 = read_flags(machine, rl78core_intc_register_pr0);
+	const uint64_t pr1 = read_flags(machine, rl78core_intc_register_pr1);
+
+	// note: the sources of every level are selected with their PR1 and PR0 flags,
+	// and the first set one of them has the highest default priority.
+	const uint64_t levels[rl78core_intc_levels_count] =
+	{
+		pending & ~pr1 & ~pr0,
+		pending & ~pr1 & pr0,
+		pending & pr1 & ~pr0,
+		pending & pr1 & pr0,
+	};
+
+	for (uint8_t index = 0; index <= level; ++index)
+	{
+		if (levels[index] != 0)
+		{
+			return lowest_source(levels[index]);
+		}
+	}
+
+	return rl78core_intc_no_source;
+}
+
+uint8_t rl78core_intc_priority_r(rl78core_machine_s* const machine, const uint8_t source)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(source < rl78core_intc_sources_count);
+	const uint8_t pr0 = (uint8_t)((rl78core_mem_read_u08_r(machine, flag_address(rl78core_intc_register_pr0, source)) >> (source % 8)) & 1);
+	const uint8_t pr1 = (uint8_t)((rl78core_mem_read_u08_r(machine, flag_address(rl78core_intc_register_pr1, source)) >> (source % 8)) & 1);
+	return (uint8_t)((pr1 << 1) | pr0);
+}
+
+void rl78core_intc_acknowledge_r(rl78core_machine_s* const machine, const uint8_t source)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(source < rl78core_intc_sources_count);
+	const uint20_t address = flag_address(rl78core_intc_register_if, source);
+	rl78core_mem_write_u08_r(machine, address, (uint8_t)(rl78core_mem_read_u08_r(machine, address) & ~(1 << (source % 8))));
+	rl78core_intc_update_r(machine);
+}
+
+void rl78core_intc_init(void)
+{
+	rl78core_intc_init_r(rl78core_machine_default());
+}
+
+void rl78core_intc_update(void)
+{
+	rl78core_intc_update_r(rl78core_machine_default());
+}
+
+void rl78core_intc_request(const uint8_t source)
+{
+	rl78core_intc_request_r(rl78core_machine_default(), source);
+}
+
+bool_t rl78core_intc_requested(const uint8_t source)
+{
+	return rl78core_intc_requested_r(rl78core_machine_default(), source);
+}
+
+static uint20_t flag_address(const rl78core_intc_register_e kind, const uint8_t source)
+{
+	const uint20_t block = (source < 32) ? rl78core_intc_block_low : rl78core_intc_block_high;
+	return (uint20_t)(block + (4 * (uint20_t)kind) + ((source % 32) / 8));
+}
+
+static uint64_t read_flags(rl78core_machine_s* const machine, const rl78core_intc_register_e kind)
+{
+	uint64_t flags = 0;
+
+	for (uint8_t byte = 0; byte < 8; ++byte)
+	{
+		flags |= (uint64_t)rl78core_mem_read_u08_r(machine, flag_address(kind, (uint8_t)(byte * 8))) << (byte * 8);
+	}
+
+	return flags;
+}
+
+static void write_flags(rl78core_machine_s* const machine, const rl78core_intc_register_e kind, const uint64_t flags)
+{
+	for (uint8_t byte = 0; byte < 8; ++byte)
+	{
+		rl78core_mem_write_u08_r(machine, flag_address(kind, (uint8_t)(byte * 8)), (uint8_t)(flags >> (byte * 8)));
+	}
+}
+
+static uint64_t pending_sources(rl78core_machine_s* const machine)
+{
+	const uint64_t requests = read_flags(machine, rl78core_intc_register_if);
+	const uint64_t masks = read_flags(machine, rl78core_intc_register_mk);
+	return requests & ~masks & rl78core_intc_sources_mask;
+}
+
+static uint8_t lowest_source(const uint64_t sources)
+{
+	rl78misc_debug_assert(sources != 0);
+
+#if defined(__GNUC__)
+	return (uint8_t)__builtin_ctzll(sources);
+#else
+	uint8_t source = 0;
+
+	while (0 == ((sources >> source) & 1))
+	{
+		++source;
+	}
+
+	return source;
+#endif
+}
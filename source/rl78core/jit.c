@@ -0,0 +1,352 @@
+
+/**
+ * @file jit.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+#include "rl78misc/logger.h"
+
+#include "rl78core/jit.h"
+
+#if rl78core_jit_enabled
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+/**
+ * note: the emitted code is x86-64 machine code for the system v abi. The rbx
+ * register holds the pointer to the active registers bank for the whole code,
+ * and the rax, rcx, rdx, rsi, rdi registers are used as scratch registers.
+ */
+
+/**
+ * note: the modrm bytes of the `op ecx, imm32` instructions of the alu
+ * operations, with the 0x81 opcode.
+ */
+static const uint8_t g_rl78core_jit_alu_modrms[rl78core_jit_alus_count] =
+{
+	[rl78core_jit_alu_add] = 0xC1,
+	[rl78core_jit_alu_sub] = 0xE9,
+	[rl78core_jit_alu_and] = 0xE1,
+	[rl78core_jit_alu_or] = 0xC9,
+	[rl78core_jit_alu_xor] = 0xF1,
+};
+
+struct rl78core_jit_s
+{
+	#define rl78core_jit_arena_capacity 0x100000
+	uint8_t* arena;
+	uint64_t page_size;
+	uint64_t cursor;
+	uint64_t start;
+	bool_t overflow;
+	uint8_t* const* gpr_bank;
+};
+
+/**
+ * @brief Emit a provided byte into the arena.
+ * 
+ * @param jit  jit to emit with
+ * @param byte byte to emit
+ */
+static void emit_u08(rl78core_jit_s* const jit, const uint8_t byte);
+
+/**
+ * @brief Emit a provided 16-bit value into the arena, in little-endian order.
+ * 
+ * @param jit   jit to emit with
+ * @param value value to emit
+ */
+static void emit_u16(rl78core_jit_s* const jit, const uint16_t value);
+
+/**
+ * @brief Emit a provided 32-bit value into the arena, in little-endian order.
+ * 
+ * @param jit   jit to emit with
+ * @param value value to emit
+ */
+static void emit_u32(rl78core_jit_s* const jit, const uint32_t value);
+
+/**
+ * @brief Emit a provided 64-bit value into the arena, in little-endian order.
+ * 
+ * @param jit   jit to emit with
+ * @param value value to emit
+ */
+static void emit_u64(rl78core_jit_s* const jit, const uint64_t value);
+
+/**
+ * @brief Emit a load of the pointer to the active registers bank into rbx.
+ * 
+ * @param jit jit to emit with
+ */
+static void emit_load_gpr_bank(rl78core_jit_s* const jit);
+
+/**
+ * @brief Change the protection of the arena pages, which overlap a provided
+ * range of the arena.
+ * 
+ * @param jit        jit to protect the arena of
+ * @param start      start of the range
+ * @param end        end of the range
+ * @param executable whether to make the pages executable, or writable
+ * 
+ * @return bool_t whether the protection got changed
+ */
+static bool_t protect_arena(rl78core_jit_s* const jit, const uint64_t start, const uint64_t end, const bool_t executable);
+
+rl78core_jit_s* rl78core_jit_create(void)
+{
+	rl78core_jit_s* const jit = (rl78core_jit_s*)rl78misc_malloc(sizeof(rl78core_jit_s));
+	*jit = (rl78core_jit_s)
+	{
+		.arena = NULL,
+		.page_size = 0,
+		.cursor = 0,
+		.start = 0,
+		.overflow = false,
+		.gpr_bank = NULL,
+	};
+
+#if rl78core_jit_enabled
+	const long page_size = sysconf(_SC_PAGESIZE);
+
+	if ((page_size <= 0) || (0 != (page_size & (page_size - 1))) || (page_size > rl78core_jit_arena_capacity))
+	{
+		rl78misc_logger_warn("failed to query the page size. the jit will be unavailable.");
+		return jit;
+	}
+
+	void* const arena = mmap(NULL, rl78core_jit_arena_capacity,
+		PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	if (MAP_FAILED == arena)
+	{
+		rl78misc_logger_warn("failed to map the jit arena. the jit will be unavailable.");
+		return jit;
+	}
+
+	jit->arena = (uint8_t*)arena;
+	jit->page_size = (uint64_t)page_size;
+#endif
+
+	return jit;
+}
+
+void rl78core_jit_destroy(rl78core_jit_s* const jit)
+{
+	rl78misc_debug_assert(jit != NULL);
+
+#if rl78core_jit_enabled
+	if (rl78core_jit_available(jit))
+	{
+		(void)munmap(jit->arena, rl78core_jit_arena_capacity);
+	}
+#endif
+
+	(void)rl78misc_free(jit);
+}
+
+bool_t rl78core_jit_available(const rl78core_jit_s* const jit)
+{
+	rl78misc_debug_assert(jit != NULL);
+	return (jit->arena != NULL);
+}
+
+void rl78core_jit_reset(rl78core_jit_s* const jit)
+{
+	rl78misc_debug_assert(jit != NULL);
+	jit->cursor = 0;
+	jit->start = 0;
+	jit->overflow = false;
+}
+
+void rl78core_jit_begin(rl78core_jit_s* const jit, uint8_t* const* const gpr_bank)
+{
+	rl78misc_debug_assert(rl78core_jit_available(jit));
+	rl78misc_debug_assert(gpr_bank != NULL);
+	jit->start = jit->cursor;
+	jit->overflow = false;
+	jit->gpr_bank = gpr_bank;
+
+	// note: the page of the new code may hold the tail of the previous code.
+	if (!protect_arena(jit, jit->cursor, rl78core_jit_arena_capacity, false))
+	{
+		jit->overflow = true;
+	}
+
+	emit_u08(jit, 0x53);  // push rbx
+	emit_load_gpr_bank(jit);
+}
+
+void rl78core_jit_emit_gpr08_imm(rl78core_jit_s* const jit, const uint8_t gpr08, const uint8_t value)
+{
+	emit_u08(jit, 0xC6); emit_u08(jit, 0x43); emit_u08(jit, gpr08);  // mov byte [rbx + gpr08], imm8
+	emit_u08(jit, value);
+}
+
+void rl78core_jit_emit_gpr16_imm(rl78core_jit_s* const jit, const uint8_t gpr16, const uint16_t value)
+{
+	emit_u08(jit, 0x66); emit_u08(jit, 0xC7); emit_u08(jit, 0x43); emit_u08(jit, gpr16);  // mov word [rbx + gpr16], imm16
+	emit_u16(jit, value);
+}
+
+void rl78core_jit_emit_gpr08_gpr08(rl78core_jit_s* const jit, const uint8_t destination, const uint8_t source)
+{
+	emit_u08(jit, 0x0F); emit_u08(jit, 0xB6); emit_u08(jit, 0x43); emit_u08(jit, source);  // movzx eax, byte [rbx + source]
+	emit_u08(jit, 0x88); emit_u08(jit, 0x43); emit_u08(jit, destination);                  // mov byte [rbx + destination], al
+}
+
+void rl78core_jit_emit_gpr08_alu(rl78core_jit_s* const jit, const rl78core_jit_alu_e alu, const uint8_t gpr08, const uint8_t value, const bool_t store, uint8_t* const record, const uint8_t id)
+{
+	rl78misc_debug_assert(alu < rl78core_jit_alus_count);
+	rl78misc_debug_assert(record != NULL);
+	emit_u08(jit, 0x0F); emit_u08(jit, 0xB6); emit_u08(jit, 0x43); emit_u08(jit, gpr08);      // movzx eax, byte [rbx + gpr08]
+	emit_u08(jit, 0x89); emit_u08(jit, 0xC1);                                                  // mov ecx, eax
+	emit_u08(jit, 0x81); emit_u08(jit, g_rl78core_jit_alu_modrms[alu]); emit_u32(jit, value);  // op ecx, imm32
+
+	if (store)
+	{
+		emit_u08(jit, 0x88); emit_u08(jit, 0x4B); emit_u08(jit, gpr08);  // mov byte [rbx + gpr08], cl
+	}
+
+	emit_u08(jit, 0x48); emit_u08(jit, 0xBA); emit_u64(jit, (uint64_t)(uintptr_t)record);  // mov rdx, imm64
+	emit_u08(jit, 0xC6); emit_u08(jit, 0x02); emit_u08(jit, id);                           // mov byte [rdx], imm8
+	emit_u08(jit, 0x88); emit_u08(jit, 0x42); emit_u08(jit, 0x01);                         // mov byte [rdx + 1], al
+	emit_u08(jit, 0xC6); emit_u08(jit, 0x42); emit_u08(jit, 0x02); emit_u08(jit, value);   // mov byte [rdx + 2], imm8
+	emit_u08(jit, 0x88); emit_u08(jit, 0x4A); emit_u08(jit, 0x03);                         // mov byte [rdx + 3], cl
+}
+
+void rl78core_jit_emit_store_u32(rl78core_jit_s* const jit, uint32_t* const address, const uint32_t value)
+{
+	rl78misc_debug_assert(address != NULL);
+	emit_u08(jit, 0x48); emit_u08(jit, 0xB8); emit_u64(jit, (uint64_t)(uintptr_t)address);  // mov rax, imm64
+	emit_u08(jit, 0xC7); emit_u08(jit, 0x00); emit_u32(jit, value);                         // mov dword [rax], imm32
+}
+
+void rl78core_jit_emit_add_u64(rl78core_jit_s* const jit, uint64_t* const address, const uint32_t value)
+{
+	rl78misc_debug_assert(address != NULL);
+	rl78misc_debug_assert(value <= 0x7FFFFFFF);
+	emit_u08(jit, 0x48); emit_u08(jit, 0xB8); emit_u64(jit, (uint64_t)(uintptr_t)address);  // mov rax, imm64
+	emit_u08(jit, 0x48); emit_u08(jit, 0x81); emit_u08(jit, 0x00); emit_u32(jit, value);    // add qword [rax], imm32
+}
+
+void rl78core_jit_emit_call(rl78core_jit_s* const jit, const uint64_t function, const void* const first, const void* const second)
+{
+	rl78misc_debug_assert(function != 0);
+	emit_u08(jit, 0x48); emit_u08(jit, 0xBF); emit_u64(jit, (uint64_t)(uintptr_t)first);   // mov rdi, imm64
+	emit_u08(jit, 0x48); emit_u08(jit, 0xBE); emit_u64(jit, (uint64_t)(uintptr_t)second);  // mov rsi, imm64
+	emit_u08(jit, 0x48); emit_u08(jit, 0xB8); emit_u64(jit, function);                     // mov rax, imm64
+	emit_u08(jit, 0xFF); emit_u08(jit, 0xD0);                                              // call rax
+	emit_load_gpr_bank(jit);
+}
+
+void rl78core_jit_emit_call_if(rl78core_jit_s* const jit, const uint8_t* const byte, const uint8_t low, const uint8_t high, const uint64_t function, const void* const argument)
+{
+	rl78misc_debug_assert(byte != NULL);
+	rl78misc_debug_assert(low <= high);
+	rl78misc_debug_assert(high <= 0x7F);
+	emit_u08(jit, 0x48); emit_u08(jit, 0xB8); emit_u64(jit, (uint64_t)(uintptr_t)byte);  // mov rax, imm64
+	emit_u08(jit, 0x0F); emit_u08(jit, 0xB6); emit_u08(jit, 0x00);                       // movzx eax, byte [rax]
+	emit_u08(jit, 0x83); emit_u08(jit, 0xE8); emit_u08(jit, low);                        // sub eax, imm8
+	emit_u08(jit, 0x83); emit_u08(jit, 0xF8); emit_u08(jit, (uint8_t)(high - low));      // cmp eax, imm8
+	emit_u08(jit, 0x77); emit_u08(jit, 0x00);                                            // ja rel8
+	const uint64_t jump = jit->cursor;
+	rl78core_jit_emit_call(jit, function, argument, NULL);
+
+	// note: the jump skips the call, whose length is known once it is emitted.
+	if (!jit->overflow)
+	{
+		rl78misc_debug_assert((jit->cursor - jump) <= 0x7F);
+		jit->arena[jump - 1] = (uint8_t)(jit->cursor - jump);
+	}
+}
+
+void rl78core_jit_emit_return_if(rl78core_jit_s* const jit, const bool_t* const flag, const uint32_t count)
+{
+	rl78misc_debug_assert(flag != NULL);
+	emit_u08(jit, 0x48); emit_u08(jit, 0xB8); emit_u64(jit, (uint64_t)(uintptr_t)flag);  // mov rax, imm64
+	emit_u08(jit, 0x80); emit_u08(jit, 0x38); emit_u08(jit, 0x00);                       // cmp byte [rax], 0
+	emit_u08(jit, 0x74); emit_u08(jit, 0x07);                                            // je +7
+	emit_u08(jit, 0xB8); emit_u32(jit, count);                                           // mov eax, imm32
+	emit_u08(jit, 0x5B);                                                                 // pop rbx
+	emit_u08(jit, 0xC3);                                                                 // ret
+}
+
+rl78core_jit_code_t rl78core_jit_end(rl78core_jit_s* const jit, const uint32_t count)
+{
+	emit_u08(jit, 0xB8); emit_u32(jit, count);  // mov eax, imm32
+	emit_u08(jit, 0x5B);                        // pop rbx
+	emit_u08(jit, 0xC3);                        // ret
+
+	if (jit->overflow || !protect_arena(jit, jit->start, jit->cursor, true))
+	{
+		jit->cursor = jit->start;
+		return NULL;
+	}
+
+	// note: iso c does not allow converting object pointers to function pointers.
+	const void* const start = &jit->arena[jit->start];
+	rl78core_jit_code_t code = NULL;
+	rl78misc_memcpy(&code, &start, sizeof(code));
+	return code;
+}
+
+static void emit_u08(rl78core_jit_s* const jit, const uint8_t byte)
+{
+	if (jit->overflow || (jit->cursor >= rl78core_jit_arena_capacity))
+	{
+		jit->overflow = true;
+		return;
+	}
+
+	jit->arena[jit->cursor++] = byte;
+}
+
+static void emit_u16(rl78core_jit_s* const jit, const uint16_t value)
+{
+	emit_u08(jit, (uint8_t)(value & 0xFF));
+	emit_u08(jit, (uint8_t)((value >> 8) & 0xFF));
+}
+
+static void emit_u32(rl78core_jit_s* const jit, const uint32_t value)
+{
+	emit_u16(jit, (uint16_t)(value & 0xFFFF));
+	emit_u16(jit, (uint16_t)((value >> 16) & 0xFFFF));
+}
+
+static void emit_u64(rl78core_jit_s* const jit, const uint64_t value)
+{
+	emit_u32(jit, (uint32_t)(value & 0xFFFFFFFF));
+	emit_u32(jit, (uint32_t)((value >> 32) & 0xFFFFFFFF));
+}
+
+static void emit_load_gpr_bank(rl78core_jit_s* const jit)
+{
+	emit_u08(jit, 0x48); emit_u08(jit, 0xB8); emit_u64(jit, (uint64_t)(uintptr_t)jit->gpr_bank);  // mov rax, imm64
+	emit_u08(jit, 0x48); emit_u08(jit, 0x8B); emit_u08(jit, 0x18);                                // mov rbx, [rax]
+}
+
+static bool_t protect_arena(rl78core_jit_s* const jit, const uint64_t start, const uint64_t end, const bool_t executable)
+{
+#if rl78core_jit_enabled
+	const uint64_t first = start & ~(jit->page_size - 1);
+	const uint64_t last = (end + jit->page_size - 1) & ~(jit->page_size - 1);
+	const int protection = executable ? (PROT_READ | PROT_EXEC) : (PROT_READ | PROT_WRITE);
+	return (0 == mprotect(&jit->arena[first], last - first, protection));
+#else
+	(void)jit;
+	(void)start;
+	(void)end;
+	(void)executable;
+	return false;
+#endif
+}
@@ -0,0 +1,675 @@
+
+/**
+ * @file loader.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+#include "rl78misc/logger.h"
+#include "rl78misc/file.h"
+
+#include "rl78core/loader.h"
+
+#include <string.h>
+
+// note: the intel hex records carry up to 255 data bytes, next to 5 bytes of header and checksum.
+#define rl78core_loader_record_capacity 260
+
+#define rl78core_loader_elf_header_size 52
+#define rl78core_loader_elf_segment_size 32
+#define rl78core_loader_elf_section_size 40
+#define rl78core_loader_elf_symbol_size 16
+#define rl78core_loader_elf_machine_rl78 197
+#define rl78core_loader_elf_segment_load 1
+#define rl78core_loader_elf_section_symtab 2
+
+typedef enum
+{
+	rl78core_loader_format_none,
+	rl78core_loader_format_ihex,
+	rl78core_loader_format_srec,
+} rl78core_loader_format_e;
+
+typedef struct
+{
+	const char_t* name;
+	uint64_t line;
+	rl78core_mem_image_s* image;
+	rl78core_loader_format_e format;
+	uint32_t base;  // note: base address set by the intel hex extended address records.
+	bool_t ended;
+} rl78core_loader_state_s;
+
+/**
+ * @brief Add the symbols of an elf symbol table section to the index.
+ * 
+ * @param data    contents of the file
+ * @param length  length of the contents
+ * @param section offset of the header of the symbol table section
+ * @param strings offset of the header of the linked string table section
+ * @param symbols index to add the symbols to
+ * 
+ * @return bool_t false if the sections exceed the file
+ */
+static bool_t load_elf_symbols(const uint8_t* const data, const uint64_t length, const uint64_t section, const uint64_t strings, rl78core_symbols_s* const symbols);
+
+/**
+ * @brief Read a little-endian 16-bit value of an elf file.
+ * 
+ * @param data   contents of the file
+ * @param offset offset of the value
+ * 
+ * @return uint16_t
+ */
+static uint16_t read_elf_u16(const uint8_t* const data, const uint64_t offset);
+
+/**
+ * @brief Read a little-endian 32-bit value of an elf file.
+ * 
+ * @param data   contents of the file
+ * @param offset offset of the value
+ * 
+ * @return uint32_t
+ */
+static uint32_t read_elf_u32(const uint8_t* const data, const uint64_t offset);
+
+/**
+ * @brief Parse a record, and choose the format of the binary by the first one.
+ * 
+ * @param state  state of the loading
+ * @param record text of the record, without the line ending
+ * @param length length of the record
+ * 
+ * @return bool_t false if the record is invalid
+ */
+static bool_t parse_record(rl78core_loader_state_s* const state, const char_t* const record, const uint64_t length);
+
+/**
+ * @brief Parse an intel hex record.
+ * 
+ * @param state  state of the loading
+ * @param record text of the record, without the line ending
+ * @param length length of the record
+ * 
+ * @return bool_t false if the record is invalid
+ */
+static bool_t parse_ihex(rl78core_loader_state_s* const state, const char_t* const record, const uint64_t length);
+
+/**
+ * @brief Parse a s-record.
+ * 
+ * @param state  state of the loading
+ * @param record text of the record, without the line ending
+ * @param length length of the record
+ * 
+ * @return bool_t false if the record is invalid
+ */
+static bool_t parse_srec(rl78core_loader_state_s* const state, const char_t* const record, const uint64_t length);
+
+/**
+ * @brief Copy the data of a record into the image.
+ * 
+ * @param state   state of the loading
+ * @param address address of the data
+ * @param data    data of the record
+ * @param length  length of the data
+ * 
+ * @return bool_t false if the data does not fit into the address space
+ */
+static bool_t load_data(rl78core_loader_state_s* const state, const uint32_t address, const uint8_t* const data, const uint64_t length);
+
+/**
+ * @brief Decode a provided count of hex digit pairs into bytes. The digits are
+ * decoded eight at a time with @ref decode_hex_swar, and the rest one by one.
+ * 
+ * @param text  text of the digits
+ * @param count count of the bytes to decode
+ * @param bytes bytes to decode into
+ * 
+ * @return bool_t false if the text contains a non-hex digit
+ */
+static bool_t decode_hex(const char_t* const text, const uint64_t count, uint8_t* const bytes);
+
+/**
+ * @brief Decode eight hex digits into four bytes, within a 64-bit register.
+ * 
+ * @param text  text of the digits
+ * @param bytes bytes to decode into
+ * 
+ * @return bool_t false if the text contains a non-hex digit
+ */
+static bool_t decode_hex_swar(const char_t* const text, uint8_t* const bytes);
+
+/**
+ * @brief Decode a hex digit.
+ * 
+ * @param digit digit to decode
+ * 
+ * @return uint8_t value of the digit, or 0xFF if it is not a hex digit
+ */
+static uint8_t decode_nibble(const char_t digit);
+
+bool_t rl78core_loader_load(const char_t* const path, rl78core_mem_image_s* const image, rl78core_symbols_s* const symbols)
+{
+	rl78misc_debug_assert(path != NULL);
+	rl78misc_debug_assert(image != NULL);
+
+	uint64_t length = 0;
+	const uint8_t* const contents = rl78misc_file_map(path, &length);
+
+	if (NULL == contents)
+	{
+		return false;
+	}
+
+	const bool_t loaded = rl78core_loader_load_contents(path, contents, length, image, symbols);
+	rl78misc_file_unmap(contents, length);
+	return loaded;
+}
+
+bool_t rl78core_loader_load_contents(const char_t* const name, const uint8_t* const contents, const uint64_t length, rl78core_mem_image_s* const image, rl78core_symbols_s* const symbols)
+{
+	rl78misc_debug_assert(name != NULL);
+	rl78misc_debug_assert(contents != NULL || 0 == length);
+
+	if (length >= 4 && 0 == rl78misc_memcmp(contents, (const uint8_t*)"\x7F" "ELF", 4))
+	{
+		return rl78core_loader_load_elf(name, contents, length, image, symbols);
+	}
+
+	return rl78core_loader_load_text(name, (const char_t*)contents, length, image);
+}
+
+bool_t rl78core_loader_load_text(const char_t* const name, const char_t* const text, const uint64_t length, rl78core_mem_image_s* const image)
+{
+	rl78misc_debug_assert(name != NULL);
+	rl78misc_debug_assert(text != NULL || 0 == length);
+	rl78misc_debug_assert(image != NULL);
+
+	rl78core_loader_state_s state =
+	{
+		.name = name,
+		.line = 0,
+		.image = image,
+		.format = rl78core_loader_format_none,
+		.base = 0,
+		.ended = false,
+	};
+
+	uint64_t offset = 0;
+
+	while (offset < length && !state.ended)
+	{
+		++state.line;
+		const char_t* const record = &text[offset];
+		const char_t* const newline = (const char_t*)memchr(record, '\n', length - offset);
+		uint64_t record_length = (newline != NULL) ? (uint64_t)(newline - record) : (length - offset);
+		offset += record_length + 1;
+
+		// note: strips the carriage return of the windows line endings, and the trailing blanks.
+		while (record_length > 0 && ('\r' == record[record_length - 1] || ' ' == record[record_length - 1] || '\t' == record[record_length - 1]))
+		{
+			--record_length;
+		}
+
+		if (record_length > 0 && !parse_record(&state, record, record_length))
+		{
+			return false;
+		}
+	}
+
+	if (rl78core_loader_format_none == state.format)
+	{
+		rl78misc_logger_error("%s: no records were found.", name);
+		return false;
+	}
+
+	if (!state.ended)
+	{
+		rl78misc_logger_warn("%s: missing end record.", name);
+	}
+
+	return true;
+}
+
+bool_t rl78core_loader_load_elf(const char_t* const name, const uint8_t* const data, const uint64_t length, rl78core_mem_image_s* const image, rl78core_symbols_s* const symbols)
+{
+	rl78misc_debug_assert(name != NULL);
+	rl78misc_debug_assert(data != NULL || 0 == length);
+	rl78misc_debug_assert(image != NULL);
+
+	if (length < rl78core_loader_elf_header_size || rl78misc_memcmp(data, (const uint8_t*)"\x7F" "ELF", 4) != 0)
+	{
+		rl78misc_logger_error("%s: not an elf file.", name);
+		return false;
+	}
+
+	if (data[4] != 1 || data[5] != 1)
+	{
+		rl78misc_logger_error("%s: only the 32-bit little-endian elf files are supported.", name);
+		return false;
+	}
+
+	if (read_elf_u16(data, 18) != rl78core_loader_elf_machine_rl78)
+	{
+		rl78misc_logger_error("%s: not an rl78 elf file, the machine is %u.", name, read_elf_u16(data, 18));
+		return false;
+	}
+
+	const uint64_t segments = read_elf_u32(data, 28);
+	const uint64_t segment_size = read_elf_u16(data, 42);
+	const uint64_t segments_count = read_elf_u16(data, 44);
+
+	if (segments_count > 0 && (segment_size < rl78core_loader_elf_segment_size || segments > length || (segments_count * segment_size) > (length - segments)))
+	{
+		rl78misc_logger_error("%s: the program headers exceed the file.", name);
+		return false;
+	}
+
+	uint64_t loaded_count = 0;
+
+	for (uint64_t index = 0; index < segments_count; ++index)
+	{
+		const uint64_t segment = segments + (index * segment_size);
+		const uint64_t offset = read_elf_u32(data, segment + 4);
+		const uint64_t address = read_elf_u32(data, segment + 12);
+		const uint64_t size = read_elf_u32(data, segment + 16);
+
+		if (read_elf_u32(data, segment) != rl78core_loader_elf_segment_load || 0 == size)
+		{
+			continue;
+		}
+
+		if (offset > length || size > (length - offset))
+		{
+			rl78misc_logger_error("%s: the segment %lu exceeds the file.", name, index);
+			return false;
+		}
+
+		if (address > rl78core_mem_address_space_size || size > (rl78core_mem_address_space_size - address))
+		{
+			rl78misc_logger_error("%s: the segment %lu at 0x%lX exceeds the address space.", name, index, address);
+			return false;
+		}
+
+		// note: the segments are placed at their physical addresses, where the initialized data are kept.
+		rl78core_mem_image_load(image, (uint20_t)address, &data[offset], (uint20_t)size);
+		++loaded_count;
+	}
+
+	if (0 == loaded_count)
+	{
+		rl78misc_logger_error("%s: no loadable segments were found.", name);
+		return false;
+	}
+
+	if (NULL == symbols)
+	{
+		return true;
+	}
+
+	const uint64_t sections = read_elf_u32(data, 32);
+	const uint64_t section_size = read_elf_u16(data, 46);
+	const uint64_t sections_count = read_elf_u16(data, 48);
+
+	if (sections_count > 0 && (section_size < rl78core_loader_elf_section_size || sections > length || (sections_count * section_size) > (length - sections)))
+	{
+		rl78misc_logger_error("%s: the section headers exceed the file.", name);
+		return false;
+	}
+
+	for (uint64_t index = 0; index < sections_count; ++index)
+	{
+		const uint64_t section = sections + (index * section_size);
+		const uint64_t link = read_elf_u32(data, section + 24);
+
+		if (read_elf_u32(data, section + 4) != rl78core_loader_elf_section_symtab)
+		{
+			continue;
+		}
+
+		if (link >= sections_count || !load_elf_symbols(data, length, section, sections + (link * section_size), symbols))
+		{
+			rl78misc_logger_error("%s: the symbol table section %lu is invalid.", name, index);
+			return false;
+		}
+	}
+
+	rl78core_symbols_sort(symbols);
+	return true;
+}
+
+static bool_t load_elf_symbols(const uint8_t* const data, const uint64_t length, const uint64_t section, const uint64_t strings, rl78core_symbols_s* const symbols)
+{
+	const uint64_t offset = read_elf_u32(data, section + 16);
+	const uint64_t size = read_elf_u32(data, section + 20);
+	const uint64_t strings_offset = read_elf_u32(data, strings + 16);
+	const uint64_t strings_size = read_elf_u32(data, strings + 20);
+
+	if (offset > length || size > (length - offset) || strings_offset > length || strings_size > (length - strings_offset))
+	{
+		return false;
+	}
+
+	const char_t* const names = (const char_t*)&data[strings_offset];
+
+	// note: the first symbol is the reserved undefined one.
+	for (uint64_t symbol = offset + rl78core_loader_elf_symbol_size; (symbol + rl78core_loader_elf_symbol_size) <= (offset + size); symbol += rl78core_loader_elf_symbol_size)
+	{
+		const uint64_t name_offset = read_elf_u32(data, symbol);
+		const uint32_t address = read_elf_u32(data, symbol + 4);
+		const uint32_t symbol_size = read_elf_u32(data, symbol + 8);
+		const uint8_t type = data[symbol + 12] & 0x0F;
+		const uint16_t section_index = read_elf_u16(data, symbol + 14);
+
+		// note: only the defined untyped, object and function symbols are indexed.
+		if (type > 2 || 0 == section_index || 0 == name_offset || name_offset >= strings_size || address >= rl78core_mem_address_space_size)
+		{
+			continue;
+		}
+
+		if (NULL == memchr(&names[name_offset], '\0', strings_size - name_offset))
+		{
+			return false;
+		}
+
+		rl78core_symbols_add(symbols, &names[name_offset], (uint20_t)address, symbol_size);
+	}
+
+	return true;
+}
+
+static uint16_t read_elf_u16(const uint8_t* const data, const uint64_t offset)
+{
+	return (uint16_t)(data[offset] | (data[offset + 1] << 8));
+}
+
+static uint32_t read_elf_u32(const uint8_t* const data, const uint64_t offset)
+{
+	return (uint32_t)data[offset] | ((uint32_t)data[offset + 1] << 8) | ((uint32_t)data[offset + 2] << 16) | ((uint32_t)data[offset + 3] << 24);
+}
+
+static bool_t parse_record(rl78core_loader_state_s* const state, const char_t* const record, const uint64_t length)
+{
+	const rl78core_loader_format_e format =
+		(':' == record[0]) ? rl78core_loader_format_ihex :
+		('S' == record[0]) ? rl78core_loader_format_srec :
+		rl78core_loader_format_none;
+
+	if (rl78core_loader_format_none == format || (state->format != rl78core_loader_format_none && state->format != format))
+	{
+		rl78misc_logger_error("%s:%lu: unexpected start of a record: '%c'.", state->name, state->line, record[0]);
+		return false;
+	}
+
+	state->format = format;
+	return (rl78core_loader_format_ihex == format) ? parse_ihex(state, record, length) : parse_srec(state, record, length);
+}
+
+static bool_t parse_ihex(rl78core_loader_state_s* const state, const char_t* const record, const uint64_t length)
+{
+	// note: a record is `:LLAAAATT<data>CC`, and all its bytes sum up to zero.
+	const uint64_t count = (length - 1) / 2;
+	uint8_t bytes[rl78core_loader_record_capacity];
+
+	if (length < 11 || (length - 1) % 2 != 0 || count > rl78core_loader_record_capacity)
+	{
+		rl78misc_logger_error("%s:%lu: malformed intel hex record.", state->name, state->line);
+		return false;
+	}
+
+	if (!decode_hex(&record[1], count, bytes))
+	{
+		rl78misc_logger_error("%s:%lu: invalid hex digit in the record.", state->name, state->line);
+		return false;
+	}
+
+	if (count != (uint64_t)bytes[0] + 5)
+	{
+		rl78misc_logger_error("%s:%lu: malformed intel hex record.", state->name, state->line);
+		return false;
+	}
+
+	uint8_t sum = 0;
+
+	for (uint64_t index = 0; index < count; ++index)
+	{
+		sum = (uint8_t)(sum + bytes[index]);
+	}
+
+	if (sum != 0)
+	{
+		rl78misc_logger_error("%s:%lu: checksum mismatch of the record.", state->name, state->line);
+		return false;
+	}
+
+	const uint8_t data_length = bytes[0];
+	const uint32_t offset = ((uint32_t)bytes[1] << 8) | bytes[2];
+	const uint8_t* const data = &bytes[4];
+
+	switch (bytes[3])
+	{
+		case 0x00:
+		{
+			return load_data(state, state->base + offset, data, data_length);
+		}
+
+		case 0x01:
+		{
+			state->ended = true;
+			return true;
+		}
+
+		case 0x02:
+		case 0x04:
+		{
+			if (data_length != 2)
+			{
+				rl78misc_logger_error("%s:%lu: malformed extended address record.", state->name, state->line);
+				return false;
+			}
+
+			const uint32_t value = ((uint32_t)data[0] << 8) | data[1];
+			state->base = (0x02 == bytes[3]) ? (value << 4) : (value << 16);
+			return true;
+		}
+
+		case 0x03:
+		case 0x05:
+		{
+			// note: the start address records are ignored, as the cpu starts from its reset vector.
+			return true;
+		}
+
+		default:
+		{
+			rl78misc_logger_error("%s:%lu: unknown intel hex record type 0x%02X.", state->name, state->line, bytes[3]);
+			return false;
+		}
+	}
+}
+
+static bool_t parse_srec(rl78core_loader_state_s* const state, const char_t* const record, const uint64_t length)
+{
+	// note: a record is `St<count><address><data><checksum>`, and all its bytes sum up to 0xFF.
+	static const uint8_t address_sizes[10] = { 2, 2, 3, 4, 0, 2, 3, 4, 3, 2 };
+	const uint64_t count = (length - 2) / 2;
+	uint8_t bytes[rl78core_loader_record_capacity];
+
+	if (length < 4 || length % 2 != 0 || count > rl78core_loader_record_capacity)
+	{
+		rl78misc_logger_error("%s:%lu: malformed s-record.", state->name, state->line);
+		return false;
+	}
+
+	if (record[1] < '0' || record[1] > '9' || 0 == address_sizes[record[1] - '0'])
+	{
+		rl78misc_logger_error("%s:%lu: unknown s-record type '%c'.", state->name, state->line, record[1]);
+		return false;
+	}
+
+	if (!decode_hex(&record[2], count, bytes))
+	{
+		rl78misc_logger_error("%s:%lu: invalid hex digit in the record.", state->name, state->line);
+		return false;
+	}
+
+	const uint8_t address_size = address_sizes[record[1] - '0'];
+
+	if (count != (uint64_t)bytes[0] + 1 || count < (uint64_t)address_size + 2)
+	{
+		rl78misc_logger_error("%s:%lu: malformed s-record.", state->name, state->line);
+		return false;
+	}
+
+	uint8_t sum = 0;
+
+	for (uint64_t index = 0; index < count; ++index)
+	{
+		sum = (uint8_t)(sum + bytes[index]);
+	}
+
+	if (sum != 0xFF)
+	{
+		rl78misc_logger_error("%s:%lu: checksum mismatch of the record.", state->name, state->line);
+		return false;
+	}
+
+	uint32_t address = 0;
+
+	for (uint8_t index = 0; index < address_size; ++index)
+	{
+		address = (address << 8) | bytes[1 + index];
+	}
+
+	switch (record[1])
+	{
+		case '1':
+		case '2':
+		case '3':
+		{
+			return load_data(state, address, &bytes[1 + address_size], count - address_size - 2);
+		}
+
+		case '7':
+		case '8':
+		case '9':
+		{
+			state->ended = true;
+			return true;
+		}
+
+		default:
+		{
+			// note: the header and the count records are ignored.
+			return true;
+		}
+	}
+}
+
+static bool_t load_data(rl78core_loader_state_s* const state, const uint32_t address, const uint8_t* const data, const uint64_t length)
+{
+	if (address > rl78core_mem_address_space_size || length > (rl78core_mem_address_space_size - address))
+	{
+		rl78misc_logger_error("%s:%lu: the record at 0x%X exceeds the address space.", state->name, state->line, address);
+		return false;
+	}
+
+	rl78core_mem_image_load(state->image, (uint20_t)address, data, (uint20_t)length);
+	return true;
+}
+
+static bool_t decode_hex(const char_t* const text, const uint64_t count, uint8_t* const bytes)
+{
+	uint64_t index = 0;
+
+	for (; index + 4 <= count; index += 4)
+	{
+		if (!decode_hex_swar(&text[index * 2], &bytes[index]))
+		{
+			return false;
+		}
+	}
+
+	for (; index < count; ++index)
+	{
+		const uint8_t high = decode_nibble(text[index * 2]);
+		const uint8_t low = decode_nibble(text[(index * 2) + 1]);
+
+		if ((high | low) > 0x0F)
+		{
+			return false;
+		}
+
+		bytes[index] = (uint8_t)((high << 4) | low);
+	}
+
+	return true;
+}
+
+static bool_t decode_hex_swar(const char_t* const text, uint8_t* const bytes)
+{
+	#define rl78core_loader_repeat(_byte) ((uint64_t)(_byte) * 0x0101010101010101)
+
+	uint64_t digits = 0;
+	rl78misc_memcpy(&digits, text, sizeof(digits));
+
+#if defined(__GNUC__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+	digits = __builtin_bswap64(digits);
+#endif
+
+	// note: with the high bits clear, adding to or subtracting from the bytes
+	// never carries into the next byte, so the high bit of every byte tells
+	// whether it falls within a range.
+	if ((digits & rl78core_loader_repeat(0x80)) != 0)
+	{
+		return false;
+	}
+
+	const uint64_t lower = digits | rl78core_loader_repeat(0x20);
+	const uint64_t decimals = (digits + rl78core_loader_repeat(0x80 - '0')) & (rl78core_loader_repeat(0x80 + '9') - digits);
+	const uint64_t letters = (lower + rl78core_loader_repeat(0x80 - 'a')) & (rl78core_loader_repeat(0x80 + 'f') - lower);
+
+	if (((decimals | letters) & rl78core_loader_repeat(0x80)) != rl78core_loader_repeat(0x80))
+	{
+		return false;
+	}
+
+	// note: the letters get 9 added to their low nibble, then the nibbles get
+	// paired into the even bytes, and the even bytes get packed together.
+	uint64_t value = (digits & rl78core_loader_repeat(0x0F)) + (((letters & rl78core_loader_repeat(0x80)) >> 7) * 9);
+	value = ((value << 4) | (value >> 8)) & 0x00FF00FF00FF00FF;
+	value = (value | (value >> 8)) & 0x0000FFFF0000FFFF;
+	value = (value | (value >> 16)) & 0x00000000FFFFFFFF;
+
+	bytes[0] = (uint8_t)(value & 0xFF);
+	bytes[1] = (uint8_t)((value >> 8) & 0xFF);
+	bytes[2] = (uint8_t)((value >> 16) & 0xFF);
+	bytes[3] = (uint8_t)((value >> 24) & 0xFF);
+	return true;
+
+	#undef rl78core_loader_repeat
+}
+
+static uint8_t decode_nibble(const char_t digit)
+{
+	if (digit >= '0' && digit <= '9')
+	{
+		return (uint8_t)(digit - '0');
+	}
+
+	const char_t lower = (char_t)(digit | 0x20);
+
+	if (lower >= 'a' && lower <= 'f')
+	{
+		return (uint8_t)(lower - 'a' + 10);
+	}
+
+	return 0xFF;
+}
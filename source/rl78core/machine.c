@@ -0,0 +1,64 @@
+
+/**
+ * @file machine.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+
+#include "rl78core/machine.h"
+#include "rl78core/mem.h"
+#include "rl78core/cpu.h"
+#include "rl78core/sched.h"
+#include "rl78core/intc.h"
+#include "rl78core/tau.h"
+
+static rl78core_machine_s* g_rl78core_machine_default = NULL;
+
+rl78core_machine_s* rl78core_machine_create(void)
+{
+	rl78core_machine_s* const machine = (rl78core_machine_s*)rl78misc_malloc(sizeof(rl78core_machine_s));
+	machine->mem = rl78core_mem_create(machine);
+	machine->cpu = rl78core_cpu_create(machine);
+	machine->sched = rl78core_sched_create();
+	machine->tau = rl78core_tau_create(machine);
+	rl78core_machine_init(machine);
+	return machine;
+}
+
+void rl78core_machine_destroy(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(machine != g_rl78core_machine_default);
+	rl78core_tau_destroy(machine->tau);
+	rl78core_sched_destroy(machine->sched);
+	rl78core_cpu_destroy(machine->cpu);
+	rl78core_mem_destroy(machine->mem);
+	(void)rl78misc_free(machine);
+}
+
+void rl78core_machine_init(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78core_mem_init_r(machine);
+	rl78core_cpu_init_r(machine);
+	rl78core_sched_init_r(machine);
+	rl78core_intc_init_r(machine);
+	rl78core_tau_init_r(machine);
+}
+
+rl78core_machine_s* rl78core_machine_default(void)
+{
+	if (NULL == g_rl78core_machine_default)
+	{
+		g_rl78core_machine_default = rl78core_machine_create();
+	}
+
+	return g_rl78core_machine_default;
+}
@@ -15,61 +15,627 @@
 
 #include "rl78core/mem.h"
 
+/**
+ * note: the memory is mapped with a page table. The pages of the ordinary memory
+ * point straight to their host memory, so the reads and writes of them cost a
+ * table lookup plus a load or a store. The pages with mapped i/o handlers, and
+ * the watched code pages for writes, are mapped to NULL, and are accessed on the
+ * slow path instead.
+ * 
+ * The host memory of a page is committed on the first write to it. Until then,
+ * the page is read from the shared zero page, and its writes take the slow path,
+ * so the footprint of the memory scales with the pages the firmware touches.
+ * 
+ * The pages of a mapped image are read from the image, which is shared by all
+ * the machines it is mapped into. The first write to such a page commits its
+ * private copy, so the image itself is never written.
+ * 
+ * Every write marks its page in the dirty map of the page table. The pages
+ * marked before a reset of the dirty map are kept in the diverged map, so the
+ * initialization restores the pages in either of the maps only, and leaves the
+ * rest of the committed pages, and their watched code, as they are.
+ */
+
+/**
+ * @brief I/O handlers of an address range.
+ */
 typedef struct
 {
-	#define rl78core_mem_flash_capacity 0x100000
-	uint8_t flash[rl78core_mem_flash_capacity];
-} rl78core_mem_s;
+	uint20_t address;
+	uint20_t length;
+	rl78core_mem_io_read_t read;
+	rl78core_mem_io_write_t write;
+	void* context;
+} rl78core_mem_io_s;
+
+struct rl78core_mem_image_s
+{
+	const uint8_t* pages[rl78core_mem_pages_count];
+	bool_t attached[rl78core_mem_pages_count];  // note: attached pages are borrowed, and get copied before they are loaded into.
+	uint64_t committed_count;
+};
 
-static rl78core_mem_s g_rl78core_mem;
+struct rl78core_mem_s
+{
+	rl78core_mem_page_table_s table;  // note: must be the first member, for the inline accessors of the header.
+	uint8_t* pages[rl78core_mem_pages_count];  // note: committed host memory of every page, or NULL.
+	uint64_t committed_count;
+	const rl78core_mem_image_s* image;
+	uint8_t* io_slots[rl78core_mem_pages_count];  // note: 1-based index of the i/o handlers of every byte of a page, or NULL.
+	rl78core_mem_io_s ios[rl78core_mem_ios_capacity];
+	uint8_t ios_count;
+	bool_t code_pages[rl78core_mem_pages_count];
+	rl78core_mem_code_write_hook_t code_write_hook;
+	bool_t diverged[rl78core_mem_pages_count];  // note: pages written before the last reset of the dirty map.
+	bool_t referenced[rl78core_mem_pages_count];  // note: pages aliased by the pointers from the references, always dirty.
+};
+
+static const uint8_t g_rl78core_mem_zero_page[rl78core_mem_page_size] = {0};
 
 /**
  * @brief Reference memory at a provided address. It requires the size in bytes
  * of the referenceable type for safety checks.
  * 
+ * @param mem     memory to reference
  * @param address address to reference memory at
  * @param size    referenceable type size in bytes
  * 
  * @return uint8_t* pointer to the referenced memory
  */
-static uint8_t* reference_mem_at(const uint20_t address, const uint20_t size);
+static inline uint8_t* reference_mem_at(rl78core_mem_s* const mem, const uint20_t address, const uint20_t size);
+
+/**
+ * @brief Map a provided page to its host memory, or to the slow path if it has
+ * mapped i/o handlers or is a watched code page.
+ * 
+ * @param mem  memory to map the page of
+ * @param page index of the page to map
+ */
+static void map_page(rl78core_mem_s* const mem, const uint20_t page);
+
+/**
+ * @brief Get the initial contents of a provided page: its page of the mapped
+ * image, or the shared zero page.
+ * 
+ * @param mem  memory to get the page of
+ * @param page index of the page
+ * 
+ * @return const uint8_t* initial contents of the page
+ */
+static inline const uint8_t* initial_page(const rl78core_mem_s* const mem, const uint20_t page);
+
+/**
+ * @brief Commit the host memory of a provided page, if it is not committed yet.
+ * The committed memory starts with the initial contents of the page.
+ * 
+ * @param mem  memory to commit the page of
+ * @param page index of the page to commit
+ * 
+ * @return uint8_t* host memory of the page
+ */
+static uint8_t* commit_page(rl78core_mem_s* const mem, const uint20_t page);
+
+/**
+ * @brief Find the i/o handlers mapped at a provided address.
+ * 
+ * @param mem     memory to find the handlers in
+ * @param address address to find the handlers at
+ * 
+ * @return const rl78core_mem_io_s* found handlers, or NULL if there are none
+ */
+static inline const rl78core_mem_io_s* find_io(const rl78core_mem_s* const mem, const uint20_t address);
+
+/**
+ * @brief Report a write to the page at a provided address, if it is a watched
+ * code page.
+ * 
+ * @param machine machine whose memory was written to
+ * @param address address of the write
+ */
+static inline void notify_code_write(rl78core_machine_s* const machine, const uint20_t address);
+
+rl78core_mem_s* rl78core_mem_create(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78core_mem_s* const mem = (rl78core_mem_s*)rl78misc_malloc(sizeof(rl78core_mem_s));
+	rl78misc_memset(mem->pages, 0, sizeof(mem->pages));
+	mem->committed_count = 0;
+	mem->image = NULL;
+	rl78misc_memset(mem->io_slots, 0, sizeof(mem->io_slots));
+	rl78misc_memset(mem->code_pages, 0, sizeof(mem->code_pages));
+	mem->ios_count = 0;
+	mem->code_write_hook = NULL;
+	rl78misc_memset(mem->table.dirty, 0, sizeof(mem->table.dirty));
+	rl78misc_memset(mem->diverged, 0, sizeof(mem->diverged));
+	rl78misc_memset(mem->referenced, 0, sizeof(mem->referenced));
+
+	for (uint20_t page = 0; page < rl78core_mem_pages_count; ++page)
+	{
+		map_page(mem, page);
+	}
+
+	return mem;
+}
+
+void rl78core_mem_destroy(rl78core_mem_s* const mem)
+{
+	rl78misc_debug_assert(mem != NULL);
+
+	for (uint20_t page = 0; page < rl78core_mem_pages_count; ++page)
+	{
+		(void)rl78misc_free(mem->pages[page]);
+		(void)rl78misc_free(mem->io_slots[page]);
+	}
+
+	(void)rl78misc_free(mem);
+}
+
+void rl78core_mem_init_r(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78core_mem_s* const mem = machine->mem;
+
+	// note: the committed pages are kept, since the cpu may alias their memory.
+	for (uint20_t page = 0; page < rl78core_mem_pages_count; ++page)
+	{
+		if ((mem->pages[page] != NULL) && (mem->table.dirty[page] || mem->diverged[page]))
+		{
+			rl78misc_memcpy(mem->pages[page], initial_page(mem, page), rl78core_mem_page_size);
+			notify_code_write(machine, page << rl78core_mem_page_shift);
+		}
+
+		mem->table.dirty[page] = mem->referenced[page] ? 1 : 0;
+		mem->diverged[page] = false;
+	}
+}
+
+uint8_t rl78core_mem_read_slow_r(rl78core_machine_s* const machine, const uint20_t address)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(address < rl78core_mem_address_space_size);
+	const rl78core_mem_io_s* const io = find_io(machine->mem, address);
+
+	if ((io != NULL) && (io->read != NULL))
+	{
+		return io->read(machine, io->context, address);
+	}
+
+	const uint20_t page = address >> rl78core_mem_page_shift;
+	const uint8_t* const host = (machine->mem->pages[page] != NULL) ? machine->mem->pages[page] : initial_page(machine->mem, page);
+	return host[address & (rl78core_mem_page_size - 1)];
+}
+
+void rl78core_mem_write_slow_r(rl78core_machine_s* const machine, const uint20_t address, const uint8_t value)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(address < rl78core_mem_address_space_size);
+	const rl78core_mem_io_s* const io = find_io(machine->mem, address);
+
+	if ((io != NULL) && (io->write != NULL))
+	{
+		io->write(machine, io->context, address, value);
+	}
+	else
+	{
+		commit_page(machine->mem, address >> rl78core_mem_page_shift)[address & (rl78core_mem_page_size - 1)] = value;
+		machine->mem->table.dirty[address >> rl78core_mem_page_shift] = 1;
+	}
+
+	notify_code_write(machine, address);
+}
+
+void rl78core_mem_load_r(rl78core_machine_s* const machine, const uint20_t address, const uint8_t* const data, const uint20_t length)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(data != NULL || 0 == length);
+	rl78misc_debug_assert(length <= (rl78core_mem_address_space_size - address));
+
+	uint20_t offset = 0;
+
+	while (offset < length)
+	{
+		const uint20_t page_offset = (address + offset) & (rl78core_mem_page_size - 1);
+		uint20_t chunk = rl78core_mem_page_size - page_offset;
+		chunk = (chunk < (length - offset)) ? chunk : (length - offset);
+
+		uint8_t* const host = commit_page(machine->mem, (address + offset) >> rl78core_mem_page_shift);
+		rl78misc_memcpy(&host[page_offset], &data[offset], chunk);
+		machine->mem->table.dirty[(address + offset) >> rl78core_mem_page_shift] = 1;
+		notify_code_write(machine, address + offset);
+		offset += chunk;
+	}
+}
+
+uint64_t rl78core_mem_footprint_r(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	return machine->mem->committed_count * rl78core_mem_page_size;
+}
+
+rl78core_mem_image_s* rl78core_mem_image_create(void)
+{
+	rl78core_mem_image_s* const image = (rl78core_mem_image_s*)rl78misc_malloc(sizeof(rl78core_mem_image_s));
+	rl78misc_memset(image->pages, 0, sizeof(image->pages));
+	rl78misc_memset(image->attached, 0, sizeof(image->attached));
+	image->committed_count = 0;
+	return image;
+}
+
+void rl78core_mem_image_destroy(rl78core_mem_image_s* const image)
+{
+	rl78misc_debug_assert(image != NULL);
+
+	for (uint20_t page = 0; page < rl78core_mem_pages_count; ++page)
+	{
+		if (!image->attached[page])
+		{
+			(void)rl78misc_free(image->pages[page]);
+		}
+	}
+
+	(void)rl78misc_free(image);
+}
+
+void rl78core_mem_image_load(rl78core_mem_image_s* const image, const uint20_t address, const uint8_t* const data, const uint20_t length)
+{
+	rl78misc_debug_assert(image != NULL);
+	rl78misc_debug_assert(data != NULL || 0 == length);
+	rl78misc_debug_assert(length <= (rl78core_mem_address_space_size - address));
+
+	uint20_t offset = 0;
+
+	while (offset < length)
+	{
+		const uint20_t page = (address + offset) >> rl78core_mem_page_shift;
+		const uint20_t page_offset = (address + offset) & (rl78core_mem_page_size - 1);
+		uint20_t chunk = rl78core_mem_page_size - page_offset;
+		chunk = (chunk < (length - offset)) ? chunk : (length - offset);
+
+		if ((NULL == image->pages[page]) || image->attached[page])
+		{
+			uint8_t* const copy = (uint8_t*)rl78misc_malloc(rl78core_mem_page_size);
+
+			if (NULL == image->pages[page])
+			{
+				rl78misc_memset(copy, 0, rl78core_mem_page_size);
+				++image->committed_count;
+			}
+			else
+			{
+				rl78misc_memcpy(copy, image->pages[page], rl78core_mem_page_size);
+			}
+
+			image->pages[page] = copy;
+			image->attached[page] = false;
+		}
+
+		// note: the pages not attached are owned, and writable.
+		rl78misc_memcpy((uint8_t*)&image->pages[page][page_offset], &data[offset], chunk);
+		offset += chunk;
+	}
+}
+
+void rl78core_mem_image_attach(rl78core_mem_image_s* const image, const uint20_t address, const uint8_t* const data, const uint20_t length)
+{
+	rl78misc_debug_assert(image != NULL);
+	rl78misc_debug_assert(data != NULL || 0 == length);
+	rl78misc_debug_assert(0 == (address & (rl78core_mem_page_size - 1)));
+	rl78misc_debug_assert(0 == (length & (rl78core_mem_page_size - 1)));
+	rl78misc_debug_assert(length <= (rl78core_mem_address_space_size - address));
+
+	for (uint20_t offset = 0; offset < length; offset += rl78core_mem_page_size)
+	{
+		const uint20_t page = (address + offset) >> rl78core_mem_page_shift;
+
+		if (NULL == image->pages[page])
+		{
+			++image->committed_count;
+		}
+		else if (!image->attached[page])
+		{
+			(void)rl78misc_free(image->pages[page]);
+		}
+
+		image->pages[page] = &data[offset];
+		image->attached[page] = true;
+	}
+}
+
+const uint8_t* rl78core_mem_image_page(const rl78core_mem_image_s* const image, const uint20_t page)
+{
+	rl78misc_debug_assert(image != NULL);
+	rl78misc_debug_assert(page < rl78core_mem_pages_count);
+	return image->pages[page];
+}
+
+uint64_t rl78core_mem_image_footprint(const rl78core_mem_image_s* const image)
+{
+	rl78misc_debug_assert(image != NULL);
+	return image->committed_count * rl78core_mem_page_size;
+}
+
+void rl78core_mem_map_image_r(rl78core_machine_s* const machine, const rl78core_mem_image_s* const image)
+{
+	rl78misc_debug_assert(machine != NULL);
+
+	rl78core_mem_s* const mem = machine->mem;
+
+	if (image == mem->image)
+	{
+		return;
+	}
+
+	mem->image = image;
+
+	// note: the initial contents of every page may change, so all the committed
+	// pages get restored by the next initialization.
+	for (uint20_t page = 0; page < rl78core_mem_pages_count; ++page)
+	{
+		if (mem->pages[page] != NULL)
+		{
+			if ((image != NULL) && (image->pages[page] != NULL))
+			{
+				rl78misc_memcpy(mem->pages[page], image->pages[page], rl78core_mem_page_size);
+			}
+
+			mem->diverged[page] = true;
+		}
+
+		notify_code_write(machine, page << rl78core_mem_page_shift);
+		map_page(mem, page);
+	}
+}
+
+void rl78core_mem_capture_r(rl78core_machine_s* const machine, rl78core_mem_image_s* const image)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(image != NULL);
+
+	const rl78core_mem_s* const mem = machine->mem;
+
+	for (uint20_t page = 0; page < rl78core_mem_pages_count; ++page)
+	{
+		const uint8_t* const host = (mem->pages[page] != NULL) ? mem->pages[page] : initial_page(mem, page);
+
+		// note: the pages never written and not in the mapped image stay unloaded, as they read as zeros.
+		if (host != g_rl78core_mem_zero_page)
+		{
+			rl78core_mem_image_load(image, page << rl78core_mem_page_shift, host, rl78core_mem_page_size);
+		}
+	}
+}
+
+bool_t rl78core_mem_dirty_r(rl78core_machine_s* const machine, const uint20_t address)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(address < rl78core_mem_address_space_size);
+	return (machine->mem->table.dirty[address >> rl78core_mem_page_shift] != 0);
+}
+
+void rl78core_mem_reset_dirty_r(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78core_mem_s* const mem = machine->mem;
+
+	for (uint20_t page = 0; page < rl78core_mem_pages_count; ++page)
+	{
+		mem->diverged[page] = mem->diverged[page] || (mem->table.dirty[page] != 0);
+		mem->table.dirty[page] = mem->referenced[page] ? 1 : 0;
+	}
+}
+
+uint8_t* rl78core_mem_reference_r(rl78core_machine_s* const machine, const uint20_t address, const uint20_t size)
+{
+	return reference_mem_at(machine->mem, address, size);
+}
+
+void rl78core_mem_set_code_write_hook_r(rl78core_machine_s* const machine, const rl78core_mem_code_write_hook_t hook)
+{
+	rl78misc_debug_assert(machine != NULL);
+	machine->mem->code_write_hook = hook;
+}
+
+void rl78core_mem_watch_code_page_r(rl78core_machine_s* const machine, const uint20_t address)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(address < rl78core_mem_address_space_size);
+	const uint20_t page = address >> rl78core_mem_page_shift;
+	machine->mem->code_pages[page] = true;
+	map_page(machine->mem, page);
+}
+
+bool_t rl78core_mem_map_io_r(rl78core_machine_s* const machine, const uint20_t address, const uint20_t length, const rl78core_mem_io_read_t read, const rl78core_mem_io_write_t write, void* const context)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(length > 0);
+	rl78misc_debug_assert(address < (rl78core_mem_address_space_size - length + 1));
+
+	rl78core_mem_s* const mem = machine->mem;
+
+	if (mem->ios_count >= rl78core_mem_ios_capacity)
+	{
+		return false;
+	}
+
+	mem->ios[mem->ios_count] = (rl78core_mem_io_s)
+	{
+		.address = address,
+		.length = length,
+		.read = read,
+		.write = write,
+		.context = context,
+	};
+
+	const uint8_t slot = ++mem->ios_count;
+
+	for (uint20_t byte = address; byte < (address + length); ++byte)
+	{
+		const uint20_t page = byte >> rl78core_mem_page_shift;
+
+		if (NULL == mem->io_slots[page])
+		{
+			mem->io_slots[page] = (uint8_t*)rl78misc_malloc(rl78core_mem_page_size);
+			rl78misc_memset(mem->io_slots[page], 0, rl78core_mem_page_size);
+			map_page(mem, page);
+		}
+
+		mem->io_slots[page][byte & (rl78core_mem_page_size - 1)] = slot;
+	}
+
+	return true;
+}
 
 void rl78core_mem_init(void)
 {
-	g_rl78core_mem = (rl78core_mem_s) {0};
+	rl78core_mem_init_r(rl78core_machine_default());
 }
 
 uint8_t rl78core_mem_read_u08(const uint20_t address)
 {
-	const uint8_t* const base = reference_mem_at(address, sizeof(uint8_t));
-	return (*base & 0xFF);
+	return rl78core_mem_read_u08_r(rl78core_machine_default(), address);
 }
 
 void rl78core_mem_write_u08(const uint20_t address, const uint8_t value)
 {
-	uint8_t* const base = reference_mem_at(address, sizeof(uint8_t));
-	*base = (value & 0xFF);
+	rl78core_mem_write_u08_r(rl78core_machine_default(), address, value);
 }
 
 uint16_t rl78core_mem_read_u16(const uint20_t address)
 {
-	const uint8_t* const base = reference_mem_at(address, sizeof(uint16_t));
-	return (uint16_t)((uint16_t)(*(base + 0) & 0x00FF) | \
-	(uint16_t)((uint16_t)(*(base + 1) << 8) & 0xFF00));
+	return rl78core_mem_read_u16_r(rl78core_machine_default(), address);
 }
 
 void rl78core_mem_write_u16(const uint20_t address, const uint16_t value)
 {
-	uint8_t* const base = reference_mem_at(address, sizeof(uint16_t));
-	*(base + 0) = (uint8_t)(value & 0x00FF);
-	*(base + 1) = (uint8_t)((uint16_t)(value >> 8) & 0x00FF);
+	rl78core_mem_write_u16_r(rl78core_machine_default(), address, value);
+}
+
+uint8_t* rl78core_mem_reference(const uint20_t address, const uint20_t size)
+{
+	return rl78core_mem_reference_r(rl78core_machine_default(), address, size);
+}
+
+void rl78core_mem_set_code_write_hook(const rl78core_mem_code_write_hook_t hook)
+{
+	rl78core_mem_set_code_write_hook_r(rl78core_machine_default(), hook);
+}
+
+void rl78core_mem_watch_code_page(const uint20_t address)
+{
+	rl78core_mem_watch_code_page_r(rl78core_machine_default(), address);
+}
+
+void rl78core_mem_load(const uint20_t address, const uint8_t* const data, const uint20_t length)
+{
+	rl78core_mem_load_r(rl78core_machine_default(), address, data, length);
+}
+
+uint64_t rl78core_mem_footprint(void)
+{
+	return rl78core_mem_footprint_r(rl78core_machine_default());
+}
+
+void rl78core_mem_map_image(const rl78core_mem_image_s* const image)
+{
+	rl78core_mem_map_image_r(rl78core_machine_default(), image);
+}
+
+void rl78core_mem_capture(rl78core_mem_image_s* const image)
+{
+	rl78core_mem_capture_r(rl78core_machine_default(), image);
+}
+
+bool_t rl78core_mem_dirty(const uint20_t address)
+{
+	return rl78core_mem_dirty_r(rl78core_machine_default(), address);
+}
+
+void rl78core_mem_reset_dirty(void)
+{
+	rl78core_mem_reset_dirty_r(rl78core_machine_default());
+}
+
+bool_t rl78core_mem_map_io(const uint20_t address, const uint20_t length, const rl78core_mem_io_read_t read, const rl78core_mem_io_write_t write, void* const context)
+{
+	return rl78core_mem_map_io_r(rl78core_machine_default(), address, length, read, write, context);
 }
 
-static uint8_t* reference_mem_at(const uint20_t address, const uint20_t size)
+static inline uint8_t* reference_mem_at(rl78core_mem_s* const mem, const uint20_t address, const uint20_t size)
 {
+	rl78misc_debug_assert(mem != NULL);
 	rl78misc_debug_assert(size > 0);
-	rl78misc_debug_assert(address < (rl78core_mem_flash_capacity - size + 1));
-	uint8_t* const base = &g_rl78core_mem.flash[address];
+	rl78misc_debug_assert(address < (rl78core_mem_address_space_size - size + 1));
+	rl78misc_debug_assert((address >> rl78core_mem_page_shift) == ((address + size - 1) >> rl78core_mem_page_shift));
+	uint8_t* const base = &commit_page(mem, address >> rl78core_mem_page_shift)[address & (rl78core_mem_page_size - 1)];
 	rl78misc_debug_assert(base != NULL);
+	mem->referenced[address >> rl78core_mem_page_shift] = true;
+	mem->table.dirty[address >> rl78core_mem_page_shift] = 1;
 	return base;
 }
+
+static void map_page(rl78core_mem_s* const mem, const uint20_t page)
+{
+	rl78misc_debug_assert(mem != NULL);
+	rl78misc_debug_assert(page < rl78core_mem_pages_count);
+
+	uint8_t* const host = mem->pages[page];
+	const bool_t io = (mem->io_slots[page] != NULL);
+	mem->table.read[page] = io ? NULL : ((host != NULL) ? host : initial_page(mem, page));
+	mem->table.write[page] = (io || mem->code_pages[page]) ? NULL : host;
+}
+
+static inline const uint8_t* initial_page(const rl78core_mem_s* const mem, const uint20_t page)
+{
+	if ((mem->image != NULL) && (mem->image->pages[page] != NULL))
+	{
+		return mem->image->pages[page];
+	}
+
+	return g_rl78core_mem_zero_page;
+}
+
+static uint8_t* commit_page(rl78core_mem_s* const mem, const uint20_t page)
+{
+	rl78misc_debug_assert(mem != NULL);
+	rl78misc_debug_assert(page < rl78core_mem_pages_count);
+
+	if (NULL == mem->pages[page])
+	{
+		mem->pages[page] = (uint8_t*)rl78misc_malloc(rl78core_mem_page_size);
+		rl78misc_memcpy(mem->pages[page], initial_page(mem, page), rl78core_mem_page_size);
+		++mem->committed_count;
+		map_page(mem, page);
+	}
+
+	return mem->pages[page];
+}
+
+static inline const rl78core_mem_io_s* find_io(const rl78core_mem_s* const mem, const uint20_t address)
+{
+	const uint8_t* const slots = mem->io_slots[address >> rl78core_mem_page_shift];
+
+	if (NULL == slots)
+	{
+		return NULL;
+	}
+
+	const uint8_t slot = slots[address & (rl78core_mem_page_size - 1)];
+	return (0 == slot) ? NULL : &mem->ios[slot - 1];
+}
+
+static inline void notify_code_write(rl78core_machine_s* const machine, const uint20_t address)
+{
+	rl78core_mem_s* const mem = machine->mem;
+	const uint20_t page = address >> rl78core_mem_page_shift;
+
+	if (mem->code_pages[page])
+	{
+		mem->code_pages[page] = false;
+		map_page(mem, page);
+
+		if (mem->code_write_hook != NULL)
+		{
+			mem->code_write_hook(machine, page);
+		}
+	}
+}
@@ -0,0 +1,336 @@
+
+/**
+ * @file sched.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+
+#include "rl78core/sched.h"
+#include "rl78core/cpu.h"
+
+typedef struct
+{
+	rl78core_sched_handler_t handler;
+	void* context;
+	uint64_t cycles;
+	uint8_t position;  // note: position of the event in the heap, or the no event value if it is not scheduled.
+} rl78core_sched_event_s;
+
+struct rl78core_sched_s
+{
+	rl78core_sched_event_s events[rl78core_sched_events_capacity];
+	uint8_t events_count;
+	uint8_t heap[rl78core_sched_events_capacity];
+	uint8_t heap_count;
+};
+
+/**
+ * @brief Check if an event is to be dispatched before another one, by their
+ * count of clock cycles, and then by the order they were added in.
+ * 
+ * @param sched scheduler of the events
+ * @param left  left event
+ * @param right right event
+ * 
+ * @return bool_t
+ */
+static bool_t precedes(const rl78core_sched_s* const sched, const uint8_t left, const uint8_t right);
+
+/**
+ * @brief Place an event at a position of the heap.
+ * 
+ * @param sched    scheduler to operate on
+ * @param position position in the heap
+ * @param event    event to place
+ */
+static void place(rl78core_sched_s* const sched, const uint8_t position, const uint8_t event);
+
+/**
+ * @brief Move the event at a position of the heap up or down, until the heap
+ * is ordered again.
+ * 
+ * @param sched    scheduler to operate on
+ * @param position position of the event in the heap
+ */
+static void sift(rl78core_sched_s* const sched, uint8_t position);
+
+/**
+ * @brief Remove the event at a position of the heap.
+ * 
+ * @param sched    scheduler to operate on
+ * @param position position of the event in the heap
+ */
+static void remove_at(rl78core_sched_s* const sched, const uint8_t position);
+
+/**
+ * @brief Set the deadline of the cpu to the earliest scheduled event.
+ * 
+ * @param machine machine to operate on
+ */
+static void update_deadline(rl78core_machine_s* const machine);
+
+rl78core_sched_s* rl78core_sched_create(void)
+{
+	rl78core_sched_s* const sched = (rl78core_sched_s*)rl78misc_malloc(sizeof(rl78core_sched_s));
+	sched->events_count = 0;
+	sched->heap_count = 0;
+	return sched;
+}
+
+void rl78core_sched_destroy(rl78core_sched_s* const sched)
+{
+	rl78misc_debug_assert(sched != NULL);
+	(void)rl78misc_free(sched);
+}
+
+void rl78core_sched_init_r(rl78core_machine_s* const machine)
+{
+	rl78core_sched_s* const sched = machine->sched;
+	for (uint8_t event = 0; event < sched->events_count; ++event)
+	{
+		sched->events[event].position = rl78core_sched_no_event;
+	}
+
+	sched->heap_count = 0;
+	update_deadline(machine);
+}
+
+uint8_t rl78core_sched_add_event_r(rl78core_machine_s* const machine, const rl78core_sched_handler_t handler, void* const context)
+{
+	rl78misc_debug_assert(handler != NULL);
+	rl78core_sched_s* const sched = machine->sched;
+
+	if (sched->events_count >= rl78core_sched_events_capacity)
+	{
+		return rl78core_sched_no_event;
+	}
+
+	sched->events[sched->events_count] = (rl78core_sched_event_s)
+	{
+		.handler = handler,
+		.context = context,
+		.cycles = 0,
+		.position = rl78core_sched_no_event,
+	};
+
+	return sched->events_count++;
+}
+
+void rl78core_sched_schedule_r(rl78core_machine_s* const machine, const uint8_t event, const uint64_t cycles)
+{
+	rl78core_sched_s* const sched = machine->sched;
+	rl78misc_debug_assert(event < sched->events_count);
+	sched->events[event].cycles = cycles;
+
+	if (rl78core_sched_no_event == sched->events[event].position)
+	{
+		place(sched, sched->heap_count++, event);
+	}
+
+	sift(sched, sched->events[event].position);
+	update_deadline(machine);
+}
+
+bool_t rl78core_sched_cancel_r(rl78core_machine_s* const machine, const uint8_t event)
+{
+	rl78core_sched_s* const sched = machine->sched;
+	rl78misc_debug_assert(event < sched->events_count);
+
+	if (rl78core_sched_no_event == sched->events[event].position)
+	{
+		return false;
+	}
+
+	remove_at(sched, sched->events[event].position);
+	update_deadline(machine);
+	return true;
+}
+
+bool_t rl78core_sched_pending_r(rl78core_machine_s* const machine, const uint8_t event)
+{
+	rl78core_sched_s* const sched = machine->sched;
+	rl78misc_debug_assert(event < sched->events_count);
+	return sched->events[event].position != rl78core_sched_no_event;
+}
+
+uint64_t rl78core_sched_next_r(rl78core_machine_s* const machine)
+{
+	const rl78core_sched_s* const sched = machine->sched;
+	return (0 == sched->heap_count) ? rl78core_cpu_no_deadline : sched->events[sched->heap[0]].cycles;
+}
+
+bool_t rl78core_sched_dispatch_r(rl78core_machine_s* const machine)
+{
+	rl78core_sched_s* const sched = machine->sched;
+	const uint64_t now = rl78core_cpu_cycles_r(machine);
+	bool_t dispatched = false;
+
+	// note: the event is removed before its handler is called, so that the
+	// handler can schedule it again.
+	while ((sched->heap_count > 0) && (sched->events[sched->heap[0]].cycles <= now))
+	{
+		const rl78core_sched_event_s* const event = &sched->events[sched->heap[0]];
+		const uint64_t cycles = event->cycles;
+		remove_at(sched, 0);
+		event->handler(machine, event->context, cycles);
+		dispatched = true;
+	}
+
+	if (dispatched)
+	{
+		update_deadline(machine);
+	}
+
+	return dispatched;
+}
+
+void rl78core_sched_save_r(rl78core_machine_s* const machine, rl78core_sched_state_s* const state)
+{
+	rl78misc_debug_assert(state != NULL);
+	const rl78core_sched_s* const sched = machine->sched;
+	rl78misc_memset(state, 0, sizeof(*state));
+
+	for (uint8_t event = 0; event < sched->events_count; ++event)
+	{
+		if (sched->events[event].position != rl78core_sched_no_event)
+		{
+			state->scheduled |= 1ull << event;
+			state->cycles[event] = sched->events[event].cycles;
+		}
+	}
+}
+
+void rl78core_sched_restore_r(rl78core_machine_s* const machine, const rl78core_sched_state_s* const state)
+{
+	rl78misc_debug_assert(state != NULL);
+	const rl78core_sched_s* const sched = machine->sched;
+	rl78core_sched_init_r(machine);
+
+	for (uint8_t event = 0; event < rl78core_sched_events_capacity; ++event)
+	{
+		if (0 != (state->scheduled & (1ull << event)))
+		{
+			rl78misc_debug_assert(event < sched->events_count);
+			rl78core_sched_schedule_r(machine, event, state->cycles[event]);
+		}
+	}
+}
+
+void rl78core_sched_init(void)
+{
+	rl78core_sched_init_r(rl78core_machine_default());
+}
+
+uint8_t rl78core_sched_add_event(const rl78core_sched_handler_t handler, void* const context)
+{
+	return rl78core_sched_add_event_r(rl78core_machine_default(), handler, context);
+}
+
+void rl78core_sched_schedule(const uint8_t event, const uint64_t cycles)
+{
+	rl78core_sched_schedule_r(rl78core_machine_default(), event, cycles);
+}
+
+bool_t rl78core_sched_cancel(const uint8_t event)
+{
+	return rl78core_sched_cancel_r(rl78core_machine_default(), event);
+}
+
+bool_t rl78core_sched_pending(const uint8_t event)
+{
+	return rl78core_sched_pending_r(rl78core_machine_default(), event);
+}
+
+uint64_t rl78core_sched_next(void)
+{
+	return rl78core_sched_next_r(rl78core_machine_default());
+}
+
+void rl78core_sched_save(rl78core_sched_state_s* const state)
+{
+	rl78core_sched_save_r(rl78core_machine_default(), state);
+}
+
+void rl78core_sched_restore(const rl78core_sched_state_s* const state)
+{
+	rl78core_sched_restore_r(rl78core_machine_default(), state);
+}
+
+static bool_t precedes(const rl78core_sched_s* const sched, const uint8_t left, const uint8_t right)
+{
+	const uint64_t left_cycles = sched->events[left].cycles;
+	const uint64_t right_cycles = sched->events[right].cycles;
+	return (left_cycles != right_cycles) ? (left_cycles < right_cycles) : (left < right);
+}
+
+static void place(rl78core_sched_s* const sched, const uint8_t position, const uint8_t event)
+{
+	sched->heap[position] = event;
+	sched->events[event].position = position;
+}
+
+static void sift(rl78core_sched_s* const sched, uint8_t position)
+{
+	const uint8_t event = sched->heap[position];
+
+	while (position > 0)
+	{
+		const uint8_t parent = (uint8_t)((position - 1) / 2);
+		if (!precedes(sched, event, sched->heap[parent]))
+		{
+			break;
+		}
+
+		place(sched, position, sched->heap[parent]);
+		position = parent;
+	}
+
+	while (true)
+	{
+		const uint32_t left = (2 * (uint32_t)position) + 1;
+		if (left >= sched->heap_count)
+		{
+			break;
+		}
+
+		uint8_t child = (uint8_t)left;
+		if (((left + 1) < sched->heap_count) && precedes(sched, sched->heap[left + 1], sched->heap[left]))
+		{
+			child = (uint8_t)(left + 1);
+		}
+
+		if (!precedes(sched, sched->heap[child], event))
+		{
+			break;
+		}
+
+		place(sched, position, sched->heap[child]);
+		position = child;
+	}
+
+	place(sched, position, event);
+}
+
+static void remove_at(rl78core_sched_s* const sched, const uint8_t position)
+{
+	sched->events[sched->heap[position]].position = rl78core_sched_no_event;
+	--sched->heap_count;
+
+	if (position < sched->heap_count)
+	{
+		place(sched, position, sched->heap[sched->heap_count]);
+		sift(sched, position);
+	}
+}
+
+static void update_deadline(rl78core_machine_s* const machine)
+{
+	rl78core_cpu_set_deadline_r(machine, rl78core_sched_next_r(machine));
+}
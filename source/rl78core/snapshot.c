@@ -0,0 +1,387 @@
+
+/**
+ * @file snapshot.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+#include "rl78misc/logger.h"
+#include "rl78misc/file.h"
+
+#include "rl78core/snapshot.h"
+#include "rl78core/sched.h"
+#include "rl78core/tau.h"
+
+#include <stdio.h>
+
+/**
+ * note: the file of a snapshot is laid out as the header, the peripherals record
+ * of the scheduled events and the timer array units, and the loaded pages of
+ * the memory, each prefixed with its index. The values are stored in the
+ * byte order of the host, which the magic tells apart.
+ */
+
+typedef struct
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t page_size;
+	uint32_t halted;
+	uint32_t pc;
+	uint64_t cycles;
+	uint32_t engine;
+	uint32_t standby;
+	uint32_t pages_count;
+	uint32_t reserved;  // note: keeps the header free of any padding.
+} rl78core_snapshot_header_s;
+
+typedef struct
+{
+	uint64_t start;
+	uint16_t mode;
+	uint16_t counter;
+	uint8_t shift;
+	uint8_t status;
+	uint8_t counting;
+	uint8_t reserved;  // note: keeps the record free of any padding.
+} rl78core_snapshot_channel_s;
+
+typedef struct
+{
+	uint16_t enables;
+	uint16_t prescalers;
+	uint16_t outputs;
+	uint16_t output_enables;
+	uint16_t output_levels;
+	uint16_t output_modes;
+	uint32_t reserved;  // note: keeps the record free of any padding.
+} rl78core_snapshot_unit_s;
+
+typedef struct
+{
+	uint64_t scheduled;
+	uint64_t cycles[rl78core_sched_events_capacity];
+	rl78core_snapshot_unit_s units[rl78core_tau_units_count];
+	rl78core_snapshot_channel_s channels[rl78core_tau_units_count][rl78core_tau_channels_count];
+} rl78core_snapshot_peripherals_s;
+
+struct rl78core_snapshot_s
+{
+	rl78core_cpu_state_s cpu;
+	rl78core_sched_state_s sched;
+	rl78core_tau_state_s tau;
+	rl78core_mem_image_s* mem;
+};
+
+static const uint64_t g_rl78core_snapshot_magic = 0x706E7338376C7200;  // note: "\0rl78snp" in the little-endian order.
+
+/**
+ * @brief Pack the scheduled events and the timer array units of a snapshot into
+ * the peripherals record of its file.
+ * 
+ * @param snapshot    snapshot to pack
+ * @param peripherals pointer to store the record into
+ */
+static void pack_peripherals(const rl78core_snapshot_s* const snapshot, rl78core_snapshot_peripherals_s* const peripherals);
+
+/**
+ * @brief Unpack the peripherals record of a file into a snapshot.
+ * 
+ * @param peripherals record to unpack
+ * @param snapshot    snapshot to unpack into
+ */
+static void unpack_peripherals(const rl78core_snapshot_peripherals_s* const peripherals, rl78core_snapshot_s* const snapshot);
+
+/**
+ * @brief Check if the peripherals record of a file is valid.
+ * 
+ * @param peripherals record to check
+ * 
+ * @return bool_t
+ */
+static bool_t is_valid_peripherals(const rl78core_snapshot_peripherals_s* const peripherals);
+
+rl78core_snapshot_s* rl78core_snapshot_capture_r(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+
+	rl78core_snapshot_s* const snapshot = (rl78core_snapshot_s*)rl78misc_malloc(sizeof(rl78core_snapshot_s));
+	snapshot->mem = rl78core_mem_image_create();
+
+	// note: the cpu is saved first, to write its pending flags into the memory.
+	rl78core_cpu_save_r(machine, &snapshot->cpu);
+	rl78core_sched_save_r(machine, &snapshot->sched);
+	rl78core_tau_save_r(machine, &snapshot->tau);
+	rl78core_mem_capture_r(machine, snapshot->mem);
+	return snapshot;
+}
+
+void rl78core_snapshot_destroy(rl78core_snapshot_s* const snapshot)
+{
+	rl78misc_debug_assert(snapshot != NULL);
+	rl78core_mem_image_destroy(snapshot->mem);
+	(void)rl78misc_free(snapshot);
+}
+
+void rl78core_snapshot_restore_r(rl78core_machine_s* const machine, const rl78core_snapshot_s* const snapshot)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(snapshot != NULL);
+	rl78core_mem_map_image_r(machine, snapshot->mem);
+	rl78core_mem_init_r(machine);
+	rl78core_cpu_restore_r(machine, &snapshot->cpu);
+	rl78core_tau_restore_r(machine, &snapshot->tau);
+
+	// note: restoring the scheduled events sets the deadline of the cpu to the
+	// earliest of them.
+	rl78core_sched_restore_r(machine, &snapshot->sched);
+}
+
+rl78core_machine_s* rl78core_snapshot_fork(const rl78core_snapshot_s* const snapshot)
+{
+	rl78misc_debug_assert(snapshot != NULL);
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	rl78core_snapshot_restore_r(machine, snapshot);
+	return machine;
+}
+
+const rl78core_cpu_state_s* rl78core_snapshot_cpu(const rl78core_snapshot_s* const snapshot)
+{
+	rl78misc_debug_assert(snapshot != NULL);
+	return &snapshot->cpu;
+}
+
+bool_t rl78core_snapshot_save(const rl78core_snapshot_s* const snapshot, const char_t* const path)
+{
+	rl78misc_debug_assert(snapshot != NULL);
+	rl78misc_debug_assert(path != NULL);
+
+	rl78core_snapshot_header_s header =
+	{
+		.magic = g_rl78core_snapshot_magic,
+		.version = rl78core_snapshot_version,
+		.page_size = rl78core_mem_page_size,
+		.halted = snapshot->cpu.halted ? 1 : 0,
+		.pc = snapshot->cpu.pc,
+		.cycles = snapshot->cpu.cycles,
+		.engine = (uint32_t)snapshot->cpu.engine,
+		.standby = (uint32_t)snapshot->cpu.standby,
+		.pages_count = 0,
+		.reserved = 0,
+	};
+
+	for (uint20_t page = 0; page < rl78core_mem_pages_count; ++page)
+	{
+		header.pages_count += (rl78core_mem_image_page(snapshot->mem, page) != NULL) ? 1 : 0;
+	}
+
+	rl78core_snapshot_peripherals_s peripherals = {0};
+	pack_peripherals(snapshot, &peripherals);
+	FILE* const file = fopen(path, "wb");
+
+	if (NULL == file)
+	{
+		rl78misc_logger_error("failed to open the snapshot file '%s' for writing.", path);
+		return false;
+	}
+
+	bool_t written = (1 == fwrite(&header, sizeof(header), 1, file)) && (1 == fwrite(&peripherals, sizeof(peripherals), 1, file));
+
+	for (uint20_t page = 0; written && (page < rl78core_mem_pages_count); ++page)
+	{
+		const uint8_t* const contents = rl78core_mem_image_page(snapshot->mem, page);
+
+		if (contents != NULL)
+		{
+			written = (1 == fwrite(&page, sizeof(uint32_t), 1, file)) && (1 == fwrite(contents, rl78core_mem_page_size, 1, file));
+		}
+	}
+
+	written = (0 == fclose(file)) && written;
+
+	if (!written)
+	{
+		rl78misc_logger_error("failed to write the snapshot file '%s'.", path);
+	}
+
+	return written;
+}
+
+rl78core_snapshot_s* rl78core_snapshot_load(const char_t* const path)
+{
+	rl78misc_debug_assert(path != NULL);
+
+	uint64_t length = 0;
+	const uint8_t* const contents = rl78misc_file_map(path, &length);
+
+	if (NULL == contents)
+	{
+		return NULL;
+	}
+
+	rl78core_snapshot_header_s header = {0};
+	rl78core_snapshot_peripherals_s peripherals = {0};
+	const uint64_t pages_offset = sizeof(header) + sizeof(peripherals);
+	const uint64_t entry_size = sizeof(uint32_t) + rl78core_mem_page_size;
+	bool_t valid = (length >= pages_offset);
+
+	if (valid)
+	{
+		rl78misc_memcpy(&header, contents, sizeof(header));
+		rl78misc_memcpy(&peripherals, &contents[sizeof(header)], sizeof(peripherals));
+		valid = (g_rl78core_snapshot_magic == header.magic) && (rl78core_snapshot_version == header.version) &&
+			(rl78core_mem_page_size == header.page_size) && (header.halted <= 1) &&
+			(header.pc < rl78core_mem_address_space_size) && (header.engine < rl78core_cpu_engines_count) &&
+			(header.standby < rl78core_cpu_standbys_count) && ((1 == header.halted) || (0 == header.standby)) &&
+			(header.pages_count <= rl78core_mem_pages_count) &&
+			(length == (pages_offset + ((uint64_t)header.pages_count * entry_size))) && is_valid_peripherals(&peripherals);
+	}
+
+	for (uint32_t index = 0; valid && (index < header.pages_count); ++index)
+	{
+		uint32_t page = 0;
+		rl78misc_memcpy(&page, &contents[pages_offset + (index * entry_size)], sizeof(page));
+		valid = (page < rl78core_mem_pages_count);
+	}
+
+	if (!valid)
+	{
+		rl78misc_logger_error("the file '%s' is not a snapshot of version %u.", path, rl78core_snapshot_version);
+		rl78misc_file_unmap(contents, length);
+		return NULL;
+	}
+
+	rl78core_snapshot_s* const snapshot = (rl78core_snapshot_s*)rl78misc_malloc(sizeof(rl78core_snapshot_s));
+	snapshot->mem = rl78core_mem_image_create();
+	snapshot->cpu = (rl78core_cpu_state_s)
+	{
+		.halted = (1 == header.halted),
+		.standby = (rl78core_cpu_standby_e)header.standby,
+		.pc = header.pc,
+		.cycles = header.cycles,
+		.engine = (rl78core_cpu_engine_e)header.engine,
+	};
+	unpack_peripherals(&peripherals, snapshot);
+
+	for (uint32_t index = 0; index < header.pages_count; ++index)
+	{
+		const uint8_t* const entry = &contents[pages_offset + (index * entry_size)];
+		uint32_t page = 0;
+		rl78misc_memcpy(&page, entry, sizeof(page));
+		rl78core_mem_image_load(snapshot->mem, page << rl78core_mem_page_shift, &entry[sizeof(page)], rl78core_mem_page_size);
+	}
+
+	rl78misc_file_unmap(contents, length);
+	return snapshot;
+}
+
+rl78core_snapshot_s* rl78core_snapshot_capture(void)
+{
+	return rl78core_snapshot_capture_r(rl78core_machine_default());
+}
+
+void rl78core_snapshot_restore(const rl78core_snapshot_s* const snapshot)
+{
+	rl78core_snapshot_restore_r(rl78core_machine_default(), snapshot);
+}
+
+static void pack_peripherals(const rl78core_snapshot_s* const snapshot, rl78core_snapshot_peripherals_s* const peripherals)
+{
+	peripherals->scheduled = snapshot->sched.scheduled;
+	rl78misc_memcpy(peripherals->cycles, snapshot->sched.cycles, sizeof(peripherals->cycles));
+
+	for (uint8_t unit = 0; unit < rl78core_tau_units_count; ++unit)
+	{
+		const rl78core_tau_unit_state_s* const source = &snapshot->tau.units[unit];
+		peripherals->units[unit] = (rl78core_snapshot_unit_s)
+		{
+			.enables = source->enables,
+			.prescalers = source->prescalers,
+			.outputs = source->outputs,
+			.output_enables = source->output_enables,
+			.output_levels = source->output_levels,
+			.output_modes = source->output_modes,
+			.reserved = 0,
+		};
+
+		for (uint8_t index = 0; index < rl78core_tau_channels_count; ++index)
+		{
+			const rl78core_tau_channel_state_s* const channel = &source->channels[index];
+			peripherals->channels[unit][index] = (rl78core_snapshot_channel_s)
+			{
+				.start = channel->start,
+				.mode = channel->mode,
+				.counter = channel->counter,
+				.shift = channel->shift,
+				.status = channel->status,
+				.counting = channel->counting ? 1 : 0,
+				.reserved = 0,
+			};
+		}
+	}
+}
+
+static void unpack_peripherals(const rl78core_snapshot_peripherals_s* const peripherals, rl78core_snapshot_s* const snapshot)
+{
+	snapshot->sched.scheduled = peripherals->scheduled;
+	rl78misc_memcpy(snapshot->sched.cycles, peripherals->cycles, sizeof(snapshot->sched.cycles));
+
+	for (uint8_t unit = 0; unit < rl78core_tau_units_count; ++unit)
+	{
+		const rl78core_snapshot_unit_s* const source = &peripherals->units[unit];
+		rl78core_tau_unit_state_s* const target = &snapshot->tau.units[unit];
+		target->enables = source->enables;
+		target->prescalers = source->prescalers;
+		target->outputs = source->outputs;
+		target->output_enables = source->output_enables;
+		target->output_levels = source->output_levels;
+		target->output_modes = source->output_modes;
+
+		for (uint8_t index = 0; index < rl78core_tau_channels_count; ++index)
+		{
+			const rl78core_snapshot_channel_s* const channel = &peripherals->channels[unit][index];
+			target->channels[index] = (rl78core_tau_channel_state_s)
+			{
+				.mode = channel->mode,
+				.counter = channel->counter,
+				.start = channel->start,
+				.shift = channel->shift,
+				.status = channel->status,
+				.counting = (1 == channel->counting),
+			};
+		}
+	}
+}
+
+static bool_t is_valid_peripherals(const rl78core_snapshot_peripherals_s* const peripherals)
+{
+	// note: only the events of the timer array units are scheduled by a machine,
+	// and they are added first, one per channel.
+	const uint8_t events_count = rl78core_tau_units_count * rl78core_tau_channels_count;
+
+	if (0 != (peripherals->scheduled >> events_count))
+	{
+		return false;
+	}
+
+	for (uint8_t unit = 0; unit < rl78core_tau_units_count; ++unit)
+	{
+		for (uint8_t index = 0; index < rl78core_tau_channels_count; ++index)
+		{
+			const rl78core_snapshot_channel_s* const channel = &peripherals->channels[unit][index];
+
+			if ((channel->counting > 1) || (channel->shift > 63))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
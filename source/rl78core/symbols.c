@@ -0,0 +1,245 @@
+
+/**
+ * @file symbols.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+
+#include "rl78core/symbols.h"
+
+#include <stdlib.h>
+
+struct rl78core_symbols_s
+{
+	rl78core_symbol_s* entries;
+	const rl78core_symbol_s** by_name;
+	uint64_t count;
+	uint64_t capacity;
+	uint32_t largest;
+	bool_t sorted;
+};
+
+/**
+ * @brief Compare two symbols by their address, then by their size, and then by
+ * their name.
+ * 
+ * @param left  left symbol
+ * @param right right symbol
+ * 
+ * @return int32_t
+ */
+static int32_t compare_addresses(const void* const left, const void* const right);
+
+/**
+ * @brief Compare two pointers to symbols by the names of the symbols.
+ * 
+ * @param left  left pointer to a symbol
+ * @param right right pointer to a symbol
+ * 
+ * @return int32_t
+ */
+static int32_t compare_names(const void* const left, const void* const right);
+
+rl78core_symbols_s* rl78core_symbols_create(void)
+{
+	rl78core_symbols_s* const symbols = (rl78core_symbols_s*)rl78misc_malloc(sizeof(rl78core_symbols_s));
+	*symbols = (rl78core_symbols_s)
+	{
+		.entries = NULL,
+		.by_name = NULL,
+		.count = 0,
+		.capacity = 0,
+		.largest = 0,
+		.sorted = true,
+	};
+
+	return symbols;
+}
+
+void rl78core_symbols_destroy(rl78core_symbols_s* const symbols)
+{
+	rl78misc_debug_assert(symbols != NULL);
+
+	for (uint64_t index = 0; index < symbols->count; ++index)
+	{
+		(void)rl78misc_free(symbols->entries[index].name);
+	}
+
+	(void)rl78misc_free(symbols->entries);
+	(void)rl78misc_free(symbols->by_name);
+	(void)rl78misc_free(symbols);
+}
+
+void rl78core_symbols_add(rl78core_symbols_s* const symbols, const char_t* const name, const uint20_t address, const uint32_t size)
+{
+	rl78misc_debug_assert(symbols != NULL);
+	rl78misc_debug_assert(name != NULL);
+
+	if (symbols->count >= symbols->capacity)
+	{
+		symbols->capacity = (0 == symbols->capacity) ? 64 : (symbols->capacity * 2);
+		symbols->entries = (rl78core_symbol_s*)rl78misc_realloc(symbols->entries, symbols->capacity * sizeof(rl78core_symbol_s));
+	}
+
+	const uint64_t length = rl78misc_strlen(name) + 1;
+	char_t* const copy = (char_t*)rl78misc_malloc(length);
+	rl78misc_memcpy(copy, name, length);
+
+	symbols->entries[symbols->count++] = (rl78core_symbol_s)
+	{
+		.name = copy,
+		.address = address,
+		.size = size,
+	};
+
+	symbols->sorted = false;
+}
+
+void rl78core_symbols_sort(rl78core_symbols_s* const symbols)
+{
+	rl78misc_debug_assert(symbols != NULL);
+
+	if (symbols->sorted)
+	{
+		return;
+	}
+
+	qsort(symbols->entries, symbols->count, sizeof(rl78core_symbol_s), compare_addresses);
+	symbols->by_name = (const rl78core_symbol_s**)rl78misc_realloc(symbols->by_name, symbols->count * sizeof(rl78core_symbol_s*));
+	symbols->largest = 0;
+
+	for (uint64_t index = 0; index < symbols->count; ++index)
+	{
+		symbols->by_name[index] = &symbols->entries[index];
+
+		if (symbols->entries[index].size > symbols->largest)
+		{
+			symbols->largest = symbols->entries[index].size;
+		}
+	}
+
+	qsort(symbols->by_name, symbols->count, sizeof(rl78core_symbol_s*), compare_names);
+	symbols->sorted = true;
+}
+
+uint64_t rl78core_symbols_count(const rl78core_symbols_s* const symbols)
+{
+	rl78misc_debug_assert(symbols != NULL);
+	return symbols->count;
+}
+
+const rl78core_symbol_s* rl78core_symbols_at(const rl78core_symbols_s* const symbols, const uint64_t index)
+{
+	rl78misc_debug_assert(symbols != NULL);
+	rl78misc_debug_assert(symbols->sorted);
+	rl78misc_debug_assert(index < symbols->count);
+	return &symbols->entries[index];
+}
+
+const rl78core_symbol_s* rl78core_symbols_find(const rl78core_symbols_s* const symbols, const uint20_t address)
+{
+	rl78misc_debug_assert(symbols != NULL);
+	rl78misc_debug_assert(symbols->sorted);
+
+	// note: searches for the count of the symbols with their address not above the provided one.
+	uint64_t low = 0;
+	uint64_t high = symbols->count;
+
+	while (low < high)
+	{
+		const uint64_t middle = low + ((high - low) / 2);
+
+		if (symbols->entries[middle].address <= address)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	// note: walks back past the labels and the symbols ending before the address, while the preceding
+	// symbols are close enough for the largest one to still contain it.
+	for (; low > 0; --low)
+	{
+		const rl78core_symbol_s* const symbol = &symbols->entries[low - 1];
+		const uint32_t offset = address - symbol->address;
+
+		if ((0 == symbol->size) ? (0 == offset) : (offset < symbol->size))
+		{
+			return symbol;
+		}
+
+		if (offset >= symbols->largest)
+		{
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+const rl78core_symbol_s* rl78core_symbols_lookup(const rl78core_symbols_s* const symbols, const char_t* const name)
+{
+	rl78misc_debug_assert(symbols != NULL);
+	rl78misc_debug_assert(symbols->sorted);
+	rl78misc_debug_assert(name != NULL);
+
+	uint64_t low = 0;
+	uint64_t high = symbols->count;
+
+	while (low < high)
+	{
+		const uint64_t middle = low + ((high - low) / 2);
+		const int32_t order = rl78misc_strcmp(symbols->by_name[middle]->name, name);
+
+		if (0 == order)
+		{
+			return symbols->by_name[middle];
+		}
+
+		if (order < 0)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	return NULL;
+}
+
+static int32_t compare_addresses(const void* const left, const void* const right)
+{
+	const rl78core_symbol_s* const first = (const rl78core_symbol_s*)left;
+	const rl78core_symbol_s* const second = (const rl78core_symbol_s*)right;
+
+	if (first->address != second->address)
+	{
+		return (first->address < second->address) ? -1 : 1;
+	}
+
+	if (first->size != second->size)
+	{
+		return (first->size < second->size) ? -1 : 1;
+	}
+
+	return rl78misc_strcmp(first->name, second->name);
+}
+
+static int32_t compare_names(const void* const left, const void* const right)
+{
+	const rl78core_symbol_s* const first = *(const rl78core_symbol_s* const*)left;
+	const rl78core_symbol_s* const second = *(const rl78core_symbol_s* const*)right;
+	return rl78misc_strcmp(first->name, second->name);
+}
@@ -0,0 +1,808 @@
+
+/**
+ * @file tau.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+
+#include "rl78core/tau.h"
+#include "rl78core/mem.h"
+#include "rl78core/cpu.h"
+#include "rl78core/sched.h"
+#include "rl78core/intc.h"
+
+#define rl78core_tau_unit_length 0x40
+#define rl78core_tau_modes_offset 0x10
+#define rl78core_tau_statuses_offset 0x20
+#define rl78core_tau_enables_offset 0x30
+#define rl78core_tau_starts_offset 0x32
+#define rl78core_tau_stops_offset 0x34
+#define rl78core_tau_prescalers_offset 0x36
+#define rl78core_tau_outputs_offset 0x38
+#define rl78core_tau_output_enables_offset 0x3A
+#define rl78core_tau_output_levels_offset 0x3C
+#define rl78core_tau_output_modes_offset 0x3E
+
+#define rl78core_tau_mode_md0 0x0001
+#define rl78core_tau_mode_master 0x0800
+#define rl78core_tau_status_overflow 0x01
+
+typedef enum
+{
+	rl78core_tau_operation_interval = 0,
+	rl78core_tau_operation_capture = 2,
+	rl78core_tau_operation_event_counter = 3,
+	rl78core_tau_operation_one_count = 4,
+} rl78core_tau_operation_e;
+
+typedef enum
+{
+	rl78core_tau_trigger_software = 0,
+	rl78core_tau_trigger_input = 1,
+	rl78core_tau_trigger_master = 4,
+} rl78core_tau_trigger_e;
+
+typedef struct
+{
+	uint16_t mode;
+	uint16_t counter;  // note: value of the counter at the start cycles, counted from there while counting.
+	uint64_t start;    // note: the elapsed clock cycles of the count instead, while the units are frozen.
+	uint8_t shift;     // note: the count clock is the clock cycles of the cpu divided by 2 to this power.
+	uint8_t status;
+	bool_t counting;
+	uint8_t event;
+	uint8_t unit;
+	uint8_t index;
+} rl78core_tau_channel_s;
+
+typedef struct
+{
+	rl78core_tau_channel_s channels[rl78core_tau_channels_count];
+	uint16_t enables;
+	uint16_t prescalers;
+	uint16_t outputs;
+	uint16_t output_enables;
+	uint16_t output_levels;
+	uint16_t output_modes;
+} rl78core_tau_unit_s;
+
+struct rl78core_tau_s
+{
+	rl78core_tau_unit_s units[rl78core_tau_units_count];
+};
+
+static const uint20_t g_rl78core_tau_data_addresses[rl78core_tau_units_count][rl78core_tau_channels_count] =
+{
+	{ 0xFFF18, 0xFFF1A, 0xFFF64, 0xFFF66, 0xFFF68, 0xFFF6A, 0xFFF6C, 0xFFF6E, },
+	{ 0xFFF70, 0xFFF72, 0xFFF74, 0xFFF76, 0xFFF78, 0xFFF7A, 0xFFF7C, 0xFFF7E, },
+};
+
+static const uint8_t g_rl78core_tau_sources[rl78core_tau_units_count][rl78core_tau_channels_count] =
+{
+	{ 20, 21, 22, 23, 31, 32, 33, 34, },  // note: INTTM00 to INTTM07.
+	{ 41, 42, 43, 30, 50, 51, 52, 53, },  // note: INTTM10 to INTTM17.
+};
+
+static const uint8_t g_rl78core_tau_ckm2_shifts[4] = { 1, 2, 4, 6, };
+static const uint8_t g_rl78core_tau_ckm3_shifts[4] = { 8, 10, 12, 14, };
+
+/**
+ * @brief Get the operation mode of a channel, from the MD3 to MD1 bits of its
+ * mode register.
+ * 
+ * @param channel channel to get the operation mode of
+ * 
+ * @return rl78core_tau_operation_e
+ */
+static rl78core_tau_operation_e operation_of(const rl78core_tau_channel_s* const channel);
+
+/**
+ * @brief Get the start trigger of a channel, from the STS bits of its mode
+ * register.
+ * 
+ * @param channel channel to get the start trigger of
+ * 
+ * @return rl78core_tau_trigger_e
+ */
+static rl78core_tau_trigger_e trigger_of(const rl78core_tau_channel_s* const channel);
+
+/**
+ * @brief Check if a channel is a master, which starts the slave channels that
+ * follow it. The channel 0 is always a master, and the other even channels are
+ * with their MASTER bit set.
+ * 
+ * @param channel channel to check
+ * 
+ * @return bool_t
+ */
+static bool_t is_master(const rl78core_tau_channel_s* const channel);
+
+/**
+ * @brief Read the data register of a channel.
+ * 
+ * @param machine machine to operate on
+ * @param channel channel to read the data register of
+ * 
+ * @return uint16_t
+ */
+static uint16_t read_data(rl78core_machine_s* const machine, const rl78core_tau_channel_s* const channel);
+
+/**
+ * @brief Check if the units are frozen, while the cpu is in the stop mode.
+ * 
+ * @param machine machine to operate on
+ * 
+ * @return bool_t
+ */
+static bool_t is_frozen(rl78core_machine_s* const machine);
+
+/**
+ * @brief Compute the value of the counter of a channel, at the current clock
+ * cycle of the cpu.
+ * 
+ * @param machine machine to operate on
+ * @param channel channel to compute the counter of
+ * 
+ * @return uint16_t
+ */
+static uint16_t read_counter(rl78core_machine_s* const machine, const rl78core_tau_channel_s* const channel);
+
+/**
+ * @brief Load the counter of a channel, and start counting it from a provided
+ * clock cycle. The end of the count is scheduled for the modes counting down.
+ * 
+ * @param machine machine to operate on
+ * @param channel channel to start counting
+ * @param cycles  clock cycle to count from
+ * @param counter value to load the counter with
+ */
+static void begin_count(rl78core_machine_s* const machine, rl78core_tau_channel_s* const channel, const uint64_t cycles, const uint16_t counter);
+
+/**
+ * @brief Schedule the end of the count of a counting channel, if its mode
+ * counts down.
+ * 
+ * @param machine machine to operate on
+ * @param channel channel to schedule the end of the count of
+ */
+static void schedule_end(rl78core_machine_s* const machine, const rl78core_tau_channel_s* const channel);
+
+/**
+ * @brief Start the count of a channel in the one-count mode, on its start
+ * trigger.
+ * 
+ * @param machine machine to operate on
+ * @param channel channel to trigger
+ * @param cycles  clock cycle of the trigger
+ */
+static void trigger_count(rl78core_machine_s* const machine, rl78core_tau_channel_s* const channel, const uint64_t cycles);
+
+/**
+ * @brief Raise the INTTM interrupt of a channel, update its output, and start
+ * its slave channels if it is a master.
+ * 
+ * @param machine machine to operate on
+ * @param channel channel to raise the interrupt of
+ * @param cycles  clock cycle of the interrupt
+ */
+static void raise_interrupt(rl78core_machine_s* const machine, rl78core_tau_channel_s* const channel, const uint64_t cycles);
+
+/**
+ * @brief Enable a channel, on the write of its TS bit.
+ * 
+ * @param machine machine to operate on
+ * @param channel channel to enable
+ * @param cycles  clock cycle of the write
+ */
+static void start_channel(rl78core_machine_s* const machine, rl78core_tau_channel_s* const channel, const uint64_t cycles);
+
+/**
+ * @brief Disable a channel, on the write of its TT bit. The counter holds its
+ * value.
+ * 
+ * @param machine machine to operate on
+ * @param channel channel to disable
+ */
+static void stop_channel(rl78core_machine_s* const machine, rl78core_tau_channel_s* const channel);
+
+/**
+ * @brief Handle the end of the count of a channel, as an event of the
+ * scheduler.
+ * 
+ * @param machine machine the event is dispatched on
+ * @param context channel of the event
+ * @param cycles  clock cycle of the end of the count
+ */
+static void expire(rl78core_machine_s* const machine, void* const context, const uint64_t cycles);
+
+/**
+ * @brief Read a byte of the registers of the units.
+ * 
+ * @param machine machine whose memory is read
+ * @param context units of the machine
+ * @param address address to read at
+ * 
+ * @return uint8_t
+ */
+static uint8_t read_register(rl78core_machine_s* const machine, void* const context, const uint20_t address);
+
+/**
+ * @brief Write a byte of the registers of the units.
+ * 
+ * @param machine machine whose memory is written
+ * @param context units of the machine
+ * @param address address to write value at
+ * @param value   value to write
+ */
+static void write_register(rl78core_machine_s* const machine, void* const context, const uint20_t address, const uint8_t value);
+
+rl78core_tau_s* rl78core_tau_create(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78core_tau_s* const tau = (rl78core_tau_s*)rl78misc_malloc(sizeof(rl78core_tau_s));
+
+	for (uint8_t unit = 0; unit < rl78core_tau_units_count; ++unit)
+	{
+		for (uint8_t index = 0; index < rl78core_tau_channels_count; ++index)
+		{
+			rl78core_tau_channel_s* const channel = &tau->units[unit].channels[index];
+			channel->unit = unit;
+			channel->index = index;
+			channel->event = rl78core_sched_add_event_r(machine, expire, channel);
+			rl78misc_debug_assert(channel->event != rl78core_sched_no_event);
+		}
+	}
+
+	const bool_t mapped = rl78core_mem_map_io_r(machine, rl78core_tau_registers_address, rl78core_tau_registers_length,
+		read_register, write_register, tau);
+	rl78misc_debug_assert(mapped);
+	return tau;
+}
+
+void rl78core_tau_destroy(rl78core_tau_s* const tau)
+{
+	rl78misc_debug_assert(tau != NULL);
+	(void)rl78misc_free(tau);
+}
+
+void rl78core_tau_init_r(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78core_tau_s* const tau = machine->tau;
+
+	for (uint8_t unit = 0; unit < rl78core_tau_units_count; ++unit)
+	{
+		tau->units[unit].enables = 0;
+		tau->units[unit].prescalers = 0;
+		tau->units[unit].outputs = 0;
+		tau->units[unit].output_enables = 0;
+		tau->units[unit].output_levels = 0;
+		tau->units[unit].output_modes = 0;
+
+		for (uint8_t index = 0; index < rl78core_tau_channels_count; ++index)
+		{
+			rl78core_tau_channel_s* const channel = &tau->units[unit].channels[index];
+			(void)rl78core_sched_cancel_r(machine, channel->event);
+			channel->mode = 0;
+			channel->counter = 0xFFFF;
+			channel->start = 0;
+			channel->shift = 0;
+			channel->status = 0;
+			channel->counting = false;
+		}
+	}
+}
+
+void rl78core_tau_input_r(rl78core_machine_s* const machine, const uint8_t unit, const uint8_t channel)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(unit < rl78core_tau_units_count);
+	rl78misc_debug_assert(channel < rl78core_tau_channels_count);
+	rl78core_tau_channel_s* const target = &machine->tau->units[unit].channels[channel];
+	const uint64_t cycles = rl78core_cpu_cycles_r(machine);
+
+	// note: the edges are not sampled without the count clock.
+	if ((0 == (machine->tau->units[unit].enables & (1 << channel))) || is_frozen(machine))
+	{
+		return;
+	}
+
+	switch (operation_of(target))
+	{
+		case rl78core_tau_operation_capture:
+		{
+			// note: the counter counts up from 0, so it overflowed since the previous
+			// capture once it counted more than its range.
+			const uint64_t clocks = (cycles - target->start) >> target->shift;
+			target->status = (clocks > UINT16_MAX) ? rl78core_tau_status_overflow : 0;
+			rl78core_mem_write_u16_r(machine, g_rl78core_tau_data_addresses[unit][channel], read_counter(machine, target));
+			begin_count(machine, target, cycles, 0);
+			raise_interrupt(machine, target, cycles);
+		} break;
+
+		case rl78core_tau_operation_event_counter:
+		{
+			if (target->counter <= 1)
+			{
+				target->counter = read_data(machine, target);
+				raise_interrupt(machine, target, cycles);
+			}
+			else
+			{
+				--target->counter;
+			}
+		} break;
+
+		case rl78core_tau_operation_one_count:
+		{
+			if (rl78core_tau_trigger_input == trigger_of(target))
+			{
+				trigger_count(machine, target, cycles);
+			}
+		} break;
+
+		default:
+		{
+		} break;
+	}
+}
+
+void rl78core_tau_freeze_r(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78core_tau_s* const tau = machine->tau;
+	const uint64_t cycles = rl78core_cpu_cycles_r(machine);
+
+	for (uint8_t unit = 0; unit < rl78core_tau_units_count; ++unit)
+	{
+		for (uint8_t index = 0; index < rl78core_tau_channels_count; ++index)
+		{
+			rl78core_tau_channel_s* const channel = &tau->units[unit].channels[index];
+
+			if (channel->counting)
+			{
+				(void)rl78core_sched_cancel_r(machine, channel->event);
+				channel->start = cycles - channel->start;
+			}
+		}
+	}
+}
+
+void rl78core_tau_resume_r(rl78core_machine_s* const machine)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78core_tau_s* const tau = machine->tau;
+	const uint64_t cycles = rl78core_cpu_cycles_r(machine);
+
+	for (uint8_t unit = 0; unit < rl78core_tau_units_count; ++unit)
+	{
+		for (uint8_t index = 0; index < rl78core_tau_channels_count; ++index)
+		{
+			rl78core_tau_channel_s* const channel = &tau->units[unit].channels[index];
+
+			if (channel->counting)
+			{
+				channel->start = cycles - channel->start;
+				schedule_end(machine, channel);
+			}
+		}
+	}
+}
+
+void rl78core_tau_save_r(rl78core_machine_s* const machine, rl78core_tau_state_s* const state)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(state != NULL);
+	const rl78core_tau_s* const tau = machine->tau;
+
+	for (uint8_t unit = 0; unit < rl78core_tau_units_count; ++unit)
+	{
+		const rl78core_tau_unit_s* const source = &tau->units[unit];
+		rl78core_tau_unit_state_s* const target = &state->units[unit];
+		target->enables = source->enables;
+		target->prescalers = source->prescalers;
+		target->outputs = source->outputs;
+		target->output_enables = source->output_enables;
+		target->output_levels = source->output_levels;
+		target->output_modes = source->output_modes;
+
+		for (uint8_t index = 0; index < rl78core_tau_channels_count; ++index)
+		{
+			const rl78core_tau_channel_s* const channel = &source->channels[index];
+			rl78core_tau_channel_state_s* const saved = &target->channels[index];
+			saved->mode = channel->mode;
+			saved->counter = channel->counter;
+			saved->start = channel->start;
+			saved->shift = channel->shift;
+			saved->status = channel->status;
+			saved->counting = channel->counting;
+		}
+	}
+}
+
+void rl78core_tau_restore_r(rl78core_machine_s* const machine, const rl78core_tau_state_s* const state)
+{
+	rl78misc_debug_assert(machine != NULL);
+	rl78misc_debug_assert(state != NULL);
+	rl78core_tau_s* const tau = machine->tau;
+
+	for (uint8_t unit = 0; unit < rl78core_tau_units_count; ++unit)
+	{
+		const rl78core_tau_unit_state_s* const source = &state->units[unit];
+		rl78core_tau_unit_s* const target = &tau->units[unit];
+		target->enables = source->enables;
+		target->prescalers = source->prescalers;
+		target->outputs = source->outputs;
+		target->output_enables = source->output_enables;
+		target->output_levels = source->output_levels;
+		target->output_modes = source->output_modes;
+
+		for (uint8_t index = 0; index < rl78core_tau_channels_count; ++index)
+		{
+			const rl78core_tau_channel_state_s* const saved = &source->channels[index];
+			rl78core_tau_channel_s* const channel = &target->channels[index];
+			channel->mode = saved->mode;
+			channel->counter = saved->counter;
+			channel->start = saved->start;
+			channel->shift = saved->shift;
+			channel->status = saved->status;
+			channel->counting = saved->counting;
+		}
+	}
+}
+
+void rl78core_tau_init(void)
+{
+	rl78core_tau_init_r(rl78core_machine_default());
+}
+
+void rl78core_tau_input(const uint8_t unit, const uint8_t channel)
+{
+	rl78core_tau_input_r(rl78core_machine_default(), unit, channel);
+}
+
+void rl78core_tau_freeze(void)
+{
+	rl78core_tau_freeze_r(rl78core_machine_default());
+}
+
+void rl78core_tau_resume(void)
+{
+	rl78core_tau_resume_r(rl78core_machine_default());
+}
+
+void rl78core_tau_save(rl78core_tau_state_s* const state)
+{
+	rl78core_tau_save_r(rl78core_machine_default(), state);
+}
+
+void rl78core_tau_restore(const rl78core_tau_state_s* const state)
+{
+	rl78core_tau_restore_r(rl78core_machine_default(), state);
+}
+
+static rl78core_tau_operation_e operation_of(const rl78core_tau_channel_s* const channel)
+{
+	return (rl78core_tau_operation_e)((channel->mode >> 1) & 0x07);
+}
+
+static rl78core_tau_trigger_e trigger_of(const rl78core_tau_channel_s* const channel)
+{
+	return (rl78core_tau_trigger_e)((channel->mode >> 8) & 0x07);
+}
+
+static bool_t is_master(const rl78core_tau_channel_s* const channel)
+{
+	return (0 == channel->index) || ((0 == (channel->index % 2)) && (0 != (channel->mode & rl78core_tau_mode_master)));
+}
+
+static uint16_t read_data(rl78core_machine_s* const machine, const rl78core_tau_channel_s* const channel)
+{
+	return rl78core_mem_read_u16_r(machine, g_rl78core_tau_data_addresses[channel->unit][channel->index]);
+}
+
+static bool_t is_frozen(rl78core_machine_s* const machine)
+{
+	return rl78core_cpu_standby_stop == rl78core_cpu_get_standby_r(machine);
+}
+
+static uint16_t read_counter(rl78core_machine_s* const machine, const rl78core_tau_channel_s* const channel)
+{
+	if (!channel->counting)
+	{
+		return channel->counter;
+	}
+
+	const uint64_t elapsed = is_frozen(machine) ? channel->start : rl78core_cpu_cycles_r(machine) - channel->start;
+	const uint64_t clocks = elapsed >> channel->shift;
+
+	if (rl78core_tau_operation_capture == operation_of(channel))
+	{
+		return (uint16_t)(channel->counter + clocks);
+	}
+
+	// note: the end of the count is dispatched at the next instruction boundary,
+	// so the counter is held at 0 until then.
+	return (clocks < channel->counter) ? (uint16_t)(channel->counter - clocks) : 0;
+}
+
+static void begin_count(rl78core_machine_s* const machine, rl78core_tau_channel_s* const channel, const uint64_t cycles, const uint16_t counter)
+{
+	const rl78core_tau_unit_s* const unit = &machine->tau->units[channel->unit];
+	const uint16_t prescalers = unit->prescalers;
+
+	// note: the CKS bits select the prescaler of the count clock: CKm0, CKm2,
+	// CKm1 or CKm3, in this order.
+	switch ((channel->mode >> 14) & 0x03)
+	{
+		case 0:  { channel->shift = (uint8_t)(prescalers & 0x0F); } break;
+		case 1:  { channel->shift = g_rl78core_tau_ckm2_shifts[(prescalers >> 8) & 0x03]; } break;
+		case 2:  { channel->shift = (uint8_t)((prescalers >> 4) & 0x0F); } break;
+		default: { channel->shift = g_rl78core_tau_ckm3_shifts[(prescalers >> 12) & 0x03]; } break;
+	}
+
+	channel->counter = counter;
+	channel->start = cycles;
+	channel->counting = true;
+	schedule_end(machine, channel);
+}
+
+static void schedule_end(rl78core_machine_s* const machine, const rl78core_tau_channel_s* const channel)
+{
+	// note: the counts down end one count clock after the counter reaches 0.
+	const rl78core_tau_operation_e operation = operation_of(channel);
+
+	if ((rl78core_tau_operation_interval == operation) || (rl78core_tau_operation_one_count == operation))
+	{
+		rl78core_sched_schedule_r(machine, channel->event, channel->start + (((uint64_t)channel->counter + 1) << channel->shift));
+	}
+}
+
+static void trigger_count(rl78core_machine_s* const machine, rl78core_tau_channel_s* const channel, const uint64_t cycles)
+{
+	const rl78core_tau_unit_s* const unit = &machine->tau->units[channel->unit];
+
+	if ((0 == (unit->enables & (1 << channel->index))) || (operation_of(channel) != rl78core_tau_operation_one_count))
+	{
+		return;
+	}
+
+	// note: a trigger during the count restarts it only with the MD0 bit set.
+	if (channel->counting && (0 == (channel->mode & rl78core_tau_mode_md0)))
+	{
+		return;
+	}
+
+	begin_count(machine, channel, cycles, read_data(machine, channel));
+}
+
+static void raise_interrupt(rl78core_machine_s* const machine, rl78core_tau_channel_s* const channel, const uint64_t cycles)
+{
+	rl78core_tau_unit_s* const unit = &machine->tau->units[channel->unit];
+	const uint16_t bit = (uint16_t)(1 << channel->index);
+	rl78core_intc_request_r(machine, g_rl78core_tau_sources[channel->unit][channel->index]);
+
+	// note: the output of a master toggles on its interrupts, while the output of
+	// a slave is set by the interrupts of its master, and reset by its own ones.
+	// The TOL bits invert the active level of the outputs of the slaves.
+	if (0 != (unit->output_enables & bit))
+	{
+		if (0 != (unit->output_modes & bit))
+		{
+			unit->outputs = (uint16_t)((unit->outputs & ~bit) | (unit->output_levels & bit));
+		}
+		else
+		{
+			unit->outputs ^= bit;
+		}
+	}
+
+	if (!is_master(channel))
+	{
+		return;
+	}
+
+	for (uint8_t index = (uint8_t)(channel->index + 1); index < rl78core_tau_channels_count; ++index)
+	{
+		rl78core_tau_channel_s* const slave = &unit->channels[index];
+		const uint16_t slave_bit = (uint16_t)(1 << index);
+
+		if (is_master(slave))
+		{
+			break;
+		}
+
+		if ((rl78core_tau_trigger_master != trigger_of(slave)) || (0 == (unit->enables & slave_bit)))
+		{
+			continue;
+		}
+
+		if (0 != (unit->output_enables & unit->output_modes & slave_bit))
+		{
+			unit->outputs = (uint16_t)((unit->outputs & ~slave_bit) | (~unit->output_levels & slave_bit));
+		}
+
+		trigger_count(machine, slave, cycles);
+	}
+}
+
+static void start_channel(rl78core_machine_s* const machine, rl78core_tau_channel_s* const channel, const uint64_t cycles)
+{
+	rl78core_tau_unit_s* const unit = &machine->tau->units[channel->unit];
+	unit->enables |= (uint16_t)(1 << channel->index);
+	(void)rl78core_sched_cancel_r(machine, channel->event);
+	channel->counting = false;
+
+	switch (operation_of(channel))
+	{
+		case rl78core_tau_operation_interval:
+		{
+			begin_count(machine, channel, cycles, read_data(machine, channel));
+
+			// note: the MD0 bit raises the interrupt at the start of the count too,
+			// which starts the slaves of a master in the pwm function.
+			if (0 != (channel->mode & rl78core_tau_mode_md0))
+			{
+				raise_interrupt(machine, channel, cycles);
+			}
+		} break;
+
+		case rl78core_tau_operation_capture:
+		{
+			channel->status = 0;
+			begin_count(machine, channel, cycles, 0);
+
+			if (0 != (channel->mode & rl78core_tau_mode_md0))
+			{
+				raise_interrupt(machine, channel, cycles);
+			}
+		} break;
+
+		case rl78core_tau_operation_event_counter:
+		{
+			channel->counter = read_data(machine, channel);
+		} break;
+
+		case rl78core_tau_operation_one_count:
+		{
+			channel->counter = 0xFFFF;
+
+			if (rl78core_tau_trigger_software == trigger_of(channel))
+			{
+				trigger_count(machine, channel, cycles);
+			}
+		} break;
+
+		default:
+		{
+		} break;
+	}
+}
+
+static void stop_channel(rl78core_machine_s* const machine, rl78core_tau_channel_s* const channel)
+{
+	rl78core_tau_unit_s* const unit = &machine->tau->units[channel->unit];
+	unit->enables &= (uint16_t)~(1 << channel->index);
+	(void)rl78core_sched_cancel_r(machine, channel->event);
+	channel->counter = read_counter(machine, channel);
+	channel->counting = false;
+}
+
+static void expire(rl78core_machine_s* const machine, void* const context, const uint64_t cycles)
+{
+	rl78core_tau_channel_s* const channel = (rl78core_tau_channel_s*)context;
+
+	// note: the interval timer reloads its counter from the data register, which
+	// the program may have changed during the previous count, while the one-count
+	// mode waits for the next trigger.
+	if (rl78core_tau_operation_interval == operation_of(channel))
+	{
+		begin_count(machine, channel, cycles, read_data(machine, channel));
+	}
+	else
+	{
+		channel->counter = 0xFFFF;
+		channel->counting = false;
+	}
+
+	raise_interrupt(machine, channel, cycles);
+}
+
+static uint8_t read_register(rl78core_machine_s* const machine, void* const context, const uint20_t address)
+{
+	rl78core_tau_s* const tau = (rl78core_tau_s*)context;
+	const uint20_t offset = address - rl78core_tau_registers_address;
+	const rl78core_tau_unit_s* const unit = &tau->units[offset / rl78core_tau_unit_length];
+	const uint20_t position = (offset % rl78core_tau_unit_length) & ~(uint20_t)1;
+	uint16_t value = 0;
+
+	if (position < rl78core_tau_modes_offset)
+	{
+		value = read_counter(machine, &unit->channels[position / 2]);
+	}
+	else if (position < rl78core_tau_statuses_offset)
+	{
+		value = unit->channels[(position - rl78core_tau_modes_offset) / 2].mode;
+	}
+	else if (position < rl78core_tau_enables_offset)
+	{
+		value = unit->channels[(position - rl78core_tau_statuses_offset) / 2].status;
+	}
+	else
+	{
+		switch (position)
+		{
+			case rl78core_tau_enables_offset:        { value = unit->enables; } break;
+			case rl78core_tau_prescalers_offset:     { value = unit->prescalers; } break;
+			case rl78core_tau_outputs_offset:        { value = unit->outputs; } break;
+			case rl78core_tau_output_enables_offset: { value = unit->output_enables; } break;
+			case rl78core_tau_output_levels_offset:  { value = unit->output_levels; } break;
+			case rl78core_tau_output_modes_offset:   { value = unit->output_modes; } break;
+			default: { value = 0; } break;  // note: the TS and TT triggers are read as 0.
+		}
+	}
+
+	return (uint8_t)((0 != (address & 1)) ? (value >> 8) : (value & 0x00FF));
+}
+
+static void write_register(rl78core_machine_s* const machine, void* const context, const uint20_t address, const uint8_t value)
+{
+	rl78core_tau_s* const tau = (rl78core_tau_s*)context;
+	const uint20_t offset = address - rl78core_tau_registers_address;
+	rl78core_tau_unit_s* const unit = &tau->units[offset / rl78core_tau_unit_length];
+	const uint20_t position = (offset % rl78core_tau_unit_length) & ~(uint20_t)1;
+	const uint16_t mask = (0 != (address & 1)) ? 0xFF00 : 0x00FF;
+	const uint16_t bits = (uint16_t)((0 != (address & 1)) ? (value << 8) : value);
+
+	// note: the counter, status and enable registers are read-only, and the
+	// 8-bit timer mode triggers in the upper bytes of TS and TT are ignored.
+	if ((position >= rl78core_tau_modes_offset) && (position < rl78core_tau_statuses_offset))
+	{
+		rl78core_tau_channel_s* const channel = &unit->channels[(position - rl78core_tau_modes_offset) / 2];
+		channel->mode = (uint16_t)((channel->mode & ~mask) | bits);
+		return;
+	}
+
+	const uint64_t cycles = rl78core_cpu_cycles_r(machine);
+
+	switch (position)
+	{
+		case rl78core_tau_starts_offset:
+		case rl78core_tau_stops_offset:
+		{
+			// note: the slaves are started before their master, so that the
+			// interrupt at the start of the master triggers them.
+			for (uint8_t index = rl78core_tau_channels_count; index-- > 0;)
+			{
+				if (0 == (bits & (1 << index)))
+				{
+					continue;
+				}
+
+				if (rl78core_tau_starts_offset == position)
+				{
+					start_channel(machine, &unit->channels[index], cycles);
+				}
+				else
+				{
+					stop_channel(machine, &unit->channels[index]);
+				}
+			}
+		} break;
+
+		// note: the outputs are written by the program only while disabled.
+		case rl78core_tau_prescalers_offset:     { unit->prescalers = (uint16_t)((unit->prescalers & ~mask) | bits); } break;
+		case rl78core_tau_outputs_offset:        { unit->outputs = (uint16_t)((unit->outputs & ~(mask & ~unit->output_enables)) | (bits & ~unit->output_enables)); } break;
+		case rl78core_tau_output_enables_offset: { unit->output_enables = (uint16_t)((unit->output_enables & ~mask) | bits); } break;
+		case rl78core_tau_output_levels_offset:  { unit->output_levels = (uint16_t)((unit->output_levels & ~mask) | bits); } break;
+		case rl78core_tau_output_modes_offset:   { unit->output_modes = (uint16_t)((unit->output_modes & ~mask) | bits); } break;
+		default: { } break;
+	}
+}
@@ -0,0 +1,108 @@
+
+/**
+ * @file file.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/debug.h"
+#include "rl78misc/logger.h"
+#include "rl78misc/file.h"
+
+#include <stdio.h>
+
+#if rl78misc_file_mmap_enabled
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+const uint8_t* rl78misc_file_map(
+	const char_t* const path,
+	uint64_t* const length)
+{
+	rl78misc_debug_assert(path != NULL);
+	rl78misc_debug_assert(length != NULL);
+
+#if rl78misc_file_mmap_enabled
+	const int32_t descriptor = open(path, O_RDONLY);
+
+	if (descriptor < 0)
+	{
+		rl78misc_logger_error("failed to open the file '%s'.", path);
+		return NULL;
+	}
+
+	struct stat status;
+
+	if (fstat(descriptor, &status) != 0 || status.st_size <= 0)
+	{
+		rl78misc_logger_error("failed to read the file '%s', or it is empty.", path);
+		(void)close(descriptor);
+		return NULL;
+	}
+
+	*length = (uint64_t)status.st_size;
+	void* const contents = mmap(NULL, *length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	(void)close(descriptor);
+
+	if (MAP_FAILED == contents)
+	{
+		rl78misc_logger_error("failed to map the file '%s'.", path);
+		return NULL;
+	}
+
+	return (const uint8_t*)contents;
+#else
+	FILE* const file = fopen(path, "rb");
+
+	if (NULL == file)
+	{
+		rl78misc_logger_error("failed to open the file '%s'.", path);
+		return NULL;
+	}
+
+	const int64_t size = (0 == fseek(file, 0, SEEK_END)) ? (int64_t)ftell(file) : -1;
+
+	if (size <= 0 || fseek(file, 0, SEEK_SET) != 0)
+	{
+		rl78misc_logger_error("failed to read the file '%s', or it is empty.", path);
+		(void)fclose(file);
+		return NULL;
+	}
+
+	*length = (uint64_t)size;
+	uint8_t* const contents = (uint8_t*)rl78misc_malloc(*length);
+	const bool_t read = (fread(contents, 1, *length, file) == *length);
+	(void)fclose(file);
+
+	if (!read)
+	{
+		rl78misc_logger_error("failed to read the file '%s'.", path);
+		(void)rl78misc_free(contents);
+		return NULL;
+	}
+
+	return contents;
+#endif
+}
+
+void rl78misc_file_unmap(
+	const uint8_t* const contents,
+	const uint64_t length)
+{
+	rl78misc_debug_assert(contents != NULL);
+
+#if rl78misc_file_mmap_enabled
+	(void)munmap((void*)contents, length);
+#else
+	(void)length;
+	(void)rl78misc_free(contents);
+#endif
+}
@@ -13,64 +13,247 @@
 #include "rl78misc/debug.h"
 #include "rl78misc/logger.h"
 
+#include <pthread.h>
+#include <sched.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
 
+/**
+ * note: the asynchronous backend queues the records in a bounded ring, which
+ * any count of producers push to, and the background thread pops from. Every
+ * record carries a sequence number: it equals the position of the record for
+ * a producer to claim it, and the position plus one for the thread to pop it.
+ * A producer claims a position with a single compare and swap, so the logging
+ * threads never block on each other, nor on the writes of the thread. Only the
+ * trace and info records are dropped while the queue is full: the producers of
+ * the other levels wait for the thread to pop a record.
+ */
+
+#define rl78misc_logger_batch_capacity 65536
+#define rl78misc_logger_idle_nanoseconds 1000000
+
+/**
+ * @brief Formatted message queued for the background thread.
+ */
+typedef struct
+{
+	atomic_uint_fast64_t sequence;
+	FILE* stream;
+	uint64_t length;
+	char_t text[rl78misc_logger_record_length];
+} rl78misc_logger_record_s;
+
+/**
+ * @brief State of the asynchronous backend.
+ */
+typedef struct
+{
+	rl78misc_logger_record_s records[rl78misc_logger_records_capacity];
+	atomic_uint_fast64_t head;  // note: next position to claim by the producers.
+	uint64_t tail;              // note: next position to pop by the thread.
+	atomic_uint_fast64_t dropped;
+	uint64_t reported;          // note: count of the dropped records already reported by the thread.
+	atomic_bool enabled;
+	atomic_bool running;
+	bool_t exit_registered;
+	pthread_t thread;
+	FILE* batch_stream;
+	uint64_t batch_length;
+	char_t batch[rl78misc_logger_batch_capacity];
+} rl78misc_logger_s;
+
+static rl78misc_logger_s g_rl78misc_logger;
+static uint8_t g_rl78misc_logger_level = rl78misc_logger_level_info;
+static const char_t* const g_rl78misc_logger_tags[rl78misc_logger_levels_count] =
+{
+	[rl78misc_logger_level_trace] = "\033[96m" "trace" "\033[0m",
+	[rl78misc_logger_level_info] = "\033[92m" "info" "\033[0m",
+	[rl78misc_logger_level_warn] = "\033[93m" "warn" "\033[0m",
+	[rl78misc_logger_level_error] = "\033[91m" "error" "\033[0m",
+	[rl78misc_logger_level_log] = NULL,
+};
+
+/**
+ * @brief Log a message with an optional tag, synchronously or through the
+ * asynchronous backend if it is started.
+ * 
+ * @param stream   stream to log into
+ * @param tag      tag of the log, or NULL
+ * @param lossless whether the message may not be dropped
+ * @param format   format of the log
+ * @param args     arguments of the log
+ */
 static void log_with_tag(
 	FILE* const stream,
 	const char_t* const tag,
+	const bool_t lossless,
 	const char_t* const format,
 	va_list args);
 
-void rl78misc_logger_log(
+/**
+ * @brief Format a message into a free record of the queue. If the queue is
+ * full, a lossless message waits for a free record, and any other is dropped.
+ * 
+ * @param stream   stream to log into
+ * @param tag      tag of the log, or NULL
+ * @param lossless whether the message may not be dropped
+ * @param format   format of the log
+ * @param args     arguments of the log
+ * 
+ * @return bool_t false if the message is not queued: it is dropped, or the
+ * backend got stopped while it waited
+ */
+static bool_t push_record(
+	FILE* const stream,
+	const char_t* const tag,
+	const bool_t lossless,
+	const char_t* const format,
+	va_list args);
+
+/**
+ * @brief Pop the queued records into the batch, writing the batch out whenever
+ * it fills up, or its stream changes.
+ * 
+ * @return bool_t false if the queue was empty
+ */
+static bool_t pop_records(
+	void);
+
+/**
+ * @brief Write the batch out into its stream.
+ */
+static void write_batch(
+	void);
+
+/**
+ * @brief Report the records dropped since the previous report.
+ */
+static void report_dropped(
+	void);
+
+/**
+ * @brief Entry point of the background thread: pops the queued records until
+ * the backend is stopped and the queue is drained.
+ * 
+ * @param argument unused
+ * 
+ * @return void* unused
+ */
+static void* logger_main(
+	void* argument);
+
+/**
+ * @brief Stop the asynchronous backend on exit, so that no record is lost.
+ */
+static void stop_on_exit(
+	void);
+
+void rl78misc_logger_write(
+	const uint8_t level,
 	const char_t* const format,
 	...)
 {
+	rl78misc_debug_assert(level < rl78misc_logger_levels_count);
 	rl78misc_debug_assert(format != NULL);
+	FILE* const stream = ((level >= rl78misc_logger_level_warn) && (level != rl78misc_logger_level_log)) ? stderr : stdout;
+	const bool_t lossless = (level >= rl78misc_logger_level_warn);
 	va_list args; va_start(args, format);
-	log_with_tag(stdout, NULL, format, args);
+	log_with_tag(stream, g_rl78misc_logger_tags[level], lossless, format, args);
 	va_end(args);
 }
 
-void rl78misc_logger_info(
-	const char_t* const format,
-	...)
+bool_t rl78misc_logger_enabled(
+	const uint8_t level)
 {
-	rl78misc_debug_assert(format != NULL);
-	va_list args; va_start(args, format);
-	log_with_tag(stdout, "\033[92m" "info" "\033[0m", format, args);
-	va_end(args);
+	return (level >= g_rl78misc_logger_level);
 }
 
-void rl78misc_logger_warn(
-	const char_t* const format,
-	...)
+void rl78misc_logger_set_level(
+	const uint8_t level)
 {
-	rl78misc_debug_assert(format != NULL);
-	va_list args; va_start(args, format);
-	log_with_tag(stderr, "\033[93m" "warn" "\033[0m", format, args);
-	va_end(args);
+	rl78misc_debug_assert(level <= rl78misc_logger_level_error);
+	g_rl78misc_logger_level = level;
 }
 
-void rl78misc_logger_error(
-	const char_t* const format,
-	...)
+void rl78misc_logger_start(
+	void)
 {
-	rl78misc_debug_assert(format != NULL);
-	va_list args; va_start(args, format);
-	log_with_tag(stderr, "\033[91m" "error" "\033[0m", format, args);
-	va_end(args);
+	rl78misc_logger_s* const logger = &g_rl78misc_logger;
+
+	if (atomic_load(&logger->running))
+	{
+		return;
+	}
+
+	for (uint64_t index = 0; index < rl78misc_logger_records_capacity; ++index)
+	{
+		atomic_init(&logger->records[index].sequence, index);
+	}
+
+	atomic_store(&logger->head, 0);
+	logger->tail = 0;
+	logger->batch_stream = NULL;
+	logger->batch_length = 0;
+	(void)fflush(stdout);
+	(void)fflush(stderr);
+	atomic_store(&logger->running, true);
+
+	if (pthread_create(&logger->thread, NULL, logger_main, NULL) != 0)
+	{
+		atomic_store(&logger->running, false);
+		rl78misc_logger_warn("failed to start the logger thread, logging synchronously.");
+		return;
+	}
+
+	if (!logger->exit_registered)
+	{
+		logger->exit_registered = (0 == atexit(stop_on_exit));
+	}
+
+	atomic_store(&logger->enabled, true);
+}
+
+void rl78misc_logger_stop(
+	void)
+{
+	rl78misc_logger_s* const logger = &g_rl78misc_logger;
+
+	if (!atomic_load(&logger->running))
+	{
+		return;
+	}
+
+	atomic_store(&logger->enabled, false);
+	atomic_store(&logger->running, false);
+	(void)pthread_join(logger->thread, NULL);
+}
+
+uint64_t rl78misc_logger_dropped(
+	void)
+{
+	return (uint64_t)atomic_load(&g_rl78misc_logger.dropped);
 }
 
 static void log_with_tag(
 	FILE* const stream,
 	const char_t* const tag,
+	const bool_t lossless,
 	const char_t* const format,
 	va_list args)
 {
 	rl78misc_debug_assert(stream != NULL);
 	rl78misc_debug_assert(format != NULL);
 
+	// note: a lossless message, which is not queued, is written synchronously.
+	if (atomic_load_explicit(&g_rl78misc_logger.enabled, memory_order_relaxed) &&
+		(push_record(stream, tag, lossless, format, args) || !lossless))
+	{
+		return;
+	}
+
 	if (tag != NULL)
 	{
 		(void)fprintf(stream, "%s: ", tag);
@@ -79,3 +262,159 @@ static void log_with_tag(
 	(void)vfprintf(stream, format, args);
 	(void)fprintf(stream, "\n");
 }
+
+static bool_t push_record(
+	FILE* const stream,
+	const char_t* const tag,
+	const bool_t lossless,
+	const char_t* const format,
+	va_list args)
+{
+	rl78misc_logger_s* const logger = &g_rl78misc_logger;
+	uint64_t position = (uint64_t)atomic_load_explicit(&logger->head, memory_order_relaxed);
+	rl78misc_logger_record_s* record = NULL;
+
+	while (true)
+	{
+		record = &logger->records[position & (rl78misc_logger_records_capacity - 1)];
+		const uint64_t sequence = (uint64_t)atomic_load_explicit(&record->sequence, memory_order_acquire);
+		const int64_t difference = (int64_t)(sequence - position);
+
+		if (0 == difference)
+		{
+			uint_fast64_t expected = position;
+
+			if (atomic_compare_exchange_weak_explicit(&logger->head, &expected, position + 1, memory_order_relaxed, memory_order_relaxed))
+			{
+				break;
+			}
+
+			position = (uint64_t)expected;
+		}
+		else if (difference < 0)
+		{
+			// note: the record is not popped yet, so the queue is full.
+			if (!lossless)
+			{
+				(void)atomic_fetch_add_explicit(&logger->dropped, 1, memory_order_relaxed);
+				return false;
+			}
+
+			if (!atomic_load(&logger->running))
+			{
+				return false;
+			}
+
+			(void)sched_yield();
+			position = (uint64_t)atomic_load_explicit(&logger->head, memory_order_relaxed);
+		}
+		else
+		{
+			position = (uint64_t)atomic_load_explicit(&logger->head, memory_order_relaxed);
+		}
+	}
+
+	const uint64_t capacity = rl78misc_logger_record_length - 1;  // note: the last byte is reserved for the new line.
+	int32_t length = (tag != NULL) ? snprintf(record->text, capacity, "%s: ", tag) : 0;
+	length = (length < 0) ? 0 : length;
+	length = ((uint64_t)length < capacity) ? length : (int32_t)capacity;
+	const int32_t message = vsnprintf(&record->text[length], capacity - (uint64_t)length, format, args);
+	length += (message < 0) ? 0 : message;
+	length = ((uint64_t)length < capacity) ? length : (int32_t)(capacity - 1);
+
+	record->text[length] = '\n';
+	record->stream = stream;
+	record->length = (uint64_t)length + 1;
+	atomic_store_explicit(&record->sequence, position + 1, memory_order_release);
+	return true;
+}
+
+static bool_t pop_records(
+	void)
+{
+	rl78misc_logger_s* const logger = &g_rl78misc_logger;
+	bool_t popped = false;
+
+	while (true)
+	{
+		rl78misc_logger_record_s* const record = &logger->records[logger->tail & (rl78misc_logger_records_capacity - 1)];
+
+		if ((uint64_t)atomic_load_explicit(&record->sequence, memory_order_acquire) != (logger->tail + 1))
+		{
+			return popped;
+		}
+
+		if ((record->stream != logger->batch_stream) || ((logger->batch_length + record->length) > rl78misc_logger_batch_capacity))
+		{
+			write_batch();
+			logger->batch_stream = record->stream;
+		}
+
+		rl78misc_memcpy(&logger->batch[logger->batch_length], record->text, record->length);
+		logger->batch_length += record->length;
+		atomic_store_explicit(&record->sequence, logger->tail + rl78misc_logger_records_capacity, memory_order_release);
+		++logger->tail;
+		popped = true;
+	}
+}
+
+static void write_batch(
+	void)
+{
+	rl78misc_logger_s* const logger = &g_rl78misc_logger;
+
+	if (logger->batch_length > 0)
+	{
+		(void)fwrite(logger->batch, 1, logger->batch_length, logger->batch_stream);
+		(void)fflush(logger->batch_stream);
+		logger->batch_length = 0;
+	}
+}
+
+static void report_dropped(
+	void)
+{
+	rl78misc_logger_s* const logger = &g_rl78misc_logger;
+	const uint64_t dropped = rl78misc_logger_dropped();
+
+	if (dropped != logger->reported)
+	{
+		(void)fprintf(stderr, "%s: %lu log records were dropped, as the queue was full.\n", g_rl78misc_logger_tags[rl78misc_logger_level_warn], dropped - logger->reported);
+		logger->reported = dropped;
+	}
+}
+
+static void* logger_main(
+	void* argument)
+{
+	(void)argument;
+	rl78misc_logger_s* const logger = &g_rl78misc_logger;
+	const struct timespec idle = { .tv_sec = 0, .tv_nsec = rl78misc_logger_idle_nanoseconds };
+
+	while (true)
+	{
+		// note: the flag is read before popping, so that the records pushed before the stop are drained.
+		const bool_t running = atomic_load(&logger->running);
+
+		if (!pop_records())
+		{
+			write_batch();
+			report_dropped();
+
+			if (!running)
+			{
+				break;
+			}
+
+			(void)nanosleep(&idle, NULL);
+		}
+	}
+
+	return NULL;
+}
+
+static void stop_on_exit(
+	void)
+{
+	rl78misc_logger_stop();
+}
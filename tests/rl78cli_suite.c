@@ -0,0 +1,117 @@
+
+/**
+ * @file rl78cli_suite.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/common.h"
+#include "rl78misc/debug.h"
+
+#include "rl78cli/farm.h"
+
+#include "./utester.h"
+
+static const uint8_t g_farm_firmware[] =
+{
+	0x8D, 0x00,  // 0x00000: MOV A, 0xFFE20
+	0x0C, 0x05,  // 0x00002: ADD A, #5
+	0x9D, 0x01,  // 0x00004: MOV 0xFFE21, A
+	0x61, 0xED,  // 0x00006: HALT
+};
+
+utester_define_test(rl78cli_farm_parse_vector_test)
+{
+	rl78cli_farm_vector_s vector = {0};
+
+	utester_assert_true(rl78cli_farm_parse_vector("  add_1 patch:FFE20=1 expect:0xFFE21=06 cycles:100\n", &vector));
+	utester_assert_equal(rl78misc_strcmp(vector.name, "add_1"), 0);
+	utester_assert_equal(vector.patches_count, 1);
+	utester_assert_equal(vector.patches[0].address, 0xFFE20);
+	utester_assert_equal(vector.patches[0].value, 0x01);
+	utester_assert_equal(vector.expects_count, 1);
+	utester_assert_equal(vector.expects[0].address, 0xFFE21);
+	utester_assert_equal(vector.expects[0].value, 0x06);
+	utester_assert_equal(vector.cycles, 100);
+
+	utester_assert_true(rl78cli_farm_parse_vector("empty", &vector));
+	utester_assert_equal(vector.patches_count, 0);
+	utester_assert_equal(vector.expects_count, 0);
+	utester_assert_equal(vector.cycles, rl78cli_farm_default_cycles);
+
+	utester_assert_false(rl78cli_farm_parse_vector("", &vector));
+	utester_assert_false(rl78cli_farm_parse_vector("bad patch:FFE20", &vector));
+	utester_assert_false(rl78cli_farm_parse_vector("bad patch:100000=00", &vector));
+	utester_assert_false(rl78cli_farm_parse_vector("bad expect:FFE20=100", &vector));
+	utester_assert_false(rl78cli_farm_parse_vector("bad cycles:0", &vector));
+	utester_assert_false(rl78cli_farm_parse_vector("bad unknown:1", &vector));
+}
+
+utester_define_test(rl78cli_farm_run_test)
+{
+	#define farm_vectors_count 37
+	rl78cli_farm_vector_s vectors[farm_vectors_count] = {0};
+	rl78cli_farm_result_s results[farm_vectors_count] = {0};
+	rl78core_mem_image_s* const image = rl78core_mem_image_create();
+	rl78core_mem_image_load(image, 0, g_farm_firmware, sizeof(g_farm_firmware));
+
+	for (uint8_t index = 0; index < farm_vectors_count; ++index)
+	{
+		vectors[index] = (rl78cli_farm_vector_s)
+		{
+			.name = "vector",
+			.patches = { { .address = 0xFFE20, .value = index } },
+			.patches_count = 1,
+			.expects = { { .address = 0xFFE21, .value = (uint8_t)(index + 5) } },
+			.expects_count = 1,
+			.cycles = rl78cli_farm_default_cycles,
+		};
+	}
+
+	// note: a wrong expectation, and a busy loop in place of the halt.
+	vectors[7].expects[0].value = 0;
+	vectors[11].patches[1] = (rl78cli_farm_pair_s) { .address = 0x00006, .value = 0xEF };
+	vectors[11].patches[2] = (rl78cli_farm_pair_s) { .address = 0x00007, .value = 0xFE };
+	vectors[11].patches_count = 3;
+	vectors[11].cycles = 100;
+
+	for (uint8_t engine = 0; engine < rl78core_cpu_engines_count; ++engine)
+	{
+		const rl78cli_farm_s farm =
+		{
+			.firmware = image,
+			.engine = (rl78core_cpu_engine_e)engine,
+			.workers = 4,
+			.vectors = vectors,
+			.vectors_count = farm_vectors_count,
+		};
+
+		rl78cli_farm_run(&farm, results);
+
+		for (uint8_t index = 0; index < farm_vectors_count; ++index)
+		{
+			utester_assert_equal(results[index].passed, (index != 7) && (index != 11));
+		}
+
+		utester_assert_equal(results[7].stop, rl78core_cpu_stop_halt);
+		utester_assert_equal(results[7].mismatch, 0);
+		utester_assert_equal(results[7].actual, 7 + 5);
+		utester_assert_equal(results[11].stop, rl78core_cpu_stop_budget);
+		utester_assert_equal(results[11].pc, 0x00006);
+		utester_assert_equal(rl78cli_farm_report(&farm, results, 0.0), 2);
+	}
+
+	rl78core_mem_image_destroy(image);
+	#undef farm_vectors_count
+}
+
+utester_run_suite(
+	rl78cli_suite,
+		&rl78cli_farm_parse_vector_test,
+		&rl78cli_farm_run_test,
+);
@@ -0,0 +1,386 @@
+
+/**
+ * @file rl78core_bench.c
+ * 
+ * @copyright This file is a part of the "rl78emu" project and is licensed, and
+ * distributed under "rl78emu gplv1" license.
+ * 
+ * @author joba14
+ * 
+ * @date 2026-10-16
+ */
+
+#include "rl78misc/logger.h"
+
+#include "rl78core/machine.h"
+#include "rl78core/mem.h"
+#include "rl78core/cpu.h"
+#include "rl78core/intc.h"
+#include "rl78core/loader.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define bench_instructions_count 20000000
+#define bench_accesses_count 100000000
+#define bench_loads_count 20
+#define bench_loader_image_size 0x80000
+#define bench_mov_firmware_length 0x1000
+
+/**
+ * note: the benchmark firmware is an endless loop of register, short direct
+ * address and alu instructions, closed with a conditional and an unconditional
+ * branch.
+ */
+static const uint8_t g_bench_firmware[] =
+{
+	0x53, 0x00,  // 0x00000: MOV B, #0
+	0x52, 0x00,  // 0x00002: MOV C, #0
+	0x63,        // 0x00004: MOV A, B
+	0x0C, 0x03,  // 0x00005: ADD A, #3
+	0x73,        // 0x00007: MOV B, A
+	0x9D, 0x20,  // 0x00008: MOV saddr, A
+	0x8D, 0x20,  // 0x0000A: MOV A, saddr
+	0x5C, 0x7F,  // 0x0000C: AND A, #0x7F
+	0x4C, 0x10,  // 0x0000E: CMP A, #0x10
+	0x92,        // 0x00010: DEC C
+	0xDF, 0xF1,  // 0x00011: BNZ $0x00004
+	0xEF, 0xEF,  // 0x00013: BR $0x00004
+};
+
+/**
+ * note: the arithmetic benchmark firmware is an endless loop of alu instructions,
+ * whose flags are overwritten before they get observed.
+ */
+static const uint8_t g_bench_alu_firmware[] =
+{
+	0x52, 0x00,  // 0x00000: MOV C, #0
+	0x0C, 0x03,  // 0x00002: ADD A, #3
+	0x2C, 0x01,  // 0x00004: SUB A, #1
+	0x0C, 0x11,  // 0x00006: ADD A, #0x11
+	0x4C, 0x40,  // 0x00008: CMP A, #0x40
+	0x2C, 0x05,  // 0x0000A: SUB A, #5
+	0x0C, 0x07,  // 0x0000C: ADD A, #7
+	0x4C, 0x10,  // 0x0000E: CMP A, #0x10
+	0x0C, 0x21,  // 0x00010: ADD A, #0x21
+	0x92,        // 0x00012: DEC C
+	0xDF, 0xED,  // 0x00013: BNZ $0x00002
+	0xEF, 0xE9,  // 0x00015: BR $0x00000
+};
+
+/**
+ * note: the mov benchmark firmware is limited to the MOV r, #byte instructions,
+ * the only ones the opcode switch decoded before the table-driven dispatch, so
+ * that the two can be compared on it. It is repeated over the first 4 KiB of
+ * the flash, and has no branches: the benchmark rewinds the pc to its start
+ * once it runs past its end.
+ */
+static const uint8_t g_bench_mov_firmware[] =
+{
+	0x50, 0x11,  // 0x00000: MOV X, #0x11
+	0x51, 0x22,  // 0x00002: MOV A, #0x22
+	0x52, 0x33,  // 0x00004: MOV C, #0x33
+	0x53, 0x44,  // 0x00006: MOV B, #0x44
+	0x54, 0x55,  // 0x00008: MOV E, #0x55
+	0x55, 0x66,  // 0x0000A: MOV D, #0x66
+	0x56, 0x77,  // 0x0000C: MOV L, #0x77
+	0x57, 0x88,  // 0x0000E: MOV H, #0x88
+};
+
+/**
+ * @brief Reset the emulator and flash a provided benchmark firmware.
+ * 
+ * @param firmware firmware to flash
+ * @param length   length of the firmware
+ */
+static void bench_reset(const uint8_t* const firmware, const uint20_t length);
+
+/**
+ * @brief Reset the emulator and flash the mov benchmark firmware repeatedly.
+ * 
+ * @return uint64_t count of instructions of the flashed firmware
+ */
+static uint64_t bench_reset_mov(void);
+
+/**
+ * @brief Get monotonic time in seconds.
+ * 
+ * @return double
+ */
+static double bench_now(void);
+
+/**
+ * @brief Report the throughput of a benchmark.
+ * 
+ * @param name    name of the benchmark
+ * @param count   count of processed instructions
+ * @param seconds duration of the benchmark
+ */
+static void bench_report(const char_t* const name, const uint64_t count, const double seconds);
+
+/**
+ * @brief Report the per-access cost of a memory benchmark.
+ * 
+ * @param name    name of the benchmark
+ * @param count   count of memory accesses
+ * @param seconds duration of the benchmark
+ */
+static void bench_report_accesses(const char_t* const name, const uint64_t count, const double seconds);
+
+/**
+ * @brief Build the intel hex text of an image of a provided size, with records
+ * of 32 data bytes.
+ * 
+ * @param size   size of the image
+ * @param length pointer to store the length of the text into
+ * 
+ * @return char_t* built text, to be freed by the caller
+ */
+static char_t* bench_build_ihex(const uint20_t size, uint64_t* const length);
+
+/**
+ * @brief Report the throughput of a loader benchmark.
+ * 
+ * @param name    name of the benchmark
+ * @param count   count of loaded bytes of text
+ * @param seconds duration of the benchmark
+ */
+static void bench_report_bytes(const char_t* const name, const uint64_t count, const double seconds);
+
+int32_t main(void);
+
+int32_t main(void)
+{
+	rl78misc_logger_info("Running benchmark 'rl78core_bench':");
+
+	{
+		bench_reset(g_bench_firmware, sizeof(g_bench_firmware));
+		const double start = bench_now();
+
+		for (uint64_t index = 0; index < bench_instructions_count; ++index)
+		{
+			rl78core_cpu_tick();
+		}
+
+		bench_report("rl78core_cpu_tick", bench_instructions_count, bench_now() - start);
+	}
+
+	{
+		bench_reset(g_bench_firmware, sizeof(g_bench_firmware));
+		const double start = bench_now();
+		rl78core_cpu_execute(bench_instructions_count);
+		bench_report("rl78core_cpu_execute", bench_instructions_count, bench_now() - start);
+	}
+
+	{
+		const uint64_t length = bench_reset_mov();
+		uint64_t count = 0;
+		const double start = bench_now();
+
+		for (; count < bench_instructions_count; count += length)
+		{
+			rl78core_cpu_write_pc(0x00000);
+
+			for (uint64_t index = 0; index < length; ++index)
+			{
+				rl78core_cpu_tick();
+			}
+		}
+
+		bench_report("rl78core_cpu_tick:mov", count, bench_now() - start);
+	}
+
+	{
+		const uint64_t length = bench_reset_mov();
+		uint64_t count = 0;
+		const double start = bench_now();
+
+		for (; count < bench_instructions_count; count += length)
+		{
+			rl78core_cpu_write_pc(0x00000);
+			rl78core_cpu_execute(length);
+		}
+
+		bench_report("rl78core_cpu_execute:mov", count, bench_now() - start);
+	}
+
+	{
+		bench_reset(g_bench_firmware, sizeof(g_bench_firmware));
+		const double start = bench_now();
+		rl78core_cpu_run((rl78core_cpu_budget_s) { .cycles = 0, .instructions = bench_instructions_count });
+		bench_report("rl78core_cpu_run", bench_instructions_count, bench_now() - start);
+	}
+
+	{
+		bench_reset(g_bench_firmware, sizeof(g_bench_firmware));
+		rl78core_cpu_set_engine(rl78core_cpu_engine_block);
+		const double start = bench_now();
+		rl78core_cpu_execute(bench_instructions_count);
+		bench_report("rl78core_cpu_execute:block", bench_instructions_count, bench_now() - start);
+	}
+
+	{
+		bench_reset(g_bench_firmware, sizeof(g_bench_firmware));
+		rl78core_cpu_set_engine(rl78core_cpu_engine_jit);
+		const double start = bench_now();
+		rl78core_cpu_execute(bench_instructions_count);
+		bench_report("rl78core_cpu_execute:jit", bench_instructions_count, bench_now() - start);
+	}
+
+	{
+		bench_reset(g_bench_alu_firmware, sizeof(g_bench_alu_firmware));
+		const double start = bench_now();
+		rl78core_cpu_execute(bench_instructions_count);
+		bench_report("rl78core_cpu_execute:alu", bench_instructions_count, bench_now() - start);
+	}
+
+	{
+		// note: the request stays pending while the interrupts are disabled, and
+		// must not make the engines leave at every boundary.
+		bench_reset(g_bench_firmware, sizeof(g_bench_firmware));
+		rl78core_intc_request(0);
+		const double start = bench_now();
+		rl78core_cpu_execute(bench_instructions_count);
+		bench_report("rl78core_cpu_execute:pending", bench_instructions_count, bench_now() - start);
+	}
+
+	{
+		rl78core_machine_s* const machine = rl78core_machine_default();
+		bench_reset(g_bench_firmware, sizeof(g_bench_firmware));
+		uint8_t sum = 0;
+		const double start = bench_now();
+
+		// note: the addresses sweep the ram, so every access goes through the page table.
+		for (uint64_t index = 0; index < bench_accesses_count; ++index)
+		{
+			sum = (uint8_t)(sum + rl78core_mem_read_u08_r(machine, 0xFEF00 + (uint20_t)(index & 0xFFF)));
+		}
+
+		bench_report_accesses("rl78core_mem_read_u08", bench_accesses_count, bench_now() - start);
+		rl78core_mem_write_u08_r(machine, 0xFEF00, sum);
+	}
+
+	{
+		rl78core_machine_s* const machine = rl78core_machine_default();
+		const double start = bench_now();
+
+		for (uint64_t index = 0; index < bench_accesses_count; ++index)
+		{
+			rl78core_mem_write_u08_r(machine, 0xFEF00 + (uint20_t)(index & 0xFFF), (uint8_t)index);
+		}
+
+		bench_report_accesses("rl78core_mem_write_u08", bench_accesses_count, bench_now() - start);
+	}
+
+	{
+		rl78core_machine_s* const machine = rl78core_machine_default();
+		uint16_t sum = 0;
+		const double start = bench_now();
+
+		for (uint64_t index = 0; index < bench_accesses_count; ++index)
+		{
+			sum = (uint16_t)(sum + rl78core_mem_read_u16_r(machine, 0xFEF00 + (uint20_t)(index & 0xFFE)));
+		}
+
+		bench_report_accesses("rl78core_mem_read_u16", bench_accesses_count, bench_now() - start);
+		rl78core_mem_write_u16_r(machine, 0xFEF00, sum);
+	}
+
+	{
+		uint64_t length = 0;
+		char_t* const text = bench_build_ihex(bench_loader_image_size, &length);
+		const double start = bench_now();
+
+		for (uint64_t index = 0; index < bench_loads_count; ++index)
+		{
+			rl78core_mem_image_s* const image = rl78core_mem_image_create();
+			(void)rl78core_loader_load_text("bench", text, length, image);
+			rl78core_mem_image_destroy(image);
+		}
+
+		bench_report_bytes("rl78core_loader_load_text", bench_loads_count * length, bench_now() - start);
+		(void)rl78misc_free(text);
+	}
+
+	return rl78core_cpu_halted() ? -1 : 0;
+}
+
+static void bench_reset(const uint8_t* const firmware, const uint20_t length)
+{
+	rl78core_mem_init();
+	rl78core_cpu_init();
+
+	for (uint20_t address = 0; address < length; ++address)
+	{
+		rl78core_mem_write_u08(address, firmware[address]);
+	}
+}
+
+static uint64_t bench_reset_mov(void)
+{
+	bench_reset(g_bench_mov_firmware, sizeof(g_bench_mov_firmware));
+
+	for (uint20_t address = sizeof(g_bench_mov_firmware); address < bench_mov_firmware_length; ++address)
+	{
+		rl78core_mem_write_u08(address, g_bench_mov_firmware[address % sizeof(g_bench_mov_firmware)]);
+	}
+
+	return bench_mov_firmware_length / 2;
+}
+
+static double bench_now(void)
+{
+	struct timespec now;
+	(void)clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+static void bench_report(const char_t* const name, const uint64_t count, const double seconds)
+{
+	rl78misc_logger_info("  %-28s %10lu instructions in %.3f s: %.2f mips",
+		name, count, seconds, ((double)count / seconds) / 1e6);
+}
+
+static void bench_report_accesses(const char_t* const name, const uint64_t count, const double seconds)
+{
+	rl78misc_logger_info("  %-28s %10lu accesses in %.3f s: %.2f ns/access",
+		name, count, seconds, (seconds * 1e9) / (double)count);
+}
+
+static char_t* bench_build_ihex(const uint20_t size, uint64_t* const length)
+{
+	// note: every record takes 76 characters, and the extended address and the end records are few.
+	char_t* const text = (char_t*)rl78misc_malloc(((size / 32) + (size >> 16) + 2) * 80);
+	uint64_t cursor = 0;
+
+	for (uint20_t address = 0; address < size; address += 32)
+	{
+		if (0 == (address & 0xFFFF))
+		{
+			const uint8_t segment = (uint8_t)(address >> 16);
+			cursor += (uint64_t)sprintf(&text[cursor], ":02000004%04X%02X\n", segment, (uint8_t)(0 - (6 + segment)));
+		}
+
+		uint8_t sum = (uint8_t)(32 + (address >> 8) + address);
+		cursor += (uint64_t)sprintf(&text[cursor], ":20%04X00", address & 0xFFFF);
+
+		for (uint8_t index = 0; index < 32; ++index)
+		{
+			const uint8_t byte = (uint8_t)((address + index) * 7);
+			sum = (uint8_t)(sum + byte);
+			cursor += (uint64_t)sprintf(&text[cursor], "%02X", byte);
+		}
+
+		cursor += (uint64_t)sprintf(&text[cursor], "%02X\n", (uint8_t)(0 - sum));
+	}
+
+	cursor += (uint64_t)sprintf(&text[cursor], ":00000001FF\n");
+	*length = cursor;
+	return text;
+}
+
+static void bench_report_bytes(const char_t* const name, const uint64_t count, const double seconds)
+{
+	rl78misc_logger_info("  %-28s %10lu bytes in %.3f s: %.2f mb/s",
+		name, count, seconds, ((double)count / seconds) / 1e6);
+}
@@ -10,11 +10,228 @@
  * @date 2024-03-07
  */
 
+#include "rl78misc/common.h"
+
+#include "rl78core/machine.h"
 #include "rl78core/mem.h"
 #include "rl78core/cpu.h"
+#include "rl78core/symbols.h"
+#include "rl78core/loader.h"
+#include "rl78core/cache.h"
+#include "rl78core/snapshot.h"
+#include "rl78core/sched.h"
+#include "rl78core/intc.h"
+#include "rl78core/tau.h"
 
 #include "./utester.h"
 
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Flash the provided program into the memory at address 0x00000.
+ * 
+ * @param program pointer to the program bytes
+ * @param length  length of the program
+ */
+static void flash_program(const uint8_t* const program, const uint20_t length);
+
+/**
+ * @brief Fake peripheral register, counting its accesses.
+ */
+typedef struct
+{
+	uint8_t value;
+	uint8_t reads;
+	uint8_t writes;
+} io_register_s;
+
+/**
+ * @brief Read handler of the fake peripheral register.
+ * 
+ * @param machine machine whose memory is read
+ * @param context pointer to the register
+ * @param address address to read at
+ * 
+ * @return uint8_t value of the register
+ */
+static uint8_t io_register_read(rl78core_machine_s* const machine, void* const context, const uint20_t address);
+
+/**
+ * @brief Write handler of the fake peripheral register.
+ * 
+ * @param machine machine whose memory is written
+ * @param context pointer to the register
+ * @param address address to write value at
+ * @param value   value to write
+ */
+static void io_register_write(rl78core_machine_s* const machine, void* const context, const uint20_t address, const uint8_t value);
+
+/**
+ * @brief Count of the writes reported by @ref count_code_write.
+ */
+static uint32_t g_code_writes = 0;
+
+/**
+ * @brief Code write hook, counting the reported writes.
+ * 
+ * @param machine machine whose memory was written to
+ * @param page    index of the written page
+ */
+static void count_code_write(rl78core_machine_s* const machine, const uint20_t page);
+
+/**
+ * @brief Fake periodic timer, counting its expirations.
+ */
+typedef struct
+{
+	uint8_t event;
+	uint64_t period;
+	uint32_t expirations;
+	uint32_t wake_expiration;  // note: expiration to wake the cpu up at, or 0 for none.
+	bool_t late;
+} periodic_timer_s;
+
+/**
+ * @brief Event handler of the fake periodic timer, scheduling its next
+ * expiration, and waking the cpu up at the selected one.
+ * 
+ * @param machine machine the event is dispatched on
+ * @param context pointer to the timer
+ * @param cycles  count of clock cycles the event was scheduled at
+ */
+static void periodic_timer_expire(rl78core_machine_s* const machine, void* const context, const uint64_t cycles);
+
+/**
+ * @brief Store a little-endian 16-bit value into a buffer.
+ * 
+ * @param buffer buffer to store into
+ * @param offset offset of the value
+ * @param value  value to store
+ */
+static void put_u16(uint8_t* const buffer, const uint64_t offset, const uint16_t value);
+
+/**
+ * @brief Store a little-endian 32-bit value into a buffer.
+ * 
+ * @param buffer buffer to store into
+ * @param offset offset of the value
+ * @param value  value to store
+ */
+static void put_u32(uint8_t* const buffer, const uint64_t offset, const uint32_t value);
+
+/**
+ * @brief Build a rl78 elf file with a program segment at 0x00000, an
+ * initialized data segment at 0x00100 for 0xFEF00, and a symbol table.
+ * 
+ * @param elf buffer of at least 0x200 bytes to build the file into
+ * 
+ * @return uint64_t length of the file
+ */
+static uint64_t build_elf(uint8_t* const elf);
+
+static void flash_program(const uint8_t* const program, const uint20_t length)
+{
+	for (uint20_t address = 0; address < length; ++address)
+	{
+		rl78core_mem_write_u08(address, program[address]);
+	}
+}
+
+static uint8_t io_register_read(rl78core_machine_s* const machine, void* const context, const uint20_t address)
+{
+	(void)machine;
+	(void)address;
+	io_register_s* const io_register = (io_register_s*)context;
+	++io_register->reads;
+	return io_register->value;
+}
+
+static void io_register_write(rl78core_machine_s* const machine, void* const context, const uint20_t address, const uint8_t value)
+{
+	(void)machine;
+	(void)address;
+	io_register_s* const io_register = (io_register_s*)context;
+	++io_register->writes;
+	io_register->value = (uint8_t)(value ^ 0xFF);
+}
+
+static void count_code_write(rl78core_machine_s* const machine, const uint20_t page)
+{
+	(void)machine;
+	(void)page;
+	++g_code_writes;
+}
+
+static void periodic_timer_expire(rl78core_machine_s* const machine, void* const context, const uint64_t cycles)
+{
+	periodic_timer_s* const timer = (periodic_timer_s*)context;
+	const uint64_t now = rl78core_cpu_cycles_r(machine);
+
+	// note: the event is dispatched at most one instruction late.
+	timer->late = timer->late || (now < cycles) || (now >= (cycles + 6));
+	++timer->expirations;
+	rl78core_sched_schedule_r(machine, timer->event, cycles + timer->period);
+
+	if (timer->expirations == timer->wake_expiration)
+	{
+		(void)rl78core_cpu_wake_r(machine);
+	}
+}
+
+static void put_u16(uint8_t* const buffer, const uint64_t offset, const uint16_t value)
+{
+	buffer[offset + 0] = (uint8_t)(value & 0xFF);
+	buffer[offset + 1] = (uint8_t)((value >> 8) & 0xFF);
+}
+
+static void put_u32(uint8_t* const buffer, const uint64_t offset, const uint32_t value)
+{
+	put_u16(buffer, offset + 0, (uint16_t)(value & 0xFFFF));
+	put_u16(buffer, offset + 2, (uint16_t)((value >> 16) & 0xFFFF));
+}
+
+static uint64_t build_elf(uint8_t* const elf)
+{
+	const uint8_t program[] =
+	{
+		0x8F, 0x00, 0xEF,  // 0x00000: MOV A, !0xEF00
+		0x9F, 0x02, 0xEF,  // 0x00003: MOV !0xEF02, A
+		0x61, 0xED,        // 0x00006: HALT
+	};
+
+	const char_t strings[] = "\0main\0g_data\0file.c\0undefined";
+	rl78misc_memset(elf, 0, 0x200);
+
+	// note: the file header, and the program headers at 0x034.
+	rl78misc_memcpy(elf, "\x7F" "ELF", 4);
+	elf[4] = 1; elf[5] = 1; elf[6] = 1;
+	put_u16(elf, 16, 2); put_u16(elf, 18, 197); put_u32(elf, 20, 1);
+	put_u32(elf, 28, 0x034); put_u32(elf, 32, 0x180);
+	put_u16(elf, 40, 52); put_u16(elf, 42, 32); put_u16(elf, 44, 2); put_u16(elf, 46, 40); put_u16(elf, 48, 3);
+
+	put_u32(elf, 0x034, 1); put_u32(elf, 0x038, 0x100); put_u32(elf, 0x03C, 0x00000); put_u32(elf, 0x040, 0x00000);
+	put_u32(elf, 0x044, sizeof(program)); put_u32(elf, 0x048, sizeof(program));
+	put_u32(elf, 0x054, 1); put_u32(elf, 0x058, 0x110); put_u32(elf, 0x05C, 0xFEF00); put_u32(elf, 0x060, 0x00100);
+	put_u32(elf, 0x064, 2); put_u32(elf, 0x068, 4);
+
+	rl78misc_memcpy(&elf[0x100], program, sizeof(program));
+	elf[0x110] = 0x2A; elf[0x111] = 0x55;
+
+	// note: the symbol table at 0x120, after the reserved symbol: a function, an object, a file and an undefined symbol.
+	put_u32(elf, 0x130, 1); put_u32(elf, 0x134, 0x00000); put_u32(elf, 0x138, sizeof(program)); elf[0x13C] = 0x12; put_u16(elf, 0x13E, 1);
+	put_u32(elf, 0x140, 6); put_u32(elf, 0x144, 0xFEF00); put_u32(elf, 0x148, 4); elf[0x14C] = 0x11; put_u16(elf, 0x14E, 2);
+	put_u32(elf, 0x150, 13); elf[0x15C] = 0x04; put_u16(elf, 0x15E, 0xFFF1);
+	put_u32(elf, 0x160, 20); put_u32(elf, 0x164, 0x00003); elf[0x16C] = 0x12;
+	rl78misc_memcpy(&elf[0x170], strings, sizeof(strings));
+
+	// note: the section headers at 0x180: the reserved one, the symbol table and its string table.
+	put_u32(elf, 0x1AC, 2); put_u32(elf, 0x1B8, 0x120); put_u32(elf, 0x1BC, 0x50); put_u32(elf, 0x1C0, 2); put_u32(elf, 0x1CC, 16);
+	put_u32(elf, 0x1D4, 3); put_u32(elf, 0x1E0, 0x170); put_u32(elf, 0x1E4, sizeof(strings));
+	return 0x1F8;
+}
+
 utester_define_test(rl78core_mem_read_u08_test)
 {
 	rl78core_mem_init();
@@ -75,6 +292,434 @@ utester_define_test(rl78core_mem_write_u16_test)
 	}
 }
 
+utester_define_test(rl78core_mem_map_io_test)
+{
+	const uint8_t program[] =
+	{
+		0x51, 0x5A,  // 0x00000: MOV A, #0x5A
+		0x9E, 0x10,  // 0x00002: MOV 0xFFF10, A
+		0x8E, 0x10,  // 0x00004: MOV A, 0xFFF10
+		0x9E, 0x11,  // 0x00006: MOV 0xFFF11, A
+		0x61, 0xED,  // 0x00008: HALT
+	};
+
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	io_register_s io_register = {0};
+	utester_assert_true(rl78core_mem_map_io_r(machine, 0xFFF10, 1, io_register_read, io_register_write, &io_register));
+
+	for (uint20_t address = 0; address < sizeof(program); ++address)
+	{
+		rl78core_mem_write_u08_r(machine, address, program[address]);
+	}
+
+	(void)rl78core_cpu_execute_r(machine, 5);
+	utester_assert_true(rl78core_cpu_halted_r(machine));
+	utester_assert_equal(io_register.writes, 1);
+	utester_assert_equal(io_register.reads, 1);
+	utester_assert_equal(io_register.value, 0xA5);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xFFF11), 0xA5);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xFFF10), 0xA5A5);
+	utester_assert_equal(io_register.reads, 2);
+
+	// note: a handler-less access goes to the memory, and the mapping survives the initialization.
+	utester_assert_true(rl78core_mem_map_io_r(machine, 0xFFF12, 1, NULL, io_register_write, &io_register));
+	rl78core_mem_init_r(machine);
+	rl78core_mem_write_u08_r(machine, 0xFFF12, 0x33);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xFFF12), 0x00);
+	utester_assert_equal(io_register.writes, 2);
+	rl78core_mem_write_u16_r(machine, 0xFFF10, 0x3CFF);
+	utester_assert_equal(io_register.value, 0x00);
+	utester_assert_equal(io_register.writes, 3);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xFFF11), 0x3C);
+	rl78core_machine_destroy(machine);
+}
+
+utester_define_test(rl78core_mem_footprint_test)
+{
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	const uint64_t footprint = rl78core_mem_footprint_r(machine);
+	utester_assert_true(footprint <= (2 * rl78core_mem_page_size));
+
+	// note: the reads come from the shared zero page, and only the writes commit the pages.
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x12345), 0x00);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0x123FF), 0x0000);
+	utester_assert_equal(rl78core_mem_footprint_r(machine), footprint);
+	rl78core_mem_write_u08_r(machine, 0x12345, 0x5A);
+	rl78core_mem_write_u08_r(machine, 0x12346, 0xA5);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0x12345), 0xA55A);
+	utester_assert_equal(rl78core_mem_footprint_r(machine), footprint + rl78core_mem_page_size);
+
+	uint8_t image[0x300] = {0};
+
+	for (uint20_t index = 0; index < sizeof(image); ++index)
+	{
+		image[index] = (uint8_t)index;
+	}
+
+	rl78core_mem_load_r(machine, 0x00080, image, sizeof(image));
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x0017F), 0xFF);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0x001FF), 0x807F);
+	utester_assert_equal(rl78core_mem_footprint_r(machine), footprint + (5 * rl78core_mem_page_size));
+
+	// note: the initialization zeroes the committed pages, but keeps them.
+	rl78core_machine_init(machine);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x12345), 0x00);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x0017F), 0x00);
+	utester_assert_equal(rl78core_mem_footprint_r(machine), footprint + (5 * rl78core_mem_page_size));
+	rl78core_machine_destroy(machine);
+}
+
+utester_define_test(rl78core_mem_dirty_test)
+{
+	const uint8_t data[] = { 0x11, 0x22, 0x33 };
+	rl78core_machine_s* const machine = rl78core_machine_create();
+
+	// note: the registers banks are referenced by the cpu, and are always dirty.
+	utester_assert_true(rl78core_mem_dirty_r(machine, 0xFFEE0));
+	utester_assert_false(rl78core_mem_dirty_r(machine, 0x12345));
+
+	rl78core_mem_write_u08_r(machine, 0x12345, 0x5A);
+	rl78core_mem_write_u16_r(machine, 0x20010, 0xBEEF);
+	rl78core_mem_load_r(machine, 0x300FF, data, sizeof(data));
+	utester_assert_true(rl78core_mem_dirty_r(machine, 0x12300));
+	utester_assert_true(rl78core_mem_dirty_r(machine, 0x20000));
+	utester_assert_true(rl78core_mem_dirty_r(machine, 0x30000));
+	utester_assert_true(rl78core_mem_dirty_r(machine, 0x30100));
+	utester_assert_false(rl78core_mem_dirty_r(machine, 0x30200));
+
+	rl78core_mem_reset_dirty_r(machine);
+	utester_assert_false(rl78core_mem_dirty_r(machine, 0x12345));
+	utester_assert_false(rl78core_mem_dirty_r(machine, 0x20010));
+	utester_assert_true(rl78core_mem_dirty_r(machine, 0xFFEE0));
+	rl78core_mem_write_u08_r(machine, 0x40000, 0xA5);
+	utester_assert_true(rl78core_mem_dirty_r(machine, 0x40000));
+
+	// note: the pages written before the reset of the dirty pages are restored too.
+	rl78core_mem_init_r(machine);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x12345), 0x00);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0x20010), 0x0000);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x30100), 0x00);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x40000), 0x00);
+	utester_assert_false(rl78core_mem_dirty_r(machine, 0x40000));
+	utester_assert_true(rl78core_mem_dirty_r(machine, 0xFFEE0));
+
+	// note: the clean pages are not restored, and their watched code stays valid.
+	rl78core_mem_set_code_write_hook_r(machine, count_code_write);
+	g_code_writes = 0;
+	rl78core_mem_watch_code_page_r(machine, 0x12345);
+	rl78core_mem_write_u08_r(machine, 0x20000, 0x01);
+	rl78core_mem_init_r(machine);
+	utester_assert_equal(g_code_writes, 0);
+	rl78core_mem_write_u08_r(machine, 0x12345, 0x01);
+	utester_assert_equal(g_code_writes, 1);
+	rl78core_mem_init_r(machine);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x12345), 0x00);
+
+	rl78core_machine_destroy(machine);
+}
+
+utester_define_test(rl78core_mem_image_test)
+{
+	const uint8_t program[] =
+	{
+		0x51, 0x07,        // 0x00000: MOV A, #7
+		0x9F, 0x00, 0x01,  // 0x00002: MOV !0x0100, A
+		0x61, 0xED,        // 0x00005: HALT
+	};
+
+	rl78core_mem_image_s* const image = rl78core_mem_image_create();
+	rl78core_mem_image_load(image, 0x00000, program, sizeof(program));
+	rl78core_mem_image_load(image, 0xF0100, program, 2);
+	utester_assert_equal(rl78core_mem_image_footprint(image), 2 * rl78core_mem_page_size);
+
+	rl78core_machine_s* const writer = rl78core_machine_create();
+	rl78core_machine_s* const reader = rl78core_machine_create();
+	rl78core_mem_map_image_r(writer, image);
+	rl78core_mem_map_image_r(reader, image);
+	const uint64_t footprint = rl78core_mem_footprint_r(reader);
+
+	// note: the writer self-programs the shared page, and gets its private copy of it.
+	(void)rl78core_cpu_execute_r(writer, 3);
+	utester_assert_true(rl78core_cpu_halted_r(writer));
+	utester_assert_equal(rl78core_mem_read_u08_r(writer, 0xF0100), 0x07);
+	utester_assert_equal(rl78core_mem_read_u08_r(writer, 0xF0101), 0x07);
+	utester_assert_equal(rl78core_mem_footprint_r(writer), footprint + rl78core_mem_page_size);
+
+	(void)rl78core_cpu_execute_r(reader, 1);
+	utester_assert_equal(rl78core_mem_read_u08_r(reader, 0xF0100), 0x51);
+	utester_assert_equal(rl78core_mem_read_u16_r(reader, 0x00001), 0x9F07);
+	utester_assert_equal(rl78core_mem_footprint_r(reader), footprint);
+
+	rl78core_machine_init(writer);
+	utester_assert_equal(rl78core_mem_read_u08_r(writer, 0xF0100), 0x51);
+	rl78core_mem_map_image_r(writer, NULL);
+	utester_assert_equal(rl78core_mem_read_u08_r(writer, 0x00000), 0x00);
+
+	rl78core_machine_destroy(writer);
+	rl78core_machine_destroy(reader);
+	rl78core_mem_image_destroy(image);
+}
+
+utester_define_test(rl78core_loader_ihex_test)
+{
+	const char_t* const text =
+		":110000005069512A9F351261EDABCDEF0123456789C7\r\n"
+		"\r\n"
+		":02000004000FEB\r\n"
+		":04e0fe001122334474  \r\n"
+		":020000021000EC\n"
+		":010005007783\n"
+		":00000001FF\n"
+		"ignored after the end record\n";
+
+	rl78core_mem_image_s* const image = rl78core_mem_image_create();
+	utester_assert_true(rl78core_loader_load_text("ihex", text, rl78misc_strlen(text), image));
+
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	rl78core_mem_map_image_r(machine, image);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0x00000), 0x6950);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x00007), 0x61);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x00010), 0x89);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x00011), 0x00);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xFE0FE), 0x2211);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xFE100), 0x4433);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x10005), 0x77);
+
+	// note: the loaded program runs from the image.
+	(void)rl78core_cpu_execute_r(machine, 4);
+	utester_assert_true(rl78core_cpu_halted_r(machine));
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF1235), 0x2A);
+
+	rl78core_machine_destroy(machine);
+	rl78core_mem_image_destroy(image);
+}
+
+utester_define_test(rl78core_loader_srec_test)
+{
+	const char_t* const text =
+		"S0070000726C3738AB\n"
+		"S1080010DEADBEEF01AE\n"
+		"S2070FE000A1B2C3F3\n"
+		"S307000FFEFF5AA5ED\n"
+		"S5030003F9\n"
+		"S9030000FC";
+
+	rl78core_mem_image_s* const image = rl78core_mem_image_create();
+	utester_assert_true(rl78core_loader_load_text("srec", text, rl78misc_strlen(text), image));
+
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	rl78core_mem_map_image_r(machine, image);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0x00010), 0xADDE);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0x00012), 0xEFBE);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x00014), 0x01);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xFE002), 0xC3);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xFFEFF), 0xA55A);
+	utester_assert_equal(rl78core_mem_image_footprint(image), 4 * rl78core_mem_page_size);
+
+	rl78core_machine_destroy(machine);
+	rl78core_mem_image_destroy(image);
+}
+
+utester_define_test(rl78core_loader_errors_test)
+{
+	#define load_text(_text) rl78core_loader_load_text("errors", (_text), rl78misc_strlen(_text), image)
+	rl78core_mem_image_s* const image = rl78core_mem_image_create();
+
+	utester_assert_false(load_text(""));
+	utester_assert_false(load_text("\n\n"));
+	utester_assert_false(load_text(":0100000001FF\n"));
+	utester_assert_false(load_text(":0100000001F\n"));
+	utester_assert_false(load_text(":0100000G01FE\n"));
+	utester_assert_false(load_text(":0200000001FE\n"));
+	utester_assert_false(load_text(":00000006FA\n"));
+	utester_assert_false(load_text(":020000040010EA\n:0100000001FE\n"));
+	utester_assert_false(load_text(":0100000001FE\nS9030000FC\n"));
+	utester_assert_false(load_text("S1080010DEADBEEF01AF\n"));
+	utester_assert_false(load_text("S4030000FC\n"));
+	utester_assert_false(load_text("S10200FD\n"));
+	utester_assert_false(load_text("# comment\n"));
+
+	// note: the records preceding the invalid one stay loaded.
+	utester_assert_equal(rl78core_mem_image_footprint(image), rl78core_mem_page_size);
+
+	rl78core_mem_image_destroy(image);
+	#undef load_text
+}
+
+utester_define_test(rl78core_symbols_test)
+{
+	rl78core_symbols_s* const symbols = rl78core_symbols_create();
+	utester_assert_true(NULL == rl78core_symbols_find(symbols, 0x00000));
+	utester_assert_true(NULL == rl78core_symbols_lookup(symbols, "main"));
+
+	rl78core_symbols_add(symbols, "timer_isr", 0x00200, 0x20);
+	rl78core_symbols_add(symbols, "main", 0x00100, 0x80);
+	rl78core_symbols_add(symbols, "main_loop", 0x00140, 0);
+	rl78core_symbols_add(symbols, "reset", 0x00100, 0);
+	rl78core_symbols_add(symbols, "g_ticks", 0xFEF00, 2);
+	rl78core_symbols_sort(symbols);
+
+	utester_assert_equal(rl78core_symbols_count(symbols), 5);
+	utester_assert_equal(rl78misc_strcmp(rl78core_symbols_at(symbols, 0)->name, "reset"), 0);
+	utester_assert_equal(rl78misc_strcmp(rl78core_symbols_at(symbols, 4)->name, "g_ticks"), 0);
+
+	utester_assert_true(NULL == rl78core_symbols_find(symbols, 0x000FF));
+	utester_assert_equal(rl78misc_strcmp(rl78core_symbols_find(symbols, 0x00100)->name, "main"), 0);
+	utester_assert_equal(rl78misc_strcmp(rl78core_symbols_find(symbols, 0x0013F)->name, "main"), 0);
+	utester_assert_equal(rl78misc_strcmp(rl78core_symbols_find(symbols, 0x00140)->name, "main_loop"), 0);
+	utester_assert_equal(rl78misc_strcmp(rl78core_symbols_find(symbols, 0x00141)->name, "main"), 0);
+	utester_assert_equal(rl78misc_strcmp(rl78core_symbols_find(symbols, 0x0017F)->name, "main"), 0);
+	utester_assert_true(NULL == rl78core_symbols_find(symbols, 0x00180));
+	utester_assert_equal(rl78misc_strcmp(rl78core_symbols_find(symbols, 0x0021F)->name, "timer_isr"), 0);
+	utester_assert_true(NULL == rl78core_symbols_find(symbols, 0x00220));
+	utester_assert_equal(rl78misc_strcmp(rl78core_symbols_find(symbols, 0xFEF01)->name, "g_ticks"), 0);
+
+	utester_assert_equal(rl78core_symbols_lookup(symbols, "timer_isr")->address, 0x00200);
+	utester_assert_equal(rl78core_symbols_lookup(symbols, "reset")->size, 0);
+	utester_assert_equal(rl78core_symbols_lookup(symbols, "g_ticks")->address, 0xFEF00);
+	utester_assert_true(NULL == rl78core_symbols_lookup(symbols, "mai"));
+
+	rl78core_symbols_destroy(symbols);
+}
+
+utester_define_test(rl78core_loader_elf_test)
+{
+	uint8_t elf[0x200];
+	const uint64_t length = build_elf(elf);
+
+	rl78core_mem_image_s* const image = rl78core_mem_image_create();
+	rl78core_symbols_s* const symbols = rl78core_symbols_create();
+	utester_assert_true(rl78core_loader_load_elf("elf", elf, length, image, symbols));
+
+	utester_assert_equal(rl78core_symbols_count(symbols), 2);
+	utester_assert_equal(rl78core_symbols_lookup(symbols, "main")->address, 0x00000);
+	utester_assert_equal(rl78core_symbols_lookup(symbols, "g_data")->size, 4);
+	utester_assert_true(NULL == rl78core_symbols_lookup(symbols, "file.c"));
+	utester_assert_true(NULL == rl78core_symbols_lookup(symbols, "undefined"));
+	utester_assert_equal(rl78misc_strcmp(rl78core_symbols_find(symbols, 0x00006)->name, "main"), 0);
+
+	// note: the initialized data is placed at its physical address, for the startup code to copy.
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	rl78core_mem_map_image_r(machine, image);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0x00100), 0x552A);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xFEF00), 0x00);
+	rl78core_mem_write_u08_r(machine, 0xFEF00, 0x3C);
+	(void)rl78core_cpu_execute_r(machine, 3);
+	utester_assert_true(rl78core_cpu_halted_r(machine));
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xFEF02), 0x3C);
+
+	uint8_t broken[0x200];
+	rl78misc_memcpy(broken, elf, sizeof(broken));
+	put_u16(broken, 18, 62);
+	utester_assert_false(rl78core_loader_load_elf("elf", broken, length, image, NULL));
+	utester_assert_false(rl78core_loader_load_elf("elf", elf, 40, image, NULL));
+	utester_assert_false(rl78core_loader_load_elf("elf", elf, 0x108, image, NULL));
+	rl78misc_memcpy(broken, elf, sizeof(broken));
+	put_u16(broken, 44, 0);
+	utester_assert_false(rl78core_loader_load_elf("elf", broken, length, image, NULL));
+	rl78misc_memcpy(broken, elf, sizeof(broken));
+	put_u32(broken, 0x1BC, 0x1000);
+	utester_assert_false(rl78core_loader_load_elf("elf", broken, length, image, symbols));
+
+	rl78core_machine_destroy(machine);
+	rl78core_symbols_destroy(symbols);
+	rl78core_mem_image_destroy(image);
+}
+
+utester_define_test(rl78core_cache_test)
+{
+	const char_t* const directory = "rl78core_cache_test.d";
+	const char_t* const path = "rl78core_cache_test.elf";
+	(void)mkdir(directory, 0755);
+
+	// note: clears the cached files of the previous runs.
+	DIR* const listing = opendir(directory);
+	utester_assert_true(listing != NULL);
+
+	for (struct dirent* entry = readdir(listing); entry != NULL; entry = readdir(listing))
+	{
+		char_t entry_path[512];
+		(void)snprintf(entry_path, sizeof(entry_path), "%s/%s", directory, entry->d_name);
+		(void)remove(entry_path);
+	}
+
+	(void)closedir(listing);
+
+	uint8_t elf[0x200];
+	const uint64_t length = build_elf(elf);
+	FILE* file = fopen(path, "wb");
+	utester_assert_true(file != NULL);
+	(void)fwrite(elf, length, 1, file);
+	(void)fclose(file);
+
+	rl78core_cache_s* const cache = rl78core_cache_create(directory);
+	rl78core_mem_image_s* const parsed = rl78core_mem_image_create();
+	rl78core_mem_image_s* const cached = rl78core_mem_image_create();
+	rl78core_mem_image_s* const unsymbolized = rl78core_mem_image_create();
+	rl78core_symbols_s* const symbols = rl78core_symbols_create();
+
+	utester_assert_true(rl78core_cache_load(cache, path, parsed, NULL));
+	utester_assert_equal(rl78core_cache_hits(cache), 0);
+	utester_assert_true(rl78core_cache_load(cache, path, cached, symbols));
+	utester_assert_equal(rl78core_cache_hits(cache), 1);
+
+	// note: the cached image matches the parsed one, and keeps the symbols.
+	utester_assert_equal(rl78core_mem_image_footprint(cached), rl78core_mem_image_footprint(parsed));
+
+	for (uint20_t page = 0; page < rl78core_mem_pages_count; ++page)
+	{
+		const uint8_t* const expected = rl78core_mem_image_page(parsed, page);
+		const uint8_t* const actual = rl78core_mem_image_page(cached, page);
+		utester_assert_equal(NULL == expected, NULL == actual);
+		utester_assert_true(NULL == expected || 0 == rl78misc_memcmp(expected, actual, rl78core_mem_page_size));
+	}
+
+	utester_assert_equal(rl78core_symbols_count(symbols), 2);
+	utester_assert_equal(rl78core_symbols_lookup(symbols, "g_data")->address, 0xFEF00);
+
+	// note: the attached pages are copied before they are loaded into.
+	const uint8_t* const attached = rl78core_mem_image_page(cached, 0);
+	rl78core_mem_image_load(cached, 0x00006, (const uint8_t*)"\x00\x00", 2);
+	utester_assert_true(rl78core_mem_image_page(cached, 0) != attached);
+	utester_assert_equal(attached[6], 0x61);
+	utester_assert_equal(rl78core_mem_image_page(cached, 0)[6], 0x00);
+	utester_assert_equal(rl78core_mem_image_page(cached, 0)[0], 0x8F);
+
+	// note: a changed binary misses the cache.
+	elf[0x100] = 0x8E;
+	file = fopen(path, "wb");
+	utester_assert_true(file != NULL);
+	(void)fwrite(elf, length, 1, file);
+	(void)fclose(file);
+	utester_assert_true(rl78core_cache_load(cache, path, unsymbolized, NULL));
+	utester_assert_equal(rl78core_cache_hits(cache), 1);
+	utester_assert_equal(rl78core_mem_image_page(unsymbolized, 0)[0], 0x8E);
+
+	rl78core_symbols_destroy(symbols);
+	rl78core_mem_image_destroy(unsymbolized);
+	rl78core_mem_image_destroy(cached);
+	rl78core_mem_image_destroy(parsed);
+	rl78core_cache_destroy(cache);
+	(void)remove(path);
+}
+
+utester_define_test(rl78core_loader_file_test)
+{
+	const char_t* const path = "rl78core_loader_test.hex";
+	FILE* const file = fopen(path, "wb");
+	utester_assert_true(file != NULL);
+	(void)fputs(":0100000001FE\n:00000001FF\n", file);
+	(void)fclose(file);
+
+	rl78core_mem_image_s* const image = rl78core_mem_image_create();
+	utester_assert_true(rl78core_loader_load(path, image, NULL));
+	utester_assert_equal(rl78core_mem_image_footprint(image), rl78core_mem_page_size);
+	utester_assert_false(rl78core_loader_load("rl78core_loader_missing.hex", image, NULL));
+
+	rl78core_mem_image_destroy(image);
+	(void)remove(path);
+}
+
 utester_define_test(rl78core_cpu_read_pc_test)
 {
 	rl78core_cpu_init();
@@ -208,16 +853,1124 @@ utester_define_test(rl78core_cpu_write_gpr16_test)
 	utester_assert_equal(hl_value, 0x0A0A);
 }
 
+utester_define_test(rl78core_cpu_tick_test)
+{
+	rl78core_mem_init();
+	rl78core_cpu_init();
+
+	const uint8_t program[] =
+	{
+		0x50, 0x69,  // MOV X, #0x69
+		0x60,        // MOV A, X
+		0x61, 0xDF,  // SEL RB1
+		0x57, 0x42,  // MOV H, #0x42
+		0xFF,        // illegal
+	};
+	flash_program(program, sizeof(program));
+
+	rl78core_cpu_tick();
+	utester_assert_equal(rl78core_cpu_read_pc(), 2);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_x), 0x69);
+	rl78core_cpu_tick();
+	utester_assert_equal(rl78core_cpu_read_pc(), 3);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 0x69);
+	rl78core_cpu_tick();
+	utester_assert_equal(rl78core_cpu_read_pc(), 5);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 0);
+	rl78core_cpu_tick();
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_h), 0x42);
+	utester_assert_equal(rl78core_mem_read_u08(0xFFEF7), 0x42);
+	utester_assert_false(rl78core_cpu_halted());
+	rl78core_cpu_tick();
+	utester_assert_true(rl78core_cpu_halted());
+
+	// note: the bit test and shift instructions of the 0x31 map are not decoded,
+	// and stop the cpu.
+	rl78core_cpu_init();
+	rl78core_mem_write_u08(0x00000, 0x31);
+	rl78core_mem_write_u08(0x00001, 0x00);
+	rl78core_cpu_tick();
+	utester_assert_true(rl78core_cpu_halted());
+	utester_assert_equal(rl78core_cpu_read_pc(), 2);
+}
+
+utester_define_test(rl78core_cpu_es_prefix_test)
+{
+	rl78core_mem_init();
+	rl78core_cpu_init();
+
+	const uint8_t program[] =
+	{
+		0x11, 0xCF, 0x00, 0x20, 0x5A,  // MOV ES:!0x2000, #0x5A
+		0x11, 0x8F, 0x00, 0x20,        // MOV A, ES:!0x2000
+		0x11, 0x9F, 0x01, 0x20,        // MOV ES:!0x2001, A
+		0x11, 0x00,                    // illegal
+	};
+	flash_program(program, sizeof(program));
+
+	// note: the ES register is reset to the last segment, which the !addr16
+	// operands address without its prefix.
+	utester_assert_equal(rl78core_mem_read_u08(0xFFFFD), 0x0F);
+	rl78core_mem_write_u08(0xFFFFD, 0x01);
+
+	utester_assert_equal(rl78core_cpu_tick(), 3);
+	utester_assert_equal(rl78core_cpu_read_pc(), 5);
+	utester_assert_equal(rl78core_mem_read_u08(0x12000), 0x5A);
+	utester_assert_equal(rl78core_mem_read_u08(0xF2000), 0x00);
+	(void)rl78core_cpu_tick();
+	utester_assert_equal(rl78core_cpu_read_pc(), 9);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 0x5A);
+	utester_assert_equal(rl78core_cpu_tick(), 2);
+	utester_assert_equal(rl78core_mem_read_u08(0x12001), 0x5A);
+	utester_assert_false(rl78core_cpu_halted());
+	rl78core_cpu_tick();
+	utester_assert_true(rl78core_cpu_halted());
+	utester_assert_equal(rl78core_cpu_read_pc(), sizeof(program));
+}
+
+utester_define_test(rl78core_cpu_cycles_test)
+{
+	rl78core_mem_init();
+	rl78core_cpu_init();
+
+	const uint8_t program[] =
+	{
+		0x8F, 0x80, 0x01,        // MOV A, !0x0180
+		0x8F, 0x00, 0x10,        // MOV A, !0x1000
+		0x8F, 0x00, 0x20,        // MOV A, !0x2000
+		0x11, 0x8F, 0x00, 0x10,  // MOV A, ES:!0x1000
+		0x8F, 0x00, 0xFF,        // MOV A, !0xFF00
+		0x4C, 0x00,              // CMP A, #0
+		0xDF, 0x00,              // BNZ $+0
+		0xDD, 0x00,              // BZ $+0
+		0x61, 0xED,              // HALT
+	};
+	flash_program(program, sizeof(program));
+	rl78core_mem_write_u08(0xFFFFD, 0x00);
+
+	// note: the reads address the extended sfr area, the data flash, the code
+	// flash mirror, the code flash and the ram, and only the reads of the code
+	// flash and of its mirror take the wait cycles.
+	utester_assert_equal(rl78core_cpu_cycles(), 0);
+	utester_assert_equal(rl78core_cpu_tick(), 1);
+	utester_assert_equal(rl78core_cpu_tick(), 1);
+	utester_assert_equal(rl78core_cpu_tick(), 5);
+	utester_assert_equal(rl78core_cpu_tick(), 6);
+	utester_assert_equal(rl78core_cpu_tick(), 1);
+	utester_assert_equal(rl78core_cpu_tick(), 1);
+	utester_assert_equal(rl78core_cpu_tick(), 2);
+	utester_assert_equal(rl78core_cpu_tick(), 4);
+	utester_assert_equal(rl78core_cpu_tick(), 3);
+	utester_assert_true(rl78core_cpu_halted());
+	utester_assert_equal(rl78core_cpu_tick(), 0);
+	utester_assert_equal(rl78core_cpu_cycles(), 1 + 1 + 5 + 6 + 1 + 1 + 2 + 4 + 3);
+}
+
+utester_define_test(rl78core_cpu_run_test)
+{
+	rl78core_mem_init();
+	rl78core_cpu_init();
+
+	const uint8_t program[] =
+	{
+		0x52, 0x10,  // 0x00000: MOV C, #0x10
+		0x00,        // 0x00002: NOP
+		0x92,        // 0x00003: DEC C
+		0xDF, 0xFC,  // 0x00004: BNZ $0x00002
+		0x61, 0xED,  // 0x00006: HALT
+	};
+	flash_program(program, sizeof(program));
+
+	utester_assert_equal(rl78core_cpu_run((rl78core_cpu_budget_s) { .instructions = 3 }), rl78core_cpu_stop_budget);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0x00004);
+	utester_assert_equal(rl78core_cpu_cycles(), 3);
+
+	// note: the cycles budget is exceeded by the taken branch.
+	utester_assert_equal(rl78core_cpu_run((rl78core_cpu_budget_s) { .cycles = 2 }), rl78core_cpu_stop_budget);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0x00002);
+	utester_assert_equal(rl78core_cpu_cycles(), 7);
+
+	utester_assert_true(rl78core_cpu_add_breakpoint(0x00004));
+	utester_assert_equal(rl78core_cpu_run((rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_breakpoint);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0x00004);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_c), 0x0E);
+	utester_assert_equal(rl78core_cpu_run((rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_breakpoint);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_c), 0x0D);
+	utester_assert_true(rl78core_cpu_remove_breakpoint(0x00004));
+	utester_assert_false(rl78core_cpu_remove_breakpoint(0x00004));
+
+	rl78core_cpu_set_deadline(50);
+	utester_assert_equal(rl78core_cpu_run((rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_event);
+	utester_assert_true(rl78core_cpu_cycles() >= 50);
+	utester_assert_true(rl78core_cpu_cycles() < (50 + 4));
+
+	rl78core_cpu_set_deadline(rl78core_cpu_no_deadline);
+	utester_assert_equal(rl78core_cpu_run((rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0x00008);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_c), 0);
+}
+
+utester_define_test(rl78core_cpu_execute_test)
+{
+	rl78core_mem_init();
+	rl78core_cpu_init();
+
+	const uint8_t program[] =
+	{
+		0x52, 0x05,  // MOV C, #5
+		0x51, 0x00,  // MOV A, #0
+		0x0C, 0x03,  // ADD A, #3
+		0x92,        // DEC C
+		0xDF, 0xFB,  // BNZ $-5
+		0x9D, 0x20,  // MOV saddr, A
+		0x61, 0xED,  // HALT
+	};
+	flash_program(program, sizeof(program));
+
+	rl78core_cpu_execute(2);
+	utester_assert_equal(rl78core_cpu_read_pc(), 4);
+	rl78core_cpu_execute(100);
+	utester_assert_true(rl78core_cpu_halted());
+	utester_assert_equal(rl78core_cpu_read_pc(), sizeof(program));
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 15);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_c), 0);
+	utester_assert_equal(rl78core_mem_read_u08(0xFFE40), 15);
+}
+
+utester_define_test(rl78core_cpu_gpr_bank_test)
+{
+	rl78core_mem_init();
+	rl78core_cpu_init();
+
+	const uint8_t program[] =
+	{
+		0xCE, 0xFA, 0x20,  // MOV PSW, #0x20 (RBS1)
+		0x51, 0x11,        // MOV A, #0x11
+		0x61, 0xCF,        // SEL RB0
+	};
+	flash_program(program, sizeof(program));
+
+	rl78core_mem_write_u08(0xFFEF8, 0x5A);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_x), 0x5A);
+	rl78core_cpu_write_gpr16(rl78core_gpr16_hl, 0x1234);
+	utester_assert_equal(rl78core_mem_read_u16(0xFFEFE), 0x1234);
+
+	rl78core_cpu_tick();
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_x), 0);
+	rl78core_cpu_tick();
+	utester_assert_equal(rl78core_mem_read_u08(0xFFEE9), 0x11);
+	rl78core_cpu_tick();
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_x), 0x5A);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 0);
+}
+
+utester_define_test(rl78core_cpu_flags_test)
+{
+	rl78core_mem_init();
+	rl78core_cpu_init();
+
+	const uint8_t program[] =
+	{
+		0xCB, 0xF8, 0x00, 0xFE,  // 0x00000: MOVW SP, #0xFE00
+		0x51, 0xFF,              // 0x00004: MOV A, #0xFF
+		0x0C, 0x01,              // 0x00006: ADD A, #1
+		0x80,                    // 0x00008: INC X
+		0x61, 0xDD,              // 0x00009: PUSH PSW
+		0x4C, 0x00,              // 0x0000B: CMP A, #0
+		0xDD, 0x02,              // 0x0000D: BZ $0x00011
+		0x61, 0xED,              // 0x0000F: HALT
+		0x5C, 0x00,              // 0x00011: AND A, #0
+		0x8E, 0xFA,              // 0x00013: MOV A, PSW
+		0x61, 0xED,              // 0x00015: HALT
+	};
+
+	flash_program(program, sizeof(program));
+
+	// note: the carry of the addition must survive the increment, which does
+	// not update the CY flag.
+	utester_assert_equal(rl78core_cpu_execute(4), 4);
+	utester_assert_equal(rl78core_mem_read_u08(0xFFFFA), 0x07);
+	utester_assert_equal(rl78core_cpu_execute(1), 1);
+	utester_assert_equal(rl78core_mem_read_u08(0xFFDFF), 0x07);
+
+	utester_assert_equal(rl78core_cpu_execute(2), 2);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0x00011);
+	utester_assert_equal(rl78core_mem_read_u08(0xFFFFA), 0x46);
+
+	utester_assert_equal(rl78core_cpu_execute(3), 3);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 0x46);
+	utester_assert_true(rl78core_cpu_halted());
+}
+
+utester_define_test(rl78core_cpu_decode_cache_test)
+{
+	rl78core_mem_init();
+	rl78core_cpu_init();
+
+	const uint8_t program[] =
+	{
+		0x51, 0x01,              // 0xFE000: MOV A, #1
+		0xCF, 0x01, 0xE0, 0x07,  // 0xFE002: MOV !0xE001, #7
+		0xEF, 0xF8,              // 0xFE006: BR $0xFE000
+	};
+
+	for (uint20_t index = 0; index < sizeof(program); ++index)
+	{
+		rl78core_mem_write_u08(0xFE000 + index, program[index]);
+	}
+
+	rl78core_cpu_write_pc(0xFE000);
+	rl78core_cpu_execute(1);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 1);
+	rl78core_cpu_execute(3);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0xFE002);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 7);
+
+	rl78core_mem_write_u08(0xFE001, 0x09);
+	rl78core_cpu_write_pc(0xFE000);
+	rl78core_cpu_execute(1);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 9);
+
+	rl78core_cpu_set_engine(rl78core_cpu_engine_block);
+	rl78core_cpu_write_pc(0xFE000);
+	rl78core_cpu_execute(4);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0xFE002);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 7);
+	rl78core_mem_write_u08(0xFE005, 0x0B);
+	rl78core_cpu_execute(3);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 0x0B);
+}
+
+utester_define_test(rl78core_cpu_jit_test)
+{
+	rl78core_mem_init();
+	rl78core_cpu_init();
+	rl78core_cpu_set_engine(rl78core_cpu_engine_jit);
+
+	const uint8_t program[] =
+	{
+		0x51, 0x01,              // 0xFE000: MOV A, #1
+		0x70,                    // 0xFE002: MOV X, A
+		0x30, 0x34, 0x12,        // 0xFE003: MOVW AX, #0x1234
+		0x63,                    // 0xFE006: MOV A, B
+		0xEF, 0xF7,              // 0xFE007: BR $0xFE000
+		0x51, 0x01,              // 0xFE009: MOV A, #1
+		0xCF, 0x0A, 0xE0, 0x07,  // 0xFE00B: MOV !0xE00A, #7
+		0xEF, 0xF8,              // 0xFE00F: BR $0xFE009
+	};
+
+	const uint8_t pushing[] =
+	{
+		0xC1,                    // 0xFE2FD: PUSH AX
+		0xEF, 0xFD,              // 0xFE2FE: BR $0xFE2FD
+	};
+
+	const uint8_t computing[] =
+	{
+		0x0C, 0x35,              // 0xFE020: ADD A, #0x35
+		0x80,                    // 0xFE022: INC X
+		0x7C, 0x0F,              // 0xFE023: XOR A, #0x0F
+		0x92,                    // 0xFE025: DEC C
+		0x6C, 0x01,              // 0xFE026: OR A, #1
+		0x4C, 0x80,              // 0xFE028: CMP A, #0x80
+		0x5C, 0xFD,              // 0xFE02A: AND A, #0xFD
+		0x2C, 0x11,              // 0xFE02C: SUB A, #0x11
+		0x80,                    // 0xFE02E: INC X
+		0xEF, 0xEF,              // 0xFE02F: BR $0xFE020
+	};
+
+	for (uint20_t index = 0; index < sizeof(program); ++index)
+	{
+		rl78core_mem_write_u08(0xFE000 + index, program[index]);
+	}
+
+	for (uint20_t index = 0; index < sizeof(pushing); ++index)
+	{
+		rl78core_mem_write_u08(0xFE2FD + index, pushing[index]);
+	}
+
+	for (uint20_t index = 0; index < sizeof(computing); ++index)
+	{
+		rl78core_mem_write_u08(0xFE020 + index, computing[index]);
+	}
+
+	// note: the natively compiled alu operations must leave the same registers
+	// and flags as the interpreted ones, wherever the run stops in the loop.
+	for (uint8_t stop = 0; stop < 10; ++stop)
+	{
+		uint16_t states[2][3] = {0};
+
+		for (uint8_t engine = 0; engine < 2; ++engine)
+		{
+			rl78core_cpu_set_engine((0 == engine) ? rl78core_cpu_engine_interp : rl78core_cpu_engine_jit);
+			rl78core_mem_write_u08(0xFFFFA, 0x06);
+			rl78core_cpu_write_gpr16(rl78core_gpr16_ax, 0x00F0);
+			rl78core_cpu_write_gpr16(rl78core_gpr16_bc, 0x0003);
+			rl78core_cpu_write_pc(0xFE020);
+			utester_assert_equal(rl78core_cpu_execute((10 * 40) + stop), (uint64_t)((10 * 40) + stop));
+			states[engine][0] = rl78core_cpu_read_gpr16(rl78core_gpr16_ax);
+			states[engine][1] = rl78core_cpu_read_gpr16(rl78core_gpr16_bc);
+			states[engine][2] = rl78core_mem_read_u08(0xFFFFA);
+		}
+
+		utester_assert_equal(states[1][0], states[0][0]);
+		utester_assert_equal(states[1][1], states[0][1]);
+		utester_assert_equal(states[1][2], states[0][2]);
+	}
+
+	rl78core_cpu_set_engine(rl78core_cpu_engine_jit);
+
+	// note: the hot loop gets compiled, and the compiled code must be discarded
+	// once the loop gets modified.
+	rl78core_cpu_write_gpr08(rl78core_gpr08_b, 0x5A);
+	rl78core_cpu_write_pc(0xFE000);
+	utester_assert_equal(rl78core_cpu_execute(5 * 100), 5 * 100);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0xFE000);
+	utester_assert_equal(rl78core_cpu_read_gpr16(rl78core_gpr16_ax), 0x5A34);
+
+	rl78core_mem_write_u08(0xFE001, 0x05);
+	utester_assert_equal(rl78core_cpu_execute(2), 2);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0xFE003);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_x), 0x05);
+
+	// note: the self-modifying loop must leave its block as soon as it writes
+	// the code, and keep running correctly.
+	rl78core_cpu_write_pc(0xFE009);
+	utester_assert_equal(rl78core_cpu_execute(3 * 100 + 1), 3 * 100 + 1);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0xFE00B);
+	utester_assert_equal(rl78core_cpu_read_gpr08(rl78core_gpr08_a), 7);
+
+	// note: the stack grows down onto the compiled loop, and the push of the
+	// 129th iteration rewrites its branch into BR $0xFE2FE. The rewritten branch
+	// follows the writer in the same block, and must not run from its stale copy.
+	rl78core_mem_write_u16(0xFFFF8, 0xE400);
+	rl78core_cpu_write_gpr16(rl78core_gpr16_ax, 0xFEEF);
+	rl78core_cpu_write_pc(0xFE2FD);
+	utester_assert_equal(rl78core_cpu_execute((2 * 129) + 10), (2 * 129) + 10);
+	utester_assert_equal(rl78core_mem_read_u16(0xFFFF8), 0xE2FE);
+	utester_assert_equal(rl78core_cpu_read_pc(), 0xFE2FE);
+}
+
+utester_define_test(rl78core_machine_test)
+{
+	const uint8_t program[] =
+	{
+		0x52, 0x40,  // 0x00000: MOV C, #0x40
+		0x0C, 0x03,  // 0x00002: ADD A, #3
+		0x92,        // 0x00004: DEC C
+		0xDF, 0xFB,  // 0x00005: BNZ $0x00002
+		0x61, 0xED,  // 0x00007: HALT
+	};
+
+	rl78core_machine_s* machines[rl78core_cpu_engines_count] = {0};
+
+	for (uint8_t engine = 0; engine < rl78core_cpu_engines_count; ++engine)
+	{
+		machines[engine] = rl78core_machine_create();
+		rl78core_cpu_set_engine_r(machines[engine], (rl78core_cpu_engine_e)engine);
+		rl78core_cpu_write_gpr08_r(machines[engine], rl78core_gpr08_a, engine);
+
+		for (uint20_t address = 0; address < sizeof(program); ++address)
+		{
+			rl78core_mem_write_u08_r(machines[engine], address, program[address]);
+		}
+	}
+
+	// note: the machines are run interleaved, and must not affect each other.
+	for (uint8_t slice = 0; slice < 0x10; ++slice)
+	{
+		for (uint8_t engine = 0; engine < rl78core_cpu_engines_count; ++engine)
+		{
+			(void)rl78core_cpu_execute_r(machines[engine], 0x10);
+		}
+	}
+
+	for (uint8_t engine = 0; engine < rl78core_cpu_engines_count; ++engine)
+	{
+		utester_assert_true(rl78core_cpu_halted_r(machines[engine]));
+		utester_assert_equal(rl78core_cpu_read_pc_r(machines[engine]), 0x00009);
+		utester_assert_equal(rl78core_cpu_read_gpr08_r(machines[engine], rl78core_gpr08_a), (uint8_t)(engine + (0x40 * 3)));
+		utester_assert_equal(rl78core_mem_read_u08_r(machines[engine], 0xFFEF9), (uint8_t)(engine + (0x40 * 3)));
+		rl78core_machine_destroy(machines[engine]);
+	}
+}
+
+utester_define_test(rl78core_snapshot_test)
+{
+	const uint8_t program[] =
+	{
+		0x52, 0x40,  // 0x00000: MOV C, #0x40
+		0x0C, 0x03,  // 0x00002: ADD A, #3
+		0x92,        // 0x00004: DEC C
+		0xDF, 0xFB,  // 0x00005: BNZ $0x00002
+		0x61, 0xED,  // 0x00007: HALT
+	};
+
+	rl78core_machine_s* const machine = rl78core_machine_create();
+
+	for (uint20_t address = 0; address < sizeof(program); ++address)
+	{
+		rl78core_mem_write_u08_r(machine, address, program[address]);
+	}
+
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .instructions = 1 + (3 * 0x10) }), rl78core_cpu_stop_budget);
+	rl78core_snapshot_s* const snapshot = rl78core_snapshot_capture_r(machine);
+	const uint64_t cycles = rl78core_cpu_cycles_r(machine);
+	utester_assert_equal(rl78core_snapshot_cpu(snapshot)->pc, 0x00002);
+	utester_assert_equal(rl78core_snapshot_cpu(snapshot)->cycles, cycles);
+
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	utester_assert_equal(rl78core_cpu_read_gpr08_r(machine, rl78core_gpr08_a), 0xC0);
+
+	// note: the forked machine continues from the snapshot, and must not
+	// affect the machine it was captured from.
+	rl78core_machine_s* const fork = rl78core_snapshot_fork(snapshot);
+	utester_assert_false(rl78core_cpu_halted_r(fork));
+	utester_assert_equal(rl78core_cpu_read_pc_r(fork), 0x00002);
+	utester_assert_equal(rl78core_cpu_cycles_r(fork), cycles);
+	utester_assert_equal(rl78core_cpu_read_gpr08_r(fork, rl78core_gpr08_a), 0x30);
+	utester_assert_equal(rl78core_cpu_read_gpr08_r(fork, rl78core_gpr08_c), 0x30);
+	rl78core_cpu_write_gpr08_r(fork, rl78core_gpr08_a, 0);
+	rl78core_mem_write_u08_r(fork, 0x00003, 0x01);
+	utester_assert_equal(rl78core_cpu_run_r(fork, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	utester_assert_equal(rl78core_cpu_read_gpr08_r(fork, rl78core_gpr08_a), 0x30);
+	utester_assert_equal(rl78core_cpu_read_gpr08_r(machine, rl78core_gpr08_a), 0xC0);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0x00003), 0x03);
+	rl78core_machine_destroy(fork);
+
+	// note: the restored machine keeps its breakpoints.
+	utester_assert_true(rl78core_cpu_add_breakpoint_r(machine, 0x00004));
+	rl78core_snapshot_restore_r(machine, snapshot);
+	utester_assert_false(rl78core_cpu_halted_r(machine));
+	utester_assert_equal(rl78core_cpu_cycles_r(machine), cycles);
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_breakpoint);
+	utester_assert_equal(rl78core_cpu_read_gpr08_r(machine, rl78core_gpr08_a), 0x33);
+	utester_assert_true(rl78core_cpu_remove_breakpoint_r(machine, 0x00004));
+
+	rl78core_machine_destroy(machine);
+	rl78core_snapshot_destroy(snapshot);
+}
+
+utester_define_test(rl78core_snapshot_file_test)
+{
+	const char_t* const path = "rl78core_snapshot_file_test.snp";
+	const uint8_t program[] =
+	{
+		0x52, 0x08,  // 0x00000: MOV C, #0x08
+		0x0C, 0x05,  // 0x00002: ADD A, #5
+		0x92,        // 0x00004: DEC C
+		0xDF, 0xFB,  // 0x00005: BNZ $0x00002
+		0x61, 0xED,  // 0x00007: HALT
+	};
+
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	rl78core_cpu_set_engine_r(machine, rl78core_cpu_engine_block);
+
+	for (uint20_t address = 0; address < sizeof(program); ++address)
+	{
+		rl78core_mem_write_u08_r(machine, address, program[address]);
+	}
+
+	rl78core_mem_write_u08_r(machine, 0xFE000, 0xA5);
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .instructions = 1 + (3 * 4) }), rl78core_cpu_stop_budget);
+	rl78core_snapshot_s* const snapshot = rl78core_snapshot_capture_r(machine);
+	utester_assert_true(rl78core_snapshot_save(snapshot, path));
+	rl78core_snapshot_destroy(snapshot);
+
+	rl78core_snapshot_s* const loaded = rl78core_snapshot_load(path);
+	utester_assert_true(loaded != NULL);
+	rl78core_machine_s* const fork = rl78core_snapshot_fork(loaded);
+	utester_assert_equal(rl78core_cpu_get_engine_r(fork), rl78core_cpu_engine_block);
+	utester_assert_equal(rl78core_cpu_read_pc_r(fork), rl78core_cpu_read_pc_r(machine));
+	utester_assert_equal(rl78core_cpu_cycles_r(fork), rl78core_cpu_cycles_r(machine));
+	utester_assert_equal(rl78core_mem_read_u08_r(fork, 0xFE000), 0xA5);
+	utester_assert_equal(rl78core_cpu_run_r(fork, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	utester_assert_equal(rl78core_cpu_read_gpr08_r(fork, rl78core_gpr08_a), 0x28);
+	utester_assert_equal(rl78core_cpu_cycles_r(fork), rl78core_cpu_cycles_r(machine));
+	rl78core_machine_destroy(fork);
+	rl78core_machine_destroy(machine);
+	rl78core_snapshot_destroy(loaded);
+
+	// note: the files of other formats must be rejected.
+	FILE* const file = fopen(path, "wb");
+	utester_assert_true(file != NULL);
+	utester_assert_equal(fwrite(program, sizeof(program), 1, file), 1);
+	utester_assert_equal(fclose(file), 0);
+	utester_assert_true(NULL == rl78core_snapshot_load(path));
+	utester_assert_equal(remove(path), 0);
+}
+
+utester_define_test(rl78core_snapshot_tau_test)
+{
+	const char_t* const path = "rl78core_snapshot_tau_test.snp";
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	rl78core_mem_write_u08_r(machine, 0x00000, 0xEF);
+	rl78core_mem_write_u08_r(machine, 0x00001, 0xFE);
+	rl78core_mem_write_u16_r(machine, 0xF01B6, 0x0002);
+	rl78core_mem_write_u16_r(machine, 0xFFF1A, 99);
+	rl78core_mem_write_u08_r(machine, 0xF01B2, 0x02);
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 40 }), rl78core_cpu_stop_budget);
+
+	rl78core_snapshot_s* const snapshot = rl78core_snapshot_capture_r(machine);
+	utester_assert_true(rl78core_snapshot_save(snapshot, path));
+	rl78core_snapshot_s* const loaded = rl78core_snapshot_load(path);
+	utester_assert_true(loaded != NULL);
+	utester_assert_equal(remove(path), 0);
+
+	// note: the forks keep the interval timer counting, and raise its interrupt
+	// at the same cycle as the machine they were captured from.
+	rl78core_machine_s* const forks[] = { rl78core_snapshot_fork(snapshot), rl78core_snapshot_fork(loaded), };
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 400 }), rl78core_cpu_stop_budget);
+
+	for (uint8_t index = 0; index < (sizeof(forks) / sizeof(forks[0])); ++index)
+	{
+		rl78core_machine_s* const fork = forks[index];
+		utester_assert_equal(rl78core_mem_read_u08_r(fork, 0xF01B0), 0x02);
+		utester_assert_equal(rl78core_mem_read_u16_r(fork, 0xF01B6), 0x0002);
+		utester_assert_equal(rl78core_sched_next_r(fork), 400);
+		utester_assert_equal(rl78core_cpu_run_r(fork, (rl78core_cpu_budget_s) { .cycles = 400 }), rl78core_cpu_stop_budget);
+		utester_assert_equal(rl78core_cpu_cycles_r(fork), rl78core_cpu_cycles_r(machine));
+		utester_assert_true(rl78core_intc_requested_r(fork, 21));
+		utester_assert_equal(rl78core_mem_read_u16_r(fork, 0xF0182), rl78core_mem_read_u16_r(machine, 0xF0182));
+		utester_assert_equal(rl78core_sched_next_r(fork), rl78core_sched_next_r(machine));
+		rl78core_machine_destroy(fork);
+	}
+
+	// note: the restored machine stops the channels started after the capture.
+	rl78core_mem_write_u08_r(machine, 0xF01B2, 0x01);
+	rl78core_snapshot_restore_r(machine, snapshot);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF01B0), 0x02);
+	utester_assert_equal(rl78core_sched_next_r(machine), 400);
+
+	rl78core_machine_destroy(machine);
+	rl78core_snapshot_destroy(loaded);
+	rl78core_snapshot_destroy(snapshot);
+}
+
+utester_define_test(rl78core_sched_test)
+{
+	const uint8_t program[] =
+	{
+		0xEF, 0xFE,  // 0x00000: BR $0x00000
+	};
+
+	for (uint8_t engine = 0; engine < rl78core_cpu_engines_count; ++engine)
+	{
+		rl78core_machine_s* const machine = rl78core_machine_create();
+		rl78core_cpu_set_engine_r(machine, (rl78core_cpu_engine_e)engine);
+
+		for (uint20_t address = 0; address < sizeof(program); ++address)
+		{
+			rl78core_mem_write_u08_r(machine, address, program[address]);
+		}
+
+		periodic_timer_s fast = { .period = 100 };
+		periodic_timer_s slow = { .period = 250 };
+		fast.event = rl78core_sched_add_event_r(machine, periodic_timer_expire, &fast);
+		slow.event = rl78core_sched_add_event_r(machine, periodic_timer_expire, &slow);
+		utester_assert_true(fast.event != rl78core_sched_no_event);
+		utester_assert_equal(slow.event, fast.event + 1);
+		utester_assert_equal(rl78core_sched_next_r(machine), rl78core_cpu_no_deadline);
+
+		rl78core_sched_schedule_r(machine, slow.event, 250);
+		rl78core_sched_schedule_r(machine, fast.event, 100);
+		utester_assert_true(rl78core_sched_pending_r(machine, fast.event));
+		utester_assert_equal(rl78core_sched_next_r(machine), 100);
+
+		// note: the due events are dispatched within the run, without stopping it.
+		utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 1010 }), rl78core_cpu_stop_budget);
+		utester_assert_equal(fast.expirations, 10);
+		utester_assert_equal(slow.expirations, 4);
+		utester_assert_false(fast.late);
+		utester_assert_false(slow.late);
+		utester_assert_equal(rl78core_sched_next_r(machine), 1100);
+
+		utester_assert_true(rl78core_sched_cancel_r(machine, fast.event));
+		utester_assert_false(rl78core_sched_cancel_r(machine, fast.event));
+		utester_assert_false(rl78core_sched_pending_r(machine, fast.event));
+		utester_assert_equal(rl78core_sched_next_r(machine), 1250);
+
+		// note: a moved event is dispatched at its new count of clock cycles only.
+		rl78core_sched_schedule_r(machine, slow.event, 2000);
+		utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 1000 }), rl78core_cpu_stop_budget);
+		utester_assert_equal(slow.expirations, 5);
+		utester_assert_equal(rl78core_sched_next_r(machine), 2250);
+
+		// note: a deadline without any due event still stops the run.
+		rl78core_cpu_set_deadline_r(machine, 2100);
+		utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_event);
+		utester_assert_true(rl78core_cpu_cycles_r(machine) >= 2100);
+
+		rl78core_machine_init(machine);
+		utester_assert_false(rl78core_sched_pending_r(machine, slow.event));
+		utester_assert_equal(rl78core_sched_next_r(machine), rl78core_cpu_no_deadline);
+		rl78core_machine_destroy(machine);
+	}
+}
+
+utester_define_test(rl78core_cpu_standby_test)
+{
+	const uint8_t program[] =
+	{
+		0x61, 0xED,  // 0x00000: HALT
+		0x51, 0x01,  // 0x00002: MOV A, #1
+		0x61, 0xFD,  // 0x00004: STOP
+	};
+
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	for (uint20_t address = 0; address < sizeof(program); ++address)
+	{
+		rl78core_mem_write_u08_r(machine, address, program[address]);
+	}
+
+	// note: without any deadline to wait for, the standby stops the run.
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	utester_assert_equal(rl78core_cpu_get_standby_r(machine), rl78core_cpu_standby_halt);
+	utester_assert_equal(rl78core_cpu_read_pc_r(machine), 0x00002);
+
+	periodic_timer_s timer = { .period = 32000, .wake_expiration = 3 };
+	timer.event = rl78core_sched_add_event_r(machine, periodic_timer_expire, &timer);
+	rl78core_sched_schedule_r(machine, timer.event, 32000);
+
+	// note: an hour of a 32 mhz clock is skipped, without running any instruction.
+	const uint64_t hour = 32000000ull * 3600;
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = hour }), rl78core_cpu_stop_budget);
+	utester_assert_true(rl78core_cpu_halted_r(machine));
+	utester_assert_equal(rl78core_cpu_get_standby_r(machine), rl78core_cpu_standby_stop);
+	utester_assert_equal(rl78core_cpu_read_pc_r(machine), 0x00006);
+	utester_assert_equal(rl78core_cpu_read_gpr08_r(machine, rl78core_gpr08_a), 1);
+	utester_assert_equal(timer.expirations, 3600 * 1000);
+	utester_assert_false(timer.late);
+
+	// note: the budget ending between the events leaves the cycles at its end.
+	const uint64_t cycles = rl78core_cpu_cycles_r(machine);
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 16000 }), rl78core_cpu_stop_budget);
+	utester_assert_equal(timer.expirations, 3600 * 1000);
+	utester_assert_equal(rl78core_cpu_cycles_r(machine), cycles + 16000);
+
+	utester_assert_true(rl78core_sched_cancel_r(machine, timer.event));
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+
+	utester_assert_true(rl78core_cpu_wake_r(machine));
+	utester_assert_false(rl78core_cpu_halted_r(machine));
+	utester_assert_false(rl78core_cpu_wake_r(machine));
+
+	// note: the halted cpu is not in a standby mode, and can not be woken up.
+	rl78core_cpu_halt_r(machine);
+	utester_assert_equal(rl78core_cpu_get_standby_r(machine), rl78core_cpu_standby_none);
+	utester_assert_false(rl78core_cpu_wake_r(machine));
+
+	// note: the stop mode freezes the counting interval timer, whose interrupt
+	// is unmasked, so it does not wake the cpu up. It counts on from its frozen
+	// count once the cpu is woken up.
+	rl78core_machine_init(machine);
+	rl78core_mem_write_u08_r(machine, 0x00000, 0x61);
+	rl78core_mem_write_u08_r(machine, 0x00001, 0xFD);
+	rl78core_mem_write_u08_r(machine, 0xFFFE6, 0xDF);
+	rl78core_mem_write_u16_r(machine, 0xF01B6, 0x0002);
+	rl78core_mem_write_u16_r(machine, 0xFFF1A, 99);
+	rl78core_mem_write_u08_r(machine, 0xF01B2, 0x02);
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	utester_assert_equal(rl78core_cpu_get_standby_r(machine), rl78core_cpu_standby_stop);
+	utester_assert_equal(rl78core_sched_next_r(machine), rl78core_cpu_no_deadline);
+	const uint64_t stop = rl78core_cpu_cycles_r(machine);
+	const uint16_t counter = rl78core_mem_read_u16_r(machine, 0xF0182);
+	utester_assert_equal(counter, 99 - (stop >> 2));
+
+	rl78core_cpu_set_deadline_r(machine, stop + 10000);
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = hour }), rl78core_cpu_stop_event);
+	utester_assert_true(rl78core_cpu_halted_r(machine));
+	utester_assert_false(rl78core_intc_requested_r(machine, 21));
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xF0182), counter);
+
+	utester_assert_true(rl78core_cpu_wake_r(machine));
+	const uint64_t wake = rl78core_cpu_cycles_r(machine);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xF0182), counter);
+	utester_assert_equal(rl78core_sched_next_r(machine), 400 + (wake - stop));
+	rl78core_machine_destroy(machine);
+}
+
+utester_define_test(rl78core_intc_test)
+{
+	const uint8_t vectors[] =
+	{
+		0xED, 0x00, 0x01,  // 0x00000: BR !0x0100
+		0x00, 0x00, 0x00,
+		0x00, 0x00,
+		0x40, 0x00,        // 0x00008: vector of the source 2
+	};
+
+	const uint8_t handler[] =
+	{
+		0x52, 0x5A,  // 0x00040: MOV C, #0x5A
+		0x61, 0xFC,  // 0x00042: RETI
+	};
+
+	const uint8_t program[] =
+	{
+		0xCB, 0xF8, 0x20, 0xFE,  // 0x00100: MOVW SP, #0xFE20
+		0xCF, 0xE4, 0xFF, 0xFB,  // 0x00104: MOV !0xFFE4, #0xFB
+		0x71, 0x7A, 0xFA,        // 0x00108: EI
+		0x61, 0xED,              // 0x0010B: HALT
+		0x51, 0x11,              // 0x0010D: MOV A, #0x11
+		0x71, 0x7B, 0xFA,        // 0x0010F: DI
+		0x61, 0xED,              // 0x00112: HALT
+		0x51, 0x22,              // 0x00114: MOV A, #0x22
+		0xCF, 0xE0, 0xFF, 0x00,  // 0x00116: MOV !0xFFE0, #0x00
+		0x61, 0xED,              // 0x0011A: HALT
+	};
+
+	const uint8_t enabling[] =
+	{
+		0xCF, 0xE0, 0xFF, 0x04,  // 0x00200: MOV !0xFFE0, #0x04
+		0x51, 0x33,              // 0x00204: MOV A, #0x33
+		0x71, 0x7A, 0xFA,        // 0x00206: EI
+		0x51, 0x44,              // 0x00209: MOV A, #0x44
+		0x61, 0xED,              // 0x0020B: HALT
+	};
+
+	for (uint8_t engine = 0; engine < rl78core_cpu_engines_count; ++engine)
+	{
+		rl78core_machine_s* const machine = rl78core_machine_create();
+		rl78core_cpu_set_engine_r(machine, (rl78core_cpu_engine_e)engine);
+		rl78core_mem_load_r(machine, 0x00000, vectors, sizeof(vectors));
+		rl78core_mem_load_r(machine, 0x00040, handler, sizeof(handler));
+		rl78core_mem_load_r(machine, 0x00100, program, sizeof(program));
+		rl78core_mem_load_r(machine, 0x00200, enabling, sizeof(enabling));
+
+		utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+		utester_assert_equal(rl78core_cpu_read_pc_r(machine), 0x0010D);
+		utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xFFFFA), 0x86);
+
+		// note: the request wakes the cpu up, and the interrupt is acknowledged.
+		rl78core_intc_request_r(machine, 2);
+		utester_assert_true(rl78core_intc_requested_r(machine, 2));
+		utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+		utester_assert_false(rl78core_intc_requested_r(machine, 2));
+		utester_assert_equal(rl78core_cpu_read_gpr08_r(machine, rl78core_gpr08_c), 0x5A);
+		utester_assert_equal(rl78core_cpu_read_gpr08_r(machine, rl78core_gpr08_a), 0x11);
+		utester_assert_equal(rl78core_cpu_read_pc_r(machine), 0x00114);
+		utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xFFFF8), 0xFE20);
+		utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xFFFFA), 0x06);
+
+		// note: the disabled interrupts wake the cpu up, but are not acknowledged,
+		// so the request is cleared by the program.
+		rl78core_intc_request_r(machine, 2);
+		utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+		utester_assert_false(rl78core_intc_requested_r(machine, 2));
+		utester_assert_equal(rl78core_cpu_read_gpr08_r(machine, rl78core_gpr08_a), 0x22);
+		utester_assert_equal(rl78core_cpu_read_pc_r(machine), 0x0011C);
+
+		// note: the masked interrupts do not wake the cpu up.
+		rl78core_intc_request_r(machine, 5);
+		utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+		utester_assert_equal(rl78core_cpu_read_pc_r(machine), 0x0011C);
+
+		// note: the request of the program stays pending while the interrupts are
+		// disabled, and is acknowledged once the program enables them.
+		rl78core_cpu_write_gpr08_r(machine, rl78core_gpr08_c, 0);
+		rl78core_cpu_write_pc_r(machine, 0x00200);
+		utester_assert_true(rl78core_cpu_wake_r(machine));
+		utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+		utester_assert_false(rl78core_intc_requested_r(machine, 2));
+		utester_assert_equal(rl78core_cpu_read_gpr08_r(machine, rl78core_gpr08_c), 0x5A);
+		utester_assert_equal(rl78core_cpu_read_gpr08_r(machine, rl78core_gpr08_a), 0x44);
+		utester_assert_equal(rl78core_cpu_read_pc_r(machine), 0x0020D);
+		utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xFFFFA), 0x86);
+		rl78core_machine_destroy(machine);
+	}
+
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	rl78core_mem_write_u08_r(machine, 0x00000, 0x71);
+	rl78core_mem_write_u08_r(machine, 0x00001, 0x7A);
+	rl78core_mem_write_u08_r(machine, 0x00002, 0xFA);
+	rl78core_mem_write_u08_r(machine, 0x00003, 0x61);
+	rl78core_mem_write_u08_r(machine, 0x00004, 0xED);
+	rl78core_intc_request_r(machine, 5);
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	utester_assert_equal(rl78core_cpu_read_pc_r(machine), 0x00005);
+	utester_assert_equal(rl78core_intc_select_r(machine, 3), rl78core_intc_no_source);
+
+	// note: the sources of the higher priority level are selected first, and then
+	// the ones of the higher default priority.
+	rl78core_mem_write_u08_r(machine, 0xFFFE4, 0xDB);
+	rl78core_mem_write_u08_r(machine, 0xFFFE8, 0xDF);
+	rl78core_mem_write_u08_r(machine, 0xFFFEC, 0xDF);
+	rl78core_intc_request_r(machine, 2);
+	utester_assert_equal(rl78core_intc_priority_r(machine, 5), 0);
+	utester_assert_equal(rl78core_intc_priority_r(machine, 2), 3);
+	utester_assert_equal(rl78core_intc_select_r(machine, 3), 5);
+	utester_assert_equal(rl78core_intc_select_r(machine, 0), 5);
+	rl78core_intc_acknowledge_r(machine, 5);
+	utester_assert_equal(rl78core_intc_select_r(machine, 3), 2);
+	utester_assert_equal(rl78core_intc_select_r(machine, 2), rl78core_intc_no_source);
+
+	// note: the sources of the high block are selected like the low ones.
+	rl78core_mem_write_u08_r(machine, 0xFFFD7, 0xEF);
+	rl78core_intc_request_r(machine, 60);
+	utester_assert_true(rl78core_intc_requested_r(machine, 60));
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xFFFD3), 0x10);
+	rl78core_intc_acknowledge_r(machine, 2);
+	utester_assert_equal(rl78core_intc_select_r(machine, 3), 60);
+	rl78core_machine_destroy(machine);
+
+	// note: the restored cpu does not keep the pending interrupt of the memory
+	// overwritten after the request.
+	rl78core_machine_s* const restored = rl78core_machine_create();
+	rl78core_mem_write_u08_r(restored, 0x00000, 0x61);
+	rl78core_mem_write_u08_r(restored, 0x00001, 0xED);
+	utester_assert_equal(rl78core_cpu_run_r(restored, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	rl78core_cpu_state_s state = {0};
+	rl78core_cpu_save_r(restored, &state);
+	rl78core_mem_write_u08_r(restored, 0xFFFFA, 0x86);
+	rl78core_mem_write_u08_r(restored, 0xFFFE4, 0xDF);
+	rl78core_intc_request_r(restored, 5);
+	rl78core_mem_write_u08_r(restored, 0xFFFE0, 0x00);
+	rl78core_cpu_restore_r(restored, &state);
+	utester_assert_equal(rl78core_cpu_run_r(restored, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	utester_assert_equal(rl78core_cpu_read_pc_r(restored), 0x00002);
+	utester_assert_equal(rl78core_mem_read_u08_r(restored, 0xFFFFA), 0x86);
+
+	// note: and it takes the pending interrupt of the memory, requested before.
+	rl78core_mem_write_u08_r(restored, 0x0000E, 0x40);
+	rl78core_mem_write_u08_r(restored, 0x00040, 0x61);
+	rl78core_mem_write_u08_r(restored, 0x00041, 0xED);
+	rl78core_mem_write_u16_r(restored, 0xFFFF8, 0xFE20);
+	rl78core_mem_write_u08_r(restored, 0xFFFE0, 0x20);
+	rl78core_cpu_restore_r(restored, &state);
+	utester_assert_equal(rl78core_cpu_run_r(restored, (rl78core_cpu_budget_s) {0}), rl78core_cpu_stop_halt);
+	utester_assert_equal(rl78core_cpu_read_pc_r(restored), 0x00042);
+	utester_assert_false(rl78core_intc_requested_r(restored, 5));
+	rl78core_machine_destroy(restored);
+}
+
+utester_define_test(rl78core_tau_test)
+{
+	const uint8_t vectors[] =
+	{
+		0xED, 0x00, 0x01,  // 0x00000: BR !0x0100
+	};
+
+	const uint8_t handler[] =
+	{
+		0x83,        // 0x00040: INC B
+		0x61, 0xFC,  // 0x00041: RETI
+	};
+
+	const uint8_t program[] =
+	{
+		0xCB, 0xF8, 0x20, 0xFE,  // 0x00100: MOVW SP, #0xFE20
+		0xCB, 0x18, 0xE7, 0x03,  // 0x00104: MOVW TDR00, #999
+		0xCF, 0xE6, 0xFF, 0xEF,  // 0x00108: MOV !0xFFE6, #0xEF
+		0x71, 0x7A, 0xFA,        // 0x0010C: EI
+		0xCF, 0xB2, 0x01, 0x01,  // 0x0010F: MOV !0x01B2, #0x01
+		0x61, 0xED,              // 0x00113: HALT
+		0xEF, 0xFC,              // 0x00115: BR $0x00113
+	};
+
+	// note: the interval timer interrupts the halted program every 1000 cycles.
+	for (uint8_t engine = 0; engine < rl78core_cpu_engines_count; ++engine)
+	{
+		rl78core_machine_s* const machine = rl78core_machine_create();
+		rl78core_cpu_set_engine_r(machine, (rl78core_cpu_engine_e)engine);
+		rl78core_mem_load_r(machine, 0x00000, vectors, sizeof(vectors));
+		rl78core_mem_write_u16_r(machine, 0x0002C, 0x0040);
+		rl78core_mem_load_r(machine, 0x00040, handler, sizeof(handler));
+		rl78core_mem_load_r(machine, 0x00100, program, sizeof(program));
+
+		utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 10500 }), rl78core_cpu_stop_budget);
+		utester_assert_equal(rl78core_cpu_read_gpr08_r(machine, rl78core_gpr08_b), 10);
+		utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF01B0), 0x01);
+		rl78core_machine_destroy(machine);
+	}
+
+	rl78core_machine_s* const machine = rl78core_machine_create();
+	rl78core_mem_write_u08_r(machine, 0x00000, 0xEF);
+	rl78core_mem_write_u08_r(machine, 0x00001, 0xFE);
+
+	// note: the counter of the interval timer is computed from the cycles, and
+	// reloaded at the end of every count.
+	rl78core_mem_write_u16_r(machine, 0xF01B6, 0x0002);
+	rl78core_mem_write_u16_r(machine, 0xFFF1A, 99);
+	rl78core_mem_write_u08_r(machine, 0xF01B2, 0x02);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF01B0), 0x02);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xF0182), 99);
+	utester_assert_equal(rl78core_sched_next_r(machine), 400);
+
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 40 }), rl78core_cpu_stop_budget);
+	uint64_t cycles = rl78core_cpu_cycles_r(machine);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xF0182), 99 - (cycles >> 2));
+	utester_assert_false(rl78core_intc_requested_r(machine, 21));
+
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 400 }), rl78core_cpu_stop_budget);
+	cycles = rl78core_cpu_cycles_r(machine);
+	utester_assert_true(rl78core_intc_requested_r(machine, 21));
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xF0182), 99 - ((cycles - 400) >> 2));
+	utester_assert_equal(rl78core_sched_next_r(machine), 800);
+
+	// note: the stopped counter holds its value.
+	rl78core_mem_write_u08_r(machine, 0xF01B4, 0x02);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF01B0), 0x00);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xF0182), 99 - ((cycles - 400) >> 2));
+	utester_assert_equal(rl78core_sched_next_r(machine), rl78core_cpu_no_deadline);
+
+	// note: the capture mode latches the counter into the data register, and
+	// flags the overflows of the counter.
+	rl78core_mem_write_u16_r(machine, 0xF0194, 0x0004);
+	rl78core_mem_write_u08_r(machine, 0xF01B2, 0x04);
+	const uint64_t start = rl78core_cpu_cycles_r(machine);
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 100 }), rl78core_cpu_stop_budget);
+	rl78core_tau_input_r(machine, 0, 2);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xFFF64), (rl78core_cpu_cycles_r(machine) - start) >> 2);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF01A4), 0x00);
+	utester_assert_true(rl78core_intc_requested_r(machine, 22));
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 0x40000 }), rl78core_cpu_stop_budget);
+	rl78core_tau_input_r(machine, 0, 2);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF01A4), 0x01);
+
+	// note: the event counter counts the edges of its input.
+	rl78core_mem_write_u16_r(machine, 0xF0196, 0x0006);
+	rl78core_mem_write_u16_r(machine, 0xFFF66, 2);
+	rl78core_mem_write_u08_r(machine, 0xF01B2, 0x08);
+	rl78core_tau_input_r(machine, 0, 3);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xF0186), 1);
+	utester_assert_false(rl78core_intc_requested_r(machine, 23));
+	rl78core_tau_input_r(machine, 0, 3);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xF0186), 2);
+	utester_assert_true(rl78core_intc_requested_r(machine, 23));
+
+	// note: the master of the pwm function sets the output of its slave at the
+	// start of every period, and the slave resets it at the end of the duty.
+	rl78core_machine_init(machine);
+	rl78core_mem_write_u08_r(machine, 0x00000, 0xEF);
+	rl78core_mem_write_u08_r(machine, 0x00001, 0xFE);
+	rl78core_mem_write_u16_r(machine, 0xF01D0, 0x0001);
+	rl78core_mem_write_u16_r(machine, 0xF01D2, 0x0409);
+	rl78core_mem_write_u16_r(machine, 0xFFF70, 99);
+	rl78core_mem_write_u16_r(machine, 0xFFF72, 49);
+	rl78core_mem_write_u16_r(machine, 0xF01FA, 0x0002);
+	rl78core_mem_write_u16_r(machine, 0xF01FE, 0x0002);
+	rl78core_mem_write_u08_r(machine, 0xF01F2, 0x03);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF01F8), 0x02);
+	utester_assert_true(rl78core_intc_requested_r(machine, 41));
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 60 }), rl78core_cpu_stop_budget);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF01F8), 0x00);
+	utester_assert_true(rl78core_intc_requested_r(machine, 42));
+	utester_assert_equal(rl78core_cpu_run_r(machine, (rl78core_cpu_budget_s) { .cycles = 50 }), rl78core_cpu_stop_budget);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF01F8), 0x02);
+	utester_assert_equal(rl78core_sched_next_r(machine), 150);
+
+	// note: the initialization stops all the channels.
+	rl78core_machine_init(machine);
+	utester_assert_equal(rl78core_mem_read_u08_r(machine, 0xF01F0), 0x00);
+	utester_assert_equal(rl78core_mem_read_u16_r(machine, 0xF0180), 0xFFFF);
+	utester_assert_equal(rl78core_sched_next_r(machine), rl78core_cpu_no_deadline);
+	rl78core_machine_destroy(machine);
+}
+
+utester_define_test(rl78core_cpu_engines_test)
+{
+	const uint8_t program[] =
+	{
+		0xCB, 0xF8, 0x00, 0xFE,  // MOVW SP, #0xFE00
+		0x53, 0x00,              // MOV B, #0
+		0x52, 0x40,              // MOV C, #0x40
+		0x63,                    // MOV A, B
+		0x0C, 0x07,              // ADD A, #7
+		0x73,                    // MOV B, A
+		0x9D, 0x20,              // MOV saddr, A
+		0xFD, 0x20, 0x00,        // CALL !0x0020
+		0x92,                    // DEC C
+		0xDF, 0xF4,              // BNZ $-12
+		0x61, 0xED,              // HALT
+		0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00,
+		0x6C, 0x80,              // 0x00020: OR A, #0x80
+		0x77,                    // MOV H, A
+		0xD7,                    // RET
+	};
+
+	uint8_t registers[rl78core_cpu_engines_count][rl78core_gpr08s_count] = {0};
+	uint20_t pcs[rl78core_cpu_engines_count] = {0};
+	uint64_t ticks[rl78core_cpu_engines_count] = {0};
+	uint64_t cycles[rl78core_cpu_engines_count] = {0};
+
+	for (uint8_t engine = 0; engine < rl78core_cpu_engines_count; ++engine)
+	{
+		rl78core_mem_init();
+		rl78core_cpu_init();
+		rl78core_cpu_set_engine((rl78core_cpu_engine_e)engine);
+		utester_assert_equal(rl78core_cpu_get_engine(), engine);
+		flash_program(program, sizeof(program));
+
+		ticks[engine] += rl78core_cpu_execute(37);
+		utester_assert_equal(ticks[engine], 37);
+		ticks[engine] += rl78core_cpu_execute(10000);
+		utester_assert_true(rl78core_cpu_halted());
+		pcs[engine] = rl78core_cpu_read_pc();
+		cycles[engine] = rl78core_cpu_cycles();
+
+		for (uint8_t gpr08 = 0; gpr08 < rl78core_gpr08s_count; ++gpr08)
+		{
+			registers[engine][gpr08] = rl78core_cpu_read_gpr08(gpr08);
+		}
+	}
+
+	utester_assert_equal(pcs[rl78core_cpu_engine_interp], 0x00016);
+	utester_assert_equal(registers[rl78core_cpu_engine_interp][rl78core_gpr08_h], 0xC0);
+	utester_assert_equal(ticks[rl78core_cpu_engine_interp], 3 + (0x40 * 10) + 1);
+	utester_assert_equal(cycles[rl78core_cpu_engine_interp], 3 + (0x40 * 18) + (0x3F * 2) + 3);
+
+	for (uint8_t engine = 1; engine < rl78core_cpu_engines_count; ++engine)
+	{
+		utester_assert_equal(pcs[engine], pcs[rl78core_cpu_engine_interp]);
+		utester_assert_equal(ticks[engine], ticks[rl78core_cpu_engine_interp]);
+		utester_assert_equal(cycles[engine], cycles[rl78core_cpu_engine_interp]);
+		utester_assert_equal(rl78misc_memcmp(registers[engine], registers[rl78core_cpu_engine_interp], rl78core_gpr08s_count), 0);
+	}
+}
+
 utester_run_suite(
 	rl78core_suite,
 		&rl78core_mem_read_u08_test,
 		&rl78core_mem_write_u08_test,
 		&rl78core_mem_read_u16_test,
 		&rl78core_mem_write_u16_test,
+		&rl78core_mem_map_io_test,
+		&rl78core_mem_footprint_test,
+		&rl78core_mem_dirty_test,
+		&rl78core_mem_image_test,
+		&rl78core_loader_ihex_test,
+		&rl78core_loader_srec_test,
+		&rl78core_loader_errors_test,
+		&rl78core_symbols_test,
+		&rl78core_loader_elf_test,
+		&rl78core_cache_test,
+		&rl78core_loader_file_test,
 		&rl78core_cpu_read_pc_test,
 		&rl78core_cpu_write_pc_test,
 		&rl78core_cpu_read_gpr08_test,
 		&rl78core_cpu_write_gpr08_test,
 		&rl78core_cpu_read_gpr16_test,
 		&rl78core_cpu_write_gpr16_test,
+		&rl78core_cpu_tick_test,
+		&rl78core_cpu_es_prefix_test,
+		&rl78core_cpu_cycles_test,
+		&rl78core_cpu_run_test,
+		&rl78core_cpu_execute_test,
+		&rl78core_cpu_gpr_bank_test,
+		&rl78core_cpu_flags_test,
+		&rl78core_cpu_decode_cache_test,
+		&rl78core_cpu_jit_test,
+		&rl78core_machine_test,
+		&rl78core_snapshot_test,
+		&rl78core_snapshot_file_test,
+		&rl78core_snapshot_tau_test,
+		&rl78core_sched_test,
+		&rl78core_cpu_standby_test,
+		&rl78core_intc_test,
+		&rl78core_tau_test,
+		&rl78core_cpu_engines_test,
 );
@@ -13,9 +13,40 @@
 #include "rl78misc/common.h"
 #include "rl78misc/debug.h"
 #include "rl78misc/logger.h"
+#include "rl78misc/file.h"
 
 #include "./utester.h"
 
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#define logger_test_threads 4
+#define logger_test_lines 200
+
+/**
+ * @brief Log the lines of a producer thread of the logger test.
+ * 
+ * @param argument pointer to the index of the thread
+ * 
+ * @return void* unused
+ */
+static void* log_lines(
+	void* argument);
+
+static void* log_lines(
+	void* argument)
+{
+	const uint32_t thread = *(const uint32_t*)argument;
+
+	for (uint32_t line = 0; line < logger_test_lines; ++line)
+	{
+		rl78misc_logger_log("%u %u", thread, line);
+	}
+
+	return NULL;
+}
+
 /**
  * @brief Construct a new utester define test for rl78misc_malloc.
  */
@@ -179,6 +210,172 @@ utester_define_test(rl78misc_strncmp_test)
 	}
 }
 
+/**
+ * @brief Construct a new utester define test for rl78misc_file_map.
+ */
+utester_define_test(rl78misc_file_map_test)
+{
+	const char_t* const path = "rl78misc_file_map_test.txt";
+	FILE* const file = fopen(path, "wb");
+	utester_assert_true(file != NULL);
+	(void)fputs("rl78emu", file);
+	(void)fclose(file);
+
+	uint64_t length = 0;
+	const uint8_t* const contents = rl78misc_file_map(path, &length);
+	utester_assert_true(contents != NULL);
+	utester_assert_equal(length, 7);
+	utester_assert_equal(rl78misc_memcmp(contents, (const uint8_t*)"rl78emu", 7), 0);
+	rl78misc_file_unmap(contents, length);
+
+	(void)remove(path);
+	utester_assert_true(NULL == rl78misc_file_map(path, &length));
+}
+
+/**
+ * @brief Construct a new utester define test for rl78misc_logger_start.
+ */
+utester_define_test(rl78misc_logger_start_test)
+{
+	const char_t* const path = "rl78misc_logger_start_test.txt";
+	FILE* const file = fopen(path, "wb");
+	utester_assert_true(file != NULL);
+
+	// note: the stdout is redirected into the file, while the backend is started.
+	(void)fflush(stdout);
+	const int32_t saved = dup(STDOUT_FILENO);
+	utester_assert_true(dup2(fileno(file), STDOUT_FILENO) >= 0);
+
+	const uint64_t dropped = rl78misc_logger_dropped();
+	rl78misc_logger_start();
+	pthread_t threads[logger_test_threads];
+	uint32_t indices[logger_test_threads];
+
+	for (uint32_t index = 0; index < logger_test_threads; ++index)
+	{
+		indices[index] = index;
+		utester_assert_equal(pthread_create(&threads[index], NULL, log_lines, &indices[index]), 0);
+	}
+
+	for (uint32_t index = 0; index < logger_test_threads; ++index)
+	{
+		(void)pthread_join(threads[index], NULL);
+	}
+
+	rl78misc_logger_stop();
+	(void)fflush(stdout);
+	(void)dup2(saved, STDOUT_FILENO);
+	(void)close(saved);
+	(void)fclose(file);
+
+	// note: the queue holds all the lines, so none are dropped, and the lines
+	// of every thread are written in order.
+	utester_assert_equal(rl78misc_logger_dropped(), dropped);
+	FILE* const written = fopen(path, "rb");
+	utester_assert_true(written != NULL);
+	uint32_t next[logger_test_threads] = {0};
+	uint32_t thread = 0;
+	uint32_t line = 0;
+	uint32_t count = 0;
+	char_t text[64];
+
+	// note: the lines of the asserts made while redirected are skipped.
+	while (fgets(text, sizeof(text), written) != NULL)
+	{
+		if (sscanf(text, "%u %u", &thread, &line) != 2)
+		{
+			continue;
+		}
+
+		utester_assert_true(thread < logger_test_threads);
+		utester_assert_equal(line, next[thread]);
+		next[thread] = line + 1;
+		++count;
+	}
+
+	(void)fclose(written);
+	(void)remove(path);
+	utester_assert_equal(count, logger_test_threads * logger_test_lines);
+}
+
+/**
+ * @brief Construct a new utester define test for the lossless levels of the
+ * rl78misc_logger_start backend.
+ */
+utester_define_test(rl78misc_logger_lossless_test)
+{
+	const char_t* const path = "rl78misc_logger_lossless_test.txt";
+	FILE* const file = fopen(path, "wb");
+	utester_assert_true(file != NULL);
+
+	(void)fflush(stdout);
+	const int32_t saved = dup(STDOUT_FILENO);
+	utester_assert_true(dup2(fileno(file), STDOUT_FILENO) >= 0);
+
+	// note: the lines overflow the queue many times over, and only the info
+	// lines between them may be dropped.
+	const uint32_t lines = 4 * rl78misc_logger_records_capacity;
+	rl78misc_logger_start();
+
+	for (uint32_t line = 0; line < lines; ++line)
+	{
+		rl78misc_logger_info("dropped %u", line);
+		rl78misc_logger_log("kept %u", line);
+	}
+
+	rl78misc_logger_stop();
+	(void)fflush(stdout);
+	(void)dup2(saved, STDOUT_FILENO);
+	(void)close(saved);
+	(void)fclose(file);
+
+	FILE* const written = fopen(path, "rb");
+	utester_assert_true(written != NULL);
+	uint32_t next = 0;
+	uint32_t line = 0;
+	char_t text[64];
+
+	while (fgets(text, sizeof(text), written) != NULL)
+	{
+		if (sscanf(text, "kept %u", &line) != 1)
+		{
+			continue;
+		}
+
+		utester_assert_equal(line, next);
+		++next;
+	}
+
+	(void)fclose(written);
+	(void)remove(path);
+	utester_assert_equal(next, lines);
+}
+
+/**
+ * @brief Construct a new utester define test for rl78misc_logger_set_level.
+ */
+utester_define_test(rl78misc_logger_set_level_test)
+{
+	uint32_t evaluated = 0;
+	rl78misc_logger_set_level(rl78misc_logger_level_error);
+	utester_assert_false(rl78misc_logger_enabled(rl78misc_logger_level_trace));
+	utester_assert_false(rl78misc_logger_enabled(rl78misc_logger_level_warn));
+	utester_assert_true(rl78misc_logger_enabled(rl78misc_logger_level_error));
+	utester_assert_true(rl78misc_logger_enabled(rl78misc_logger_level_log));
+
+	// note: the arguments of the disabled logs must not be evaluated.
+	rl78misc_logger_trace("%u", ++evaluated);
+	rl78misc_logger_info("%u", ++evaluated);
+	rl78misc_logger_warn("%u", ++evaluated);
+	utester_assert_equal(evaluated, 0);
+
+	rl78misc_logger_set_level(rl78misc_logger_level_trace);
+	utester_assert_true(rl78misc_logger_enabled(rl78misc_logger_level_trace));
+	rl78misc_logger_trace("evaluated %u", ++evaluated);
+	utester_assert_equal(evaluated, 1);
+	rl78misc_logger_set_level(rl78misc_logger_level_info);
+}
+
 utester_run_suite(
 	rl78misc_suite,
 		&rl78misc_malloc_test,
@@ -190,4 +387,8 @@ utester_run_suite(
 		&rl78misc_strlen_test,
 		&rl78misc_strcmp_test,
 		&rl78misc_strncmp_test,
+		&rl78misc_file_map_test,
+		&rl78misc_logger_start_test,
+		&rl78misc_logger_lossless_test,
+		&rl78misc_logger_set_level_test,
 );